@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Split "a,b,c" into tokens
+inline std::vector<std::string> split(const std::string& text, char sep = ',')
+{
+    std::vector<std::string> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, sep)) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+// Parse "640x480"; returns false on malformed input
+inline bool parse_size(const std::string& text, int& w, int& h)
+{
+    return std::sscanf(text.c_str(), "%dx%d", &w, &h) == 2 && w > 0 && h > 0;
+}
+
+inline std::string json_escape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+/**
+ * JsonObject - Flat builder for one JSON object (no nesting beyond raw values)
+ */
+class JsonObject {
+public:
+    JsonObject& add(const std::string& key, const std::string& value) {
+        return raw(key, "\"" + json_escape(value) + "\"");
+    }
+    JsonObject& add(const std::string& key, const char* value) { return add(key, std::string(value)); }
+    JsonObject& add(const std::string& key, double value) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.6g", value);
+        return raw(key, buf);
+    }
+    JsonObject& add(const std::string& key, long long value) { return raw(key, std::to_string(value)); }
+    JsonObject& add(const std::string& key, int value) { return raw(key, std::to_string(value)); }
+    JsonObject& add(const std::string& key, bool value) { return raw(key, value ? "true" : "false"); }
+
+    // Pre-serialized JSON value (array/object)
+    JsonObject& raw(const std::string& key, const std::string& json) {
+        if (!body_.empty()) body_ += ", ";
+        body_ += "\"" + json_escape(key) + "\": " + json;
+        return *this;
+    }
+
+    std::string str() const { return "{" + body_ + "}"; }
+
+private:
+    std::string body_;
+};
+
+inline std::string json_array(const std::vector<std::string>& items, const char* indent = "\n    ")
+{
+    std::string out = "[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        out += indent;
+        out += items[i];
+        if (i + 1 < items.size()) out += ",";
+    }
+    out += items.empty() ? "]" : "\n  ]";
+    return out;
+}
+
+// Write text to a path, or stdout for "-"
+inline bool write_text(const std::string& path, const std::string& text)
+{
+    if (path == "-") {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        return true;
+    }
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    std::fclose(f);
+    return ok;
+}
+
+} // namespace bench
@@ -0,0 +1,351 @@
+"""
+Headless end-to-end frame benchmark
+
+Runs the example scenes without a display (SDL dummy video driver), feeds
+them scripted input, forces a fixed timestep, and records per-frame times,
+surface allocations and profiler stage breakdowns. Results can be saved as
+a baseline and later runs compared against it.
+
+Usage:
+    python bench/frame_bench.py                          # all scenes, 300 frames
+    python bench/frame_bench.py --scenes buttons,textfield --frames 600
+    python bench/frame_bench.py --write-baseline bench/baseline.json
+    python bench/frame_bench.py --baseline bench/baseline.json --threshold 0.15
+"""
+
+import argparse
+import contextlib
+import importlib.util
+import io
+import json
+import math
+import os
+import statistics
+import sys
+import time
+
+os.environ.setdefault("SDL_VIDEODRIVER", "dummy")
+os.environ.setdefault("SDL_AUDIODRIVER", "dummy")
+
+import Palladium as ui
+
+EXAMPLES_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "examples")
+
+DEFAULT_SCENES = ["buttons", "materials", "slider_demo", "textfield", "unified_demo"]
+
+
+class SceneFinished(Exception):
+    """Raised from present() once the frame budget is spent, for loops that never exit"""
+
+
+# ============ Scripted input ============
+
+def make_event(event_type, **fields):
+    e = ui.Event()
+    e.type = event_type
+    for name, value in fields.items():
+        setattr(e, name, value)
+    return e
+
+
+def pointer_script(frame, width, height):
+    """Lissajous sweep over the window with a click every 45 frames"""
+    t = frame * 0.035
+    x = int(width * (0.5 + 0.45 * math.sin(t * 1.3)))
+    y = int(height * (0.5 + 0.45 * math.sin(t * 0.9 + 0.7)))
+    events = [make_event(ui.EventType.MouseMotion, mouse_x=x, mouse_y=y)]
+    if frame % 45 == 10:
+        events.append(make_event(ui.EventType.MouseButtonDown, mouse_x=x, mouse_y=y, mouse_button=1))
+    elif frame % 45 == 12:
+        events.append(make_event(ui.EventType.MouseButtonUp, mouse_x=x, mouse_y=y, mouse_button=1))
+    return events
+
+
+def drag_script(frame, width, height):
+    """Press, drag in a circle, release; repeats every 120 frames"""
+    phase = frame % 120
+    angle = phase / 120.0 * 2.0 * math.pi
+    x = int(width * 0.5 + width * 0.25 * math.cos(angle))
+    y = int(height * 0.5 + height * 0.25 * math.sin(angle))
+    events = [make_event(ui.EventType.MouseMotion, mouse_x=x, mouse_y=y)]
+    if phase == 0:
+        events.insert(0, make_event(ui.EventType.MouseButtonDown, mouse_x=x, mouse_y=y, mouse_button=1))
+    elif phase == 110:
+        events.append(make_event(ui.EventType.MouseButtonUp, mouse_x=x, mouse_y=y, mouse_button=1))
+    return events
+
+
+TYPED_TEXT = "The quick brown fox jumps over the lazy dog. "
+KEY_BACKSPACE = 8
+KEY_LEFT = 1073741904
+KEY_RIGHT = 1073741903
+
+
+def typing_script(frame, width, height):
+    """Focus the first field, then type, move the cursor and delete"""
+    if frame == 2:
+        return [make_event(ui.EventType.MouseMotion, mouse_x=200, mouse_y=70),
+                make_event(ui.EventType.MouseButtonDown, mouse_x=200, mouse_y=70, mouse_button=1),
+                make_event(ui.EventType.MouseButtonUp, mouse_x=200, mouse_y=70, mouse_button=1)]
+    if frame < 4:
+        return []
+    step = frame - 4
+    cycle = step % 80
+    if cycle < 60:
+        ch = TYPED_TEXT[step % len(TYPED_TEXT)]
+        return [make_event(ui.EventType.TextInput, text=ch)]
+    if cycle < 65:
+        return [make_event(ui.EventType.KeyDown, key=KEY_LEFT), make_event(ui.EventType.KeyUp, key=KEY_LEFT)]
+    if cycle < 70:
+        return [make_event(ui.EventType.KeyDown, key=KEY_RIGHT), make_event(ui.EventType.KeyUp, key=KEY_RIGHT)]
+    return [make_event(ui.EventType.KeyDown, key=KEY_BACKSPACE), make_event(ui.EventType.KeyUp, key=KEY_BACKSPACE)]
+
+
+SCRIPTS = {
+    "buttons": pointer_script,
+    "materials": drag_script,
+    "slider_demo": drag_script,
+    "textfield": typing_script,
+    "unified_demo": pointer_script,
+}
+
+
+# ============ Instrumented windows ============
+
+class Recorder:
+    """Collects per-frame measurements for one scene"""
+
+    def __init__(self, frames, dt, script):
+        self.frames = frames
+        self.dt = dt
+        self.script = script
+        self.frame_ms = []
+        self.allocations = []
+        self.pool_misses = []
+        self.last_time = None
+        self.last_allocs = 0
+        self.last_misses = 0
+
+    def start(self):
+        self.last_time = time.perf_counter()
+        self.last_allocs = ui.memory.stats()["allocations"]
+        self.last_misses = ui.memory.pool_stats()["misses"]
+
+    def on_present(self):
+        now = time.perf_counter()
+        self.frame_ms.append((now - self.last_time) * 1000.0)
+        self.last_time = now
+
+        allocs = ui.memory.stats()["allocations"]
+        misses = ui.memory.pool_stats()["misses"]
+        self.allocations.append(allocs - self.last_allocs)
+        self.pool_misses.append(misses - self.last_misses)
+        self.last_allocs = allocs
+        self.last_misses = misses
+
+    @property
+    def done(self):
+        return len(self.frame_ms) >= self.frames
+
+
+def instrument(base, recorder):
+    """Subclass a window type so the scene runs scripted and stops after N frames"""
+
+    native_injection = hasattr(base, "push_event")
+
+    class BenchWindow(base):
+        def __init__(self, *args, **kwargs):
+            super().__init__(*args, **kwargs)
+            self._frame = 0
+            self._pending = []
+            if native_injection:
+                self.fixed_timestep = recorder.dt
+            self._queue_frame_input()
+            recorder.start()
+
+        def _queue_frame_input(self):
+            events = recorder.script(self._frame, self.width, self.height) if recorder.script else []
+            if native_injection:
+                for e in events:
+                    self.push_event(e)
+            else:
+                self._pending.extend(events)
+
+        def poll_event(self):
+            if self._pending:
+                return self._pending.pop(0)
+            return super().poll_event()
+
+        @property
+        def delta_time(self):
+            return recorder.dt
+
+        def present(self, *args):
+            if recorder.done:
+                raise SceneFinished()
+            super().present(*args)
+            recorder.on_present()
+            self._frame += 1
+            if recorder.done:
+                # Loops that watch events or is_open exit on their own
+                quit_event = make_event(ui.EventType.Quit)
+                if native_injection:
+                    self.push_event(quit_event)
+                else:
+                    self._pending.append(quit_event)
+                    self.close()
+            else:
+                self._queue_frame_input()
+
+    BenchWindow.__name__ = base.__name__
+    return BenchWindow
+
+
+@contextlib.contextmanager
+def patched_windows(recorder):
+    saved = {}
+    for name in ("Window", "GPUWindow"):
+        if hasattr(ui, name):
+            saved[name] = getattr(ui, name)
+            setattr(ui, name, instrument(saved[name], recorder))
+
+    original_create = getattr(ui, "create_window", None)
+    if original_create is not None:
+        def create_window(title, width, height, vsync=True):
+            gpu = hasattr(ui, "get_device") and ui.get_device() == "gpu" and "GPUWindow" in saved
+            return (ui.GPUWindow if gpu else ui.Window)(title, width, height, vsync)
+        ui.create_window = create_window
+    try:
+        yield
+    finally:
+        for name, cls in saved.items():
+            setattr(ui, name, cls)
+        if original_create is not None:
+            ui.create_window = original_create
+
+
+# ============ Running and reporting ============
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    rank = max(1, math.ceil(p * len(sorted_values)))
+    return sorted_values[min(rank, len(sorted_values)) - 1]
+
+
+def run_scene(name, frames, dt, warmup):
+    path = os.path.join(EXAMPLES_DIR, name + ".py")
+    if not os.path.exists(path):
+        return {"error": "example not found: " + path}
+
+    spec = importlib.util.spec_from_file_location("bench_scene_" + name, path)
+    module = importlib.util.module_from_spec(spec)
+
+    recorder = Recorder(frames + warmup, dt, SCRIPTS.get(name, pointer_script))
+    ui.profiler.history_frames = frames
+    ui.profiler.reset()
+    ui.profiler.enable()
+
+    output = io.StringIO()
+    error = None
+    try:
+        with patched_windows(recorder), contextlib.redirect_stdout(output):
+            spec.loader.exec_module(module)
+            module.main()
+    except SceneFinished:
+        pass
+    except Exception as exc:  # Scene not runnable here (e.g. GPU-only APIs)
+        error = "%s: %s" % (type(exc).__name__, exc)
+    finally:
+        ui.profiler.disable()
+
+    measured = recorder.frame_ms[warmup:]
+    if not measured:
+        return {"error": error or "scene presented no frames"}
+
+    stages = ui.profiler.stats(len(measured))["stages"]
+    ordered = sorted(measured)
+    allocs = recorder.allocations[warmup:]
+    misses = recorder.pool_misses[warmup:]
+    result = {
+        "frames": len(measured),
+        "mean_ms": statistics.fmean(measured),
+        "p50_ms": percentile(ordered, 0.50),
+        "p95_ms": percentile(ordered, 0.95),
+        "p99_ms": percentile(ordered, 0.99),
+        "max_ms": ordered[-1],
+        "allocations_per_frame": statistics.fmean(allocs),
+        "pool_misses_per_frame": statistics.fmean(misses),
+        "stages": {k: {"total_ms": v["total_ms"], "calls": v["calls"]} for k, v in stages.items()},
+    }
+    if error:
+        result["error"] = error
+    return result
+
+
+def compare(results, baseline, threshold):
+    """Return human-readable regression lines (empty when none)"""
+    regressions = []
+    for name, r in results.items():
+        base = baseline.get("scenes", {}).get(name)
+        if not base or "error" in r or "error" in base:
+            continue
+        for key in ("p50_ms", "p95_ms"):
+            if r[key] > base[key] * (1.0 + threshold):
+                regressions.append("%s %s: %.2f ms -> %.2f ms (+%.0f%%)" % (
+                    name, key, base[key], r[key], (r[key] / base[key] - 1.0) * 100.0))
+        allocs, base_allocs = r["allocations_per_frame"], base["allocations_per_frame"]
+        if allocs > base_allocs * (1.0 + threshold) and allocs - base_allocs >= 1.0:
+            regressions.append("%s allocations/frame: %.1f -> %.1f" % (name, base_allocs, allocs))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Headless frame benchmark over the example scenes")
+    parser.add_argument("--scenes", default=",".join(DEFAULT_SCENES))
+    parser.add_argument("--frames", type=int, default=300)
+    parser.add_argument("--warmup", type=int, default=30)
+    parser.add_argument("--dt", type=float, default=1.0 / 60.0)
+    parser.add_argument("--json", help="Write results to this path")
+    parser.add_argument("--baseline", help="Compare against a stored baseline")
+    parser.add_argument("--write-baseline", help="Store these results as a baseline")
+    parser.add_argument("--threshold", type=float, default=0.10, help="Allowed slowdown (0.10 = 10%%)")
+    args = parser.parse_args()
+
+    results = {}
+    for name in [s for s in args.scenes.split(",") if s]:
+        r = run_scene(name, args.frames, args.dt, args.warmup)
+        results[name] = r
+        if "frames" in r:
+            print("%-14s %4d frames  mean %7.2f  p50 %7.2f  p95 %7.2f  p99 %7.2f ms  allocs/frame %6.1f%s" % (
+                name, r["frames"], r["mean_ms"], r["p50_ms"], r["p95_ms"], r["p99_ms"],
+                r["allocations_per_frame"], "  (" + r["error"] + ")" if "error" in r else ""))
+            top = sorted(r["stages"].items(), key=lambda kv: -kv[1]["total_ms"])[:4]
+            if top:
+                print("%14s %s" % ("", "  ".join("%s %.2f" % (k, v["total_ms"]) for k, v in top)))
+        else:
+            print("%-14s skipped: %s" % (name, r["error"]))
+
+    report = {"suite": "palladium_frame_bench", "version": 1, "frames": args.frames,
+              "dt": args.dt, "scenes": results}
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+    if args.write_baseline:
+        with open(args.write_baseline, "w") as f:
+            json.dump(report, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(results, baseline, args.threshold)
+        for line in regressions:
+            print("REGRESSION " + line)
+        if regressions:
+            return 1
+        print("No regressions against " + args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
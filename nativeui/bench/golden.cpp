@@ -0,0 +1,646 @@
+/**
+ * palladium_golden - Golden-image pixel regression with per-scene timing
+ *
+ * Renders canonical scenes covering the Surface primitives, Effects, layer
+ * blend modes, materials and (when built with widgets) Button states, then
+ * compares each against a reference image with a per-scene tolerance: the
+ * largest channel difference and a minimum PSNR. Render time is measured for
+ * every scene and reported next to its result, so a fast path can be shown
+ * to be both faster and visually equivalent.
+ *
+ * References are RGBA PAM files (one per scene) in bench/golden.
+ *
+ * Usage: palladium_golden [--filter substr] [--refs dir] [--update] [--out dir]
+ *                         [--min-time 0.05] [--json out.json] [--list]
+ */
+
+#include "bench_common.hpp"
+#include "surface.hpp"
+#include "effects.hpp"
+#include "batch.hpp"
+#include "display_list.hpp"
+#include "particles.hpp"
+#include "atlas.hpp"
+#include "layer.hpp"
+#include "material.hpp"
+#ifdef PALLADIUM_GOLDEN_WIDGETS
+#include "button.hpp"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+
+#ifndef PALLADIUM_GOLDEN_DIR
+#define PALLADIUM_GOLDEN_DIR "golden"
+#endif
+
+using namespace nativeui;
+
+namespace {
+
+const int kSize = 64;
+
+/**
+ * One scene; tolerances are per channel (0-255) and in dB
+ */
+struct Scene {
+    std::string category;
+    std::string name;
+    int max_error;
+    double min_psnr;
+    std::function<void(Surface&)> render;
+
+    std::string id() const { return category + "/" + name; }
+    std::string file() const { return category + "_" + name + ".pam"; }
+};
+
+struct Result {
+    std::string id;
+    std::string status;  // pass, fail, missing, updated
+    int max_error;
+    double psnr;
+    double ms;
+    int tolerance_max_error;
+    double tolerance_psnr;
+};
+
+// PSNR reported for identical images
+const double kIdenticalPsnr = 100.0;
+
+// Exact for integer-only code paths; AA, blur and float math get a little slack
+const int kExact = 0;
+const int kFloat = 2;
+const double kFloatPsnr = 45.0;
+
+// Seeded noise: std distributions differ between standard libraries, so
+// results are only roughly comparable across platforms
+const int kNoise = 64;
+const double kNoisePsnr = 20.0;
+
+// ---------------------------------------------------------------------------
+// Shared content
+// ---------------------------------------------------------------------------
+
+void backdrop(Surface& s)
+{
+    int w = s.get_width(), h = s.get_height();
+    Effects::linear_gradient(s, 0, 0, w, h, Color(24, 48, 96), Color(200, 110, 40));
+    for (int i = 0; i < 4; ++i) {
+        s.fill_rect(i * w / 4 + 2, (i % 2) * h / 2 + 4, w / 6, h / 3,
+                    Color(static_cast<uint8_t>(60 * i), 220, static_cast<uint8_t>(240 - 50 * i), 255));
+    }
+}
+
+std::shared_ptr<Surface> sprite(int w, int h)
+{
+    auto s = std::make_shared<Surface>(w, h);
+    s->clear();
+    s->fill_circle_aa(w / 2, h / 2, std::min(w, h) / 2 - 2, Color(250, 200, 60, 200));
+    s->fill_rect(2, 2, w / 3, h / 3, Color(40, 200, 120, 255));
+    return s;
+}
+
+Scene scene(const std::string& category, const std::string& name, int max_error, double min_psnr,
+            std::function<void(Surface&)> render)
+{
+    return {category, name, max_error, min_psnr, std::move(render)};
+}
+
+Scene effect(const std::string& name, int max_error, double min_psnr, std::function<void(Surface&)> fn)
+{
+    return scene("effects", name, max_error, min_psnr, [fn](Surface& s) {
+        backdrop(s);
+        fn(s);
+    });
+}
+
+// Two layers composited with a blend mode
+Scene blend_scene(const std::string& name, BlendMode mode)
+{
+    return scene("blend", name, kFloat, kFloatPsnr, [mode](Surface& s) {
+        LayerStack stack(s.get_width(), s.get_height());
+        stack.set_background(Color(0, 0, 0, 255));
+        auto bottom = stack.create_layer("bottom");
+        backdrop(bottom->get_surface());
+        auto top = stack.create_layer_from_surface(sprite(48, 48), "top");
+        top->set_position(8, 8);
+        top->set_blend_mode(mode);
+        top->set_opacity(0.85f);
+        stack.composite_to(s);
+    });
+}
+
+std::vector<Scene> make_scenes()
+{
+    std::vector<Scene> scenes;
+    const Color red(230, 40, 60, 255), blue(40, 90, 230, 200), white(255, 255, 255, 255);
+
+    // Primitives
+    scenes.push_back(scene("primitives", "fill_rect", kExact, kIdenticalPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_rect(4, 4, 30, 20, red);
+        s.fill_rect(20, 16, 40, 40, blue);
+        s.fill_rect(-10, 50, 30, 30, white);  // Clipped
+    }));
+    scenes.push_back(scene("primitives", "lines_no_aa", kExact, kIdenticalPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        for (int i = 0; i < 8; ++i) s.draw_line_no_aa(32, 32, i * 9, i % 2 ? 0 : 63, white);
+        s.draw_rect(2, 2, 60, 60, red);
+    }));
+    scenes.push_back(scene("primitives", "lines_aa", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        for (int i = 0; i < 8; ++i) s.draw_line_aa(32, 32, i * 9, i % 2 ? 0 : 63, white);
+    }));
+    scenes.push_back(scene("primitives", "circles_no_aa", kExact, kIdenticalPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_circle_no_aa(20, 20, 16, red);
+        s.draw_circle_no_aa(40, 40, 20, white);
+        s.fill_circle_no_aa(44, 20, 10, blue);
+    }));
+    scenes.push_back(scene("primitives", "circles_aa", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_circle_aa(20, 20, 16, red);
+        s.draw_circle_aa(40, 40, 20, white);
+        s.fill_circle_aa(44, 20, 10, blue);
+    }));
+    scenes.push_back(scene("primitives", "round_rects", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_round_rect(4, 4, 40, 28, 8, red);
+        s.draw_round_rect(20, 24, 40, 36, 12, white);
+    }));
+    scenes.push_back(scene("primitives", "pills", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_pill(4, 6, 56, 20, blue);
+        s.draw_pill(10, 36, 44, 22, white);
+    }));
+    scenes.push_back(scene("primitives", "squircles", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        s.fill_squircle(4, 4, 36, 36, red);
+        s.draw_squircle(24, 24, 36, 36, white);
+    }));
+    scenes.push_back(scene("primitives", "blend_pixel", kExact, kIdenticalPsnr, [=](Surface& s) {
+        backdrop(s);
+        for (int y = 8; y < 56; ++y)
+            for (int x = 8; x < 56; ++x)
+                s.blend_pixel(x, y, Color(255, 255, 255, static_cast<uint8_t>(x * 4)));
+    }));
+    scenes.push_back(scene("primitives", "blit", kExact, kIdenticalPsnr, [](Surface& s) {
+        backdrop(s);
+        auto sp = sprite(32, 32);
+        s.blit(*sp, 4, 4);
+        s.blit(*sp, 44, 40);  // Clipped
+    }));
+    scenes.push_back(scene("primitives", "blit_scaled", kFloat, kFloatPsnr, [](Surface& s) {
+        backdrop(s);
+        auto sp = sprite(20, 20);
+        s.blit_scaled(*sp, 2, 2, 56, 40);
+    }));
+    scenes.push_back(scene("primitives", "blit_alpha", kFloat, kFloatPsnr, [](Surface& s) {
+        backdrop(s);
+        auto sp = sprite(40, 40);
+        s.blit_alpha(*sp, 12, 12, 0.5f);
+    }));
+
+    // Batch drawing (overlapping, translucent and off-surface items)
+    scenes.push_back(scene("batch", "fill_circles", kFloat, kFloatPsnr, [](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        const int32_t xy[] = {16, 16, 30, 24, 48, 40, -4, 60, 62, 2, 32, 48};
+        const int32_t radii[] = {12, 10, 14, 8, 6, 9};
+        const uint8_t colors[] = {230, 40, 60, 255,  40, 90, 230, 200,  240, 200, 40, 160,
+                                  255, 255, 255, 255,  60, 220, 120, 255,  200, 60, 220, 120};
+        BatchDraw::fill_circles(s, xy, Strided<int32_t>(radii, 1), Strided<uint8_t>(colors, 4), 6);
+    }));
+    scenes.push_back(scene("batch", "draw_lines", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        const int32_t segments[] = {0, 0, 63, 63,  0, 63, 63, 0,  5, 40, 60, 34,  32, -10, 32, 80,  -5, 20, 70, 28};
+        const uint8_t color[] = {white.r, white.g, white.b, white.a};
+        BatchDraw::draw_lines(s, segments, Strided<uint8_t>(color, 0), 5);
+    }));
+    scenes.push_back(scene("batch", "rects_and_pixels", kExact, kIdenticalPsnr, [](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        const int32_t rects[] = {4, 4, 30, 20,  20, 14, 40, 30,  -8, 50, 20, 30,  60, 60, 10, 10};
+        const uint8_t colors[] = {230, 40, 60, 255,  40, 90, 230, 200,  240, 200, 40, 160,  255, 255, 255, 255};
+        BatchDraw::fill_rects(s, rects, Strided<uint8_t>(colors, 4), 4);
+        int32_t xy[64 * 2];
+        for (int i = 0; i < 64; ++i) {
+            xy[i * 2] = i;
+            xy[i * 2 + 1] = (i * 37) % 64;
+        }
+        const uint8_t dot[] = {255, 255, 0, 255};
+        BatchDraw::set_pixels(s, xy, Strided<uint8_t>(dot, 0), 64);
+    }));
+
+    scenes.push_back(scene("batch", "sprites", kFloat, kFloatPsnr, [](Surface& s) {
+        backdrop(s);
+        SpriteBatch batch(sprite(16, 16));
+        const float xy[] = {2, 2,  20, 4,  40.5f, 6.5f,  8, 30,  30, 30,  50, 50};
+        const float scale[] = {1, 1, 1, 1.5f, 0.75f, 1};
+        const float rotation[] = {0, 0, 0, 0.6f, 2.2f, 0};
+        const float alpha[] = {1, 0.5f, 1, 1, 0.8f, 1};
+        const uint8_t tint[] = {255, 255, 255, 255,  255, 255, 255, 255,  255, 120, 60, 255,
+                                255, 255, 255, 255,  120, 200, 255, 200,  255, 255, 255, 255};
+        const int32_t rects[] = {0, 0, 16, 16,  0, 0, 16, 16,  4, 4, 8, 8,
+                                 0, 0, 16, 16,  0, 0, 16, 16,  8, 0, 8, 16};
+        SpriteInstances in;
+        in.xy = xy;
+        in.scale = Strided<float>(scale, 1);
+        in.rotation = Strided<float>(rotation, 1);
+        in.alpha = Strided<float>(alpha, 1);
+        in.tint = Strided<uint8_t>(tint, 4);
+        in.rects = Strided<int32_t>(rects, 4);
+        in.count = 6;
+        batch.draw(s, in);
+    }));
+
+    // Display lists (recorded, then replayed; text comes from a stand-in rasterizer)
+    scenes.push_back(scene("display_list", "replay", kFloat, kFloatPsnr, [=](Surface& s) {
+        DisplayList dl;
+        dl.fill(Color(20, 20, 30, 255));
+        dl.fill_round_rect(4, 4, 40, 28, 8, red);
+        dl.push_clip(8, 8, 48, 48);
+        dl.fill_circle(44, 44, 20, blue);
+        dl.draw_line(0, 63, 63, 0, white);
+        dl.pop_clip();
+        dl.blit_alpha(sprite(24, 24), 30, 2, 0.75f);
+        dl.draw_text([] { return sprite(20, 8); }, 4, 50);
+        dl.blur_region(0, 0, 32, 32, 3);
+        dl.draw_pill(2, 36, 40, 16, white);
+        dl.replay(s);
+    }));
+    scenes.push_back(scene("display_list", "damage_rect", kFloat, kFloatPsnr, [=](Surface& s) {
+        backdrop(s);
+        DisplayList dl;
+        dl.fill(Color(20, 20, 30, 255));
+        dl.fill_squircle(8, 8, 48, 48, red);
+        dl.draw_circle(32, 32, 24, white);
+        dl.replay(s, 16, 12, 32, 24);  // Outside the damage rect the backdrop survives
+    }));
+
+    // Particles (seeded; several emitter shapes, gravity, drag and easing)
+    scenes.push_back(scene("particles", "emitters", kFloat, kFloatPsnr, [](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        ParticleSystem ps(500);
+        ps.seed(7);
+        ps.set_gravity(0.0f, 40.0f);
+        ps.set_drag(0.5f);
+        ps.set_color(Color(255, 220, 80, 255), Color(255, 40, 0, 0), EasingType::EaseInQuad);
+        ps.set_size(3.0f, 0.0f, EasingType::EaseOutCubic);
+        ParticleEmitter ring;
+        ring.shape = EmitterShape::Ring;
+        ring.x = 20.0f;
+        ring.y = 24.0f;
+        ring.radius = 8.0f;
+        ring.radial = true;
+        ring.spread = 0.0f;
+        ring.speed_min = ring.speed_max = 30.0f;
+        ring.rate = 0.0f;
+        ParticleEmitter line;
+        line.shape = EmitterShape::Line;
+        line.x = 36.0f;
+        line.y = 60.0f;
+        line.width = 24.0f;
+        line.spread = 0.5f;
+        line.rate = 120.0f;
+        line.lifetime_min = 0.5f;
+        ps.add_emitter(ring);
+        ps.add_emitter(line);
+        ps.burst(0, 24);
+        for (int i = 0; i < 20; ++i) ps.update(1.0f / 60.0f);
+        ps.render(s);
+    }));
+
+    // Atlas views drawn, blurred and blitted like surfaces, across a defragment
+    scenes.push_back(scene("atlas", "views", kFloat, kFloatPsnr, [=](Surface& s) {
+        s.fill(Color(20, 20, 30, 255));
+        Atlas atlas(48, 48);
+        std::vector<SurfaceView> views;
+        for (int i = 0; i < 8; ++i) views.push_back(atlas.add(*sprite(12 + i * 2, 10 + i)));
+        views[0].reset();
+        atlas.free(views[3]);
+        views[3].reset();
+        atlas.defragment();
+        views[5]->fill_circle(8, 8, 6, red);
+        Effects::box_blur(*views[6], 2);
+        int x = 0, y = 0;
+        for (const auto& v : views) {
+            if (!v) continue;
+            if (x + v->get_width() > 64) { x = 0; y += 20; }
+            s.blit(*v, x, y);
+            x += v->get_width() + 1;
+        }
+    }));
+
+    // Effects
+    scenes.push_back(effect("box_blur", kFloat, kFloatPsnr, [](Surface& s) { Effects::box_blur(s, 4); }));
+    scenes.push_back(effect("gaussian_blur", kFloat, kFloatPsnr, [](Surface& s) { Effects::gaussian_blur(s, 3.0f); }));
+    scenes.push_back(effect("blur_region", kFloat, kFloatPsnr, [](Surface& s) { Effects::blur_region(s, 10, 10, 40, 30, 5); }));
+    scenes.push_back(effect("frosted_glass_region", kNoise, kNoisePsnr, [](Surface& s) {
+        Effects::seed(1234);
+        Effects::frosted_glass_region(s, 8, 8, 48, 48, 6);
+    }));
+    scenes.push_back(effect("displace", kFloat, kFloatPsnr, [](Surface& s) {
+        Surface map(s.get_width(), s.get_height());
+        Effects::radial_gradient(map, 32, 32, 32, Color(255, 0, 0, 255), Color(0, 255, 0, 255));
+        Effects::displace(s, map, 6.0f);
+    }));
+    scenes.push_back(effect("wave_distort", kFloat, kFloatPsnr, [](Surface& s) { Effects::wave_distort(s, 4.0f, 0.2f, 0.5f); }));
+    scenes.push_back(effect("ripple", kFloat, kFloatPsnr, [](Surface& s) { Effects::ripple(s, 32, 32, 3.0f, 12.0f, 1.0f); }));
+    scenes.push_back(effect("brightness", kFloat, kFloatPsnr, [](Surface& s) { Effects::brightness(s, 0.25f); }));
+    scenes.push_back(effect("contrast", kFloat, kFloatPsnr, [](Surface& s) { Effects::contrast(s, 1.5f); }));
+    scenes.push_back(effect("saturation", kFloat, kFloatPsnr, [](Surface& s) { Effects::saturation(s, 0.3f); }));
+    scenes.push_back(effect("hue_shift", kFloat, kFloatPsnr, [](Surface& s) { Effects::hue_shift(s, 120.0f); }));
+    scenes.push_back(effect("invert", kExact, kIdenticalPsnr, [](Surface& s) { Effects::invert(s); }));
+    scenes.push_back(effect("grayscale", kFloat, kFloatPsnr, [](Surface& s) { Effects::grayscale(s); }));
+    scenes.push_back(effect("sepia", kFloat, kFloatPsnr, [](Surface& s) { Effects::sepia(s, 0.8f); }));
+    scenes.push_back(effect("blend", kFloat, kFloatPsnr, [](Surface& s) {
+        Surface other(s.get_width(), s.get_height());
+        Effects::radial_gradient(other, 32, 32, 30, Color(255, 255, 255, 255), Color(0, 0, 0, 255));
+        Effects::blend(s, other, 0.4f);
+    }));
+    scenes.push_back(effect("radial_gradient", kFloat, kFloatPsnr, [](Surface& s) {
+        Effects::radial_gradient(s, 24, 40, 30, Color(255, 240, 200, 255), Color(20, 0, 60, 0));
+    }));
+    scenes.push_back(effect("perlin_noise", kNoise, kNoisePsnr, [](Surface& s) {
+        Effects::seed(1234);
+        Effects::perlin_noise(s, 0.08f, 3);
+    }));
+    scenes.push_back(effect("noise", kNoise, kNoisePsnr, [](Surface& s) {
+        Effects::seed(1234);
+        Effects::noise(s, 0.2f);
+    }));
+    scenes.push_back(effect("drop_shadow", kFloat, kFloatPsnr, [](Surface& s) {
+        auto shadow = Effects::drop_shadow(*sprite(40, 40), 4, 4, 4, Color(0, 0, 0, 160));
+        s.blit_alpha(*shadow, 8, 8);
+    }));
+    scenes.push_back(effect("blurred_surface", kFloat, kFloatPsnr, [](Surface& s) {
+        BlurredSurface blurred(sprite(48, 48));
+        blurred.set_blur_radius(3.0f);
+        blurred.render_to(s, 8, 8);
+    }));
+
+    // Blend modes
+    scenes.push_back(blend_scene("normal", BlendMode::Normal));
+    scenes.push_back(blend_scene("multiply", BlendMode::Multiply));
+    scenes.push_back(blend_scene("screen", BlendMode::Screen));
+    scenes.push_back(blend_scene("overlay", BlendMode::Overlay));
+    scenes.push_back(blend_scene("add", BlendMode::Add));
+    scenes.push_back(blend_scene("subtract", BlendMode::Subtract));
+    scenes.push_back(blend_scene("difference", BlendMode::Difference));
+    scenes.push_back(blend_scene("color_dodge", BlendMode::ColorDodge));
+    scenes.push_back(blend_scene("color_burn", BlendMode::ColorBurn));
+
+    // Layer transforms and materials
+    scenes.push_back(scene("layers", "scale_rotate", kFloat, kFloatPsnr, [](Surface& s) {
+        LayerStack stack(s.get_width(), s.get_height());
+        stack.set_background(Color(30, 30, 40, 255));
+        auto layer = stack.create_layer_from_surface(sprite(32, 32), "sprite");
+        layer->set_position(16, 16);
+        layer->set_scale(1.4f, 0.8f);
+        layer->set_rotation(30.0f);
+        stack.composite_to(s);
+    }));
+    scenes.push_back(scene("layers", "frosted_glass", kFloat, kFloatPsnr, [](Surface& s) {
+        LayerStack stack(s.get_width(), s.get_height());
+        auto bottom = stack.create_layer("bottom");
+        backdrop(bottom->get_surface());
+        auto glass = stack.create_layer("glass");
+        glass->get_surface().clear();
+        glass->get_surface().fill_round_rect(8, 8, 48, 48, 10, Color(255, 255, 255, 60));
+        glass->set_material(Material::frosted_glass(6.0f));
+        stack.composite_to(s);
+    }));
+
+#ifdef PALLADIUM_GOLDEN_WIDGETS
+    // Button states (no label: text rendering depends on installed fonts)
+    auto button_scene = [](const std::string& name, ButtonShape shape, int mouse_x, bool press) {
+        return scene("widgets", name, kFloat, kFloatPsnr, [=](Surface& s) {
+            Button button(s.get_width() - 8, 32, shape, 10);
+            ButtonStyle normal, hover, pressed;
+            normal.color = Color(70, 110, 220, 255);
+            hover.color = Color(100, 140, 250, 255);
+            pressed.color = Color(40, 70, 160, 255);
+            pressed.scale = 0.95f;
+            button.set_hover_animation(ButtonAnimType::Instant);
+            button.set_normal_style(normal);
+            button.set_hover_style(hover);
+            button.set_pressed_style(pressed);
+
+            Event move;
+            move.type = EventType::MouseMotion;
+            move.mouse_x = mouse_x;
+            move.mouse_y = 16;
+            button.process_event(move);
+            if (press) {
+                Event down = move;
+                down.type = EventType::MouseButtonDown;
+                button.process_event(down);
+            }
+            button.update(1.0f);
+
+            s.fill(Color(20, 20, 30, 255));
+            s.blit(button.get_surface(), 4, 16);
+        });
+    };
+    scenes.push_back(button_scene("button_normal", ButtonShape::RoundedRect, -100, false));
+    scenes.push_back(button_scene("button_hover", ButtonShape::RoundedRect, 20, false));
+    scenes.push_back(button_scene("button_pressed", ButtonShape::RoundedRect, 20, true));
+    scenes.push_back(button_scene("pill_hover", ButtonShape::Pill, 20, false));
+#endif
+
+    return scenes;
+}
+
+// ---------------------------------------------------------------------------
+// Images
+// ---------------------------------------------------------------------------
+
+bool write_pam(const std::string& path, const Surface& s)
+{
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    f << "P7\nWIDTH " << s.get_width() << "\nHEIGHT " << s.get_height()
+      << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+    for (int y = 0; y < s.get_height(); ++y) {
+        f.write(reinterpret_cast<const char*>(s.get_data() + y * s.get_pitch()), s.get_width() * 4);
+    }
+    return static_cast<bool>(f);
+}
+
+// Returns nullptr if the file is missing or not an 8-bit RGBA PAM
+std::unique_ptr<Surface> read_pam(const std::string& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return nullptr;
+    int w = 0, h = 0, depth = 0, maxval = 0;
+    std::string line;
+    if (!std::getline(f, line) || line != "P7") return nullptr;
+    while (std::getline(f, line) && line != "ENDHDR") {
+        std::istringstream ls(line);
+        std::string key;
+        ls >> key;
+        if (key == "WIDTH") ls >> w;
+        else if (key == "HEIGHT") ls >> h;
+        else if (key == "DEPTH") ls >> depth;
+        else if (key == "MAXVAL") ls >> maxval;
+    }
+    if (w <= 0 || h <= 0 || depth != 4 || maxval != 255) return nullptr;
+    auto s = std::make_unique<Surface>(w, h);
+    for (int y = 0; y < h; ++y) {
+        f.read(reinterpret_cast<char*>(s->get_data() + y * s->get_pitch()), w * 4);
+    }
+    return f ? std::move(s) : nullptr;
+}
+
+// Largest channel difference and PSNR over all RGBA channels; writes an
+// amplified difference image when `diff` is given
+void compare(const Surface& a, const Surface& b, int& max_error, double& psnr, Surface* diff)
+{
+    max_error = 0;
+    double sum_sq = 0.0;
+    int w = a.get_width(), h = a.get_height();
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* pa = a.get_data() + y * a.get_pitch();
+        const uint8_t* pb = b.get_data() + y * b.get_pitch();
+        for (int x = 0; x < w; ++x) {
+            int px_max = 0;
+            for (int c = 0; c < 4; ++c) {
+                int d = std::abs(static_cast<int>(pa[x * 4 + c]) - static_cast<int>(pb[x * 4 + c]));
+                px_max = std::max(px_max, d);
+                sum_sq += static_cast<double>(d) * d;
+            }
+            max_error = std::max(max_error, px_max);
+            if (diff) {
+                uint8_t v = static_cast<uint8_t>(std::min(255, px_max * 16));
+                diff->set_pixel(x, y, v, v, v, 255);
+            }
+        }
+    }
+    double mse = sum_sq / (static_cast<double>(w) * h * 4);
+    psnr = mse > 0.0 ? std::min(kIdenticalPsnr, 10.0 * std::log10(255.0 * 255.0 / mse)) : kIdenticalPsnr;
+}
+
+// Mean render time in milliseconds over at least `min_time` seconds
+double time_scene(const Scene& sc, double min_time)
+{
+    Surface s(kSize, kSize);
+    long long iterations = 0;
+    auto start = bench::Clock::now();
+    double elapsed = 0.0;
+    do {
+        sc.render(s);
+        iterations++;
+        elapsed = bench::seconds_since(start);
+    } while (elapsed < min_time);
+    return elapsed * 1000.0 / static_cast<double>(iterations);
+}
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: palladium_golden [--filter substr] [--refs dir] [--update] [--out dir]\n"
+        "                        [--min-time seconds] [--json path|-] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string refs = PALLADIUM_GOLDEN_DIR;
+    std::string out_dir;
+    std::string json_path;
+    double min_time = 0.05;
+    bool update = false;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) { usage(); std::exit(2); }
+            return argv[++i];
+        };
+        if (arg == "--filter") filter = next();
+        else if (arg == "--refs") refs = next();
+        else if (arg == "--out") out_dir = next();
+        else if (arg == "--json") json_path = next();
+        else if (arg == "--min-time") min_time = std::atof(next().c_str());
+        else if (arg == "--update") update = true;
+        else if (arg == "--list") list_only = true;
+        else { usage(); return 2; }
+    }
+
+    std::vector<Scene> scenes = make_scenes();
+    if (list_only) {
+        for (const auto& sc : scenes) std::printf("%s\n", sc.id().c_str());
+        return 0;
+    }
+
+    std::vector<Result> results;
+    int failures = 0;
+    for (const auto& sc : scenes) {
+        if (!filter.empty() && sc.id().find(filter) == std::string::npos) continue;
+
+        Surface actual(kSize, kSize);
+        sc.render(actual);
+
+        Result r{sc.id(), "pass", 0, kIdenticalPsnr, 0.0, sc.max_error, sc.min_psnr};
+        std::string ref_path = refs + "/" + sc.file();
+        if (update) {
+            if (!write_pam(ref_path, actual)) {
+                std::fprintf(stderr, "cannot write %s\n", ref_path.c_str());
+                return 2;
+            }
+            r.status = "updated";
+        } else {
+            auto expected = read_pam(ref_path);
+            if (!expected || expected->get_width() != kSize || expected->get_height() != kSize) {
+                r.status = "missing";
+                failures++;
+            } else {
+                std::unique_ptr<Surface> diff;
+                if (!out_dir.empty()) diff = std::make_unique<Surface>(kSize, kSize);
+                compare(actual, *expected, r.max_error, r.psnr, diff.get());
+                if (r.max_error > sc.max_error || r.psnr < sc.min_psnr) {
+                    r.status = "fail";
+                    failures++;
+                    if (diff) {
+                        write_pam(out_dir + "/" + sc.category + "_" + sc.name + ".actual.pam", actual);
+                        write_pam(out_dir + "/" + sc.category + "_" + sc.name + ".diff.pam", *diff);
+                    }
+                }
+            }
+        }
+        r.ms = time_scene(sc, min_time);
+        std::fprintf(stderr, "%-32s %-7s max_err %3d (<= %3d)  psnr %6.2f (>= %5.1f)  %8.4f ms\n",
+                     r.id.c_str(), r.status.c_str(), r.max_error, r.tolerance_max_error,
+                     r.psnr, r.tolerance_psnr, r.ms);
+        results.push_back(r);
+    }
+
+    if (!json_path.empty()) {
+        std::vector<std::string> items;
+        for (const auto& r : results) {
+            bench::JsonObject o;
+            o.add("scene", r.id).add("status", r.status)
+             .add("max_error", r.max_error).add("psnr", r.psnr)
+             .add("tolerance_max_error", r.tolerance_max_error).add("tolerance_psnr", r.tolerance_psnr)
+             .add("ms", r.ms);
+            items.push_back(o.str());
+        }
+        bench::JsonObject root;
+        root.add("suite", "palladium_golden").add("version", 1)
+            .add("size", kSize).add("failures", failures)
+            .raw("results", bench::json_array(items));
+        if (!bench::write_text(json_path, root.str() + "\n")) {
+            std::fprintf(stderr, "cannot write %s\n", json_path.c_str());
+            return 2;
+        }
+    }
+
+    std::fprintf(stderr, "%zu scenes, %d failed\n", results.size(), failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,525 @@
+/**
+ * palladium_microbench - Throughput of Surface primitives, blits, Effects and compositing
+ *
+ * Every case is run for each requested surface size and thread count. With
+ * N threads, N independent instances run concurrently (one surface each),
+ * reporting per-call latency and aggregate megapixels per second.
+ *
+ * Usage: palladium_microbench [--filter substr] [--sizes 256x256,1280x720]
+ *                             [--threads 1,4] [--min-time 0.25] [--json out.json] [--list]
+ */
+
+#include "bench_common.hpp"
+#include "surface.hpp"
+#include "effects.hpp"
+#include "batch.hpp"
+#include "display_list.hpp"
+#include "particles.hpp"
+#include "layer.hpp"
+#include "material.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+
+using namespace nativeui;
+
+namespace {
+
+/**
+ * One runnable benchmark instance; `pixels` is the work per call used for MP/s
+ */
+struct Op {
+    std::function<void()> run;
+    double pixels;
+};
+
+using Factory = std::function<Op(int w, int h)>;
+
+struct Case {
+    std::string category;
+    std::string name;
+    Factory make;
+};
+
+struct Result {
+    std::string category;
+    std::string name;
+    int width;
+    int height;
+    int threads;
+    long long iterations;
+    double ns_per_call;
+    double mpix_per_s;
+};
+
+// Deterministic test content: gradient, shapes and partial transparency
+std::shared_ptr<Surface> make_pattern(int w, int h, uint8_t alpha = 255)
+{
+    auto s = std::make_shared<Surface>(w, h);
+    Effects::linear_gradient(*s, 0, 0, w, h, Color(30, 60, 120, alpha), Color(220, 120, 40, alpha));
+    int r = std::max(2, std::min(w, h) / 8);
+    for (int i = 0; i < 6; ++i) {
+        s->fill_circle_no_aa((i * 37 % 100) * w / 100, (i * 61 % 100) * h / 100, r,
+                             Color(static_cast<uint8_t>(40 * i), 200, static_cast<uint8_t>(255 - 40 * i), 180));
+    }
+    return s;
+}
+
+double px(int w, int h) { return static_cast<double>(w) * h; }
+
+// Surface op on a fresh pattern surface
+Case surface_case(const std::string& name, std::function<double(int, int)> pixels,
+                  std::function<void(Surface&, int, int)> fn)
+{
+    return {"surface", name, [pixels, fn](int w, int h) {
+        auto s = make_pattern(w, h);
+        return Op{[s, fn, w, h]() { fn(*s, w, h); }, pixels(w, h)};
+    }};
+}
+
+Case effect_case(const std::string& name, std::function<void(Surface&, int, int)> fn)
+{
+    return {"effects", name, [fn](int w, int h) {
+        auto s = make_pattern(w, h);
+        return Op{[s, fn, w, h]() { fn(*s, w, h); }, px(w, h)};
+    }};
+}
+
+std::vector<Case> build_cases()
+{
+    std::vector<Case> cases;
+    auto area = [](int w, int h) { return px(w, h); };
+    auto diag = [](int w, int h) { return std::max<double>(w, h); };
+    auto circle_edge = [](int w, int h) { return 2.0 * 3.14159265 * (std::min(w, h) / 2 - 1); };
+    auto circle_area = [](int w, int h) { double r = std::min(w, h) / 2 - 1; return 3.14159265 * r * r; };
+    auto rect_edge = [](int w, int h) { return 2.0 * (w + h); };
+    const Color c(200, 80, 40, 255);
+    const Color ct(200, 80, 40, 128);
+
+    // --- Surface primitives ---
+    cases.push_back(surface_case("fill", area, [c](Surface& s, int, int) { s.fill(c); }));
+    cases.push_back(surface_case("clear", area, [](Surface& s, int, int) { s.clear(); }));
+    cases.push_back(surface_case("fill_rect", area, [c](Surface& s, int w, int h) { s.fill_rect(0, 0, w, h, c); }));
+    cases.push_back(surface_case("set_pixel", area, [c](Surface& s, int w, int h) {
+        for (int y = 0; y < h; ++y) for (int x = 0; x < w; ++x) s.set_pixel(x, y, c);
+    }));
+    cases.push_back(surface_case("get_pixel", area, [](Surface& s, int w, int h) {
+        uint32_t acc = 0;
+        for (int y = 0; y < h; ++y) for (int x = 0; x < w; ++x) acc += s.get_pixel(x, y).r;
+        if (acc == 0xFFFFFFFF) std::printf(" ");  // Keep the loop observable
+    }));
+    cases.push_back(surface_case("blend_pixel", area, [ct](Surface& s, int w, int h) {
+        for (int y = 0; y < h; ++y) for (int x = 0; x < w; ++x) s.blend_pixel(x, y, ct);
+    }));
+    cases.push_back(surface_case("draw_line", diag, [c](Surface& s, int w, int h) { s.draw_line(0, 0, w - 1, h - 1, c); }));
+    cases.push_back(surface_case("draw_line_aa", diag, [c](Surface& s, int w, int h) { s.draw_line_aa(0, 0, w - 1, h - 1, c); }));
+    cases.push_back(surface_case("draw_line_no_aa", diag, [c](Surface& s, int w, int h) { s.draw_line_no_aa(0, 0, w - 1, h - 1, c); }));
+    cases.push_back(surface_case("draw_rect", rect_edge, [c](Surface& s, int w, int h) { s.draw_rect(0, 0, w, h, c); }));
+    cases.push_back(surface_case("draw_circle", circle_edge, [c](Surface& s, int w, int h) {
+        s.draw_circle(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("draw_circle_aa", circle_edge, [c](Surface& s, int w, int h) {
+        s.draw_circle_aa(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("draw_circle_no_aa", circle_edge, [c](Surface& s, int w, int h) {
+        s.draw_circle_no_aa(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("fill_circle", circle_area, [c](Surface& s, int w, int h) {
+        s.fill_circle(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("fill_circle_aa", circle_area, [c](Surface& s, int w, int h) {
+        s.fill_circle_aa(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("fill_circle_no_aa", circle_area, [c](Surface& s, int w, int h) {
+        s.fill_circle_no_aa(w / 2, h / 2, std::min(w, h) / 2 - 1, c);
+    }));
+    cases.push_back(surface_case("draw_round_rect", rect_edge, [c](Surface& s, int w, int h) {
+        s.draw_round_rect(0, 0, w, h, std::min(w, h) / 8, c);
+    }));
+    cases.push_back(surface_case("fill_round_rect", area, [c](Surface& s, int w, int h) {
+        s.fill_round_rect(0, 0, w, h, std::min(w, h) / 8, c);
+    }));
+    cases.push_back(surface_case("draw_pill", rect_edge, [c](Surface& s, int w, int h) { s.draw_pill(0, 0, w, h, c); }));
+    cases.push_back(surface_case("fill_pill", area, [c](Surface& s, int w, int h) { s.fill_pill(0, 0, w, h, c); }));
+    cases.push_back(surface_case("draw_squircle", rect_edge, [c](Surface& s, int w, int h) { s.draw_squircle(0, 0, w, h, c); }));
+    cases.push_back(surface_case("fill_squircle", area, [c](Surface& s, int w, int h) { s.fill_squircle(0, 0, w, h, c); }));
+    cases.push_back(surface_case("copy", area, [](Surface& s, int, int) { auto copy = s.copy(); }));
+    cases.push_back(surface_case("subsurface", [](int w, int h) { return px(w / 2, h / 2); },
+        [](Surface& s, int w, int h) { auto sub = s.subsurface(w / 4, h / 4, w / 2, h / 2); }));
+
+    // --- Blits ---
+    cases.push_back({"blit", "blit_opaque", [](int w, int h) {
+        auto dst = make_pattern(w, h);
+        auto src = make_pattern(w, h, 255);
+        return Op{[dst, src]() { dst->blit(*src, 0, 0); }, px(w, h)};
+    }});
+    cases.push_back({"blit", "blit_translucent", [](int w, int h) {
+        auto dst = make_pattern(w, h);
+        auto src = make_pattern(w, h, 128);
+        return Op{[dst, src]() { dst->blit(*src, 0, 0); }, px(w, h)};
+    }});
+    cases.push_back({"blit", "blit_alpha", [](int w, int h) {
+        auto dst = make_pattern(w, h);
+        auto src = make_pattern(w, h, 200);
+        return Op{[dst, src]() { dst->blit_alpha(*src, 0, 0, 0.5f); }, px(w, h)};
+    }});
+    cases.push_back({"blit", "blit_scaled_up", [](int w, int h) {
+        auto dst = make_pattern(w, h);
+        auto src = make_pattern(std::max(1, w / 2), std::max(1, h / 2));
+        return Op{[dst, src, w, h]() { dst->blit_scaled(*src, 0, 0, w, h); }, px(w, h)};
+    }});
+    cases.push_back({"blit", "blit_scaled_down", [](int w, int h) {
+        auto dst = make_pattern(w, h);
+        auto src = make_pattern(w * 2, h * 2);
+        return Op{[dst, src, w, h]() { dst->blit_scaled(*src, 0, 0, w, h); }, px(w, h)};
+    }});
+
+    // --- Batch drawing vs. one call per item (scatter plot workload) ---
+    auto scatter = [](int w, int h, int n, int coords) {
+        auto data = std::make_shared<std::vector<int32_t>>(static_cast<size_t>(n) * coords);
+        for (int i = 0; i < n * coords; ++i) {
+            (*data)[i] = static_cast<int32_t>((i * 2654435761u) % static_cast<unsigned>(i % 2 ? h : w));
+        }
+        return data;
+    };
+    const uint8_t rgba[] = {200, 80, 40, 160};
+    const Color ca(200, 80, 40, 160);
+    cases.push_back({"batch", "fill_circles_batch", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto xy = scatter(w, h, 2000, 2);
+        return Op{[s, xy, rgba]() {
+            int32_t r = 3;
+            BatchDraw::fill_circles(*s, xy->data(), Strided<int32_t>(&r, 0), Strided<uint8_t>(rgba, 0), 2000);
+        }, 2000.0};
+    }});
+    cases.push_back({"batch", "fill_circles_loop", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto xy = scatter(w, h, 2000, 2);
+        return Op{[s, xy, ca]() {
+            for (int i = 0; i < 2000; ++i) s->fill_circle((*xy)[i * 2], (*xy)[i * 2 + 1], 3, ca);
+        }, 2000.0};
+    }});
+    cases.push_back({"batch", "set_pixels_batch", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto xy = scatter(w, h, 20000, 2);
+        return Op{[s, xy, rgba]() {
+            BatchDraw::set_pixels(*s, xy->data(), Strided<uint8_t>(rgba, 0), 20000);
+        }, 20000.0};
+    }});
+    cases.push_back({"batch", "set_pixels_loop", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto xy = scatter(w, h, 20000, 2);
+        return Op{[s, xy, ca]() {
+            for (int i = 0; i < 20000; ++i) s->set_pixel((*xy)[i * 2], (*xy)[i * 2 + 1], ca);
+        }, 20000.0};
+    }});
+
+    cases.push_back({"batch", "sprites_batch", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto icon = make_pattern(16, 16);
+        auto xy = scatter(w, h, 2000, 2);
+        auto fxy = std::make_shared<std::vector<float>>(xy->begin(), xy->end());
+        auto batch = std::make_shared<SpriteBatch>(icon);
+        return Op{[s, fxy, batch]() {
+            float alpha = 0.75f;
+            SpriteInstances in;
+            in.xy = fxy->data();
+            in.alpha = Strided<float>(&alpha, 0);
+            in.count = 2000;
+            batch->draw(*s, in);
+        }, 2000.0};
+    }});
+    cases.push_back({"batch", "sprites_loop", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto icon = make_pattern(16, 16);
+        auto xy = scatter(w, h, 2000, 2);
+        return Op{[s, icon, xy]() {
+            for (int i = 0; i < 2000; ++i) s->blit_alpha(*icon, (*xy)[i * 2], (*xy)[i * 2 + 1], 0.75f);
+        }, 2000.0};
+    }});
+
+    // --- Particles: 50k live particles, one simulation step / one render ---
+    auto fountain = [](int w, int h) {
+        auto ps = std::make_shared<ParticleSystem>(50000);
+        ps->seed(1);
+        ps->set_gravity(0.0f, 60.0f);
+        ps->set_drag(0.2f);
+        ps->set_color(Color(255, 200, 50, 255), Color(255, 40, 0, 0));
+        ps->set_size(3.0f, 1.0f);
+        ParticleEmitter e;
+        e.shape = EmitterShape::Rect;
+        e.width = static_cast<float>(w);
+        e.height = static_cast<float>(h);
+        e.rate = 0.0f;
+        e.lifetime_min = e.lifetime_max = 1e6f;  // Keep the count steady
+        ps->add_emitter(e);
+        ps->burst(0, 50000);
+        return ps;
+    };
+    cases.push_back({"particles", "update_50k", [=](int w, int h) {
+        auto ps = fountain(w, h);
+        return Op{[ps]() { ps->update(1.0f / 60.0f); }, 50000.0};
+    }});
+    cases.push_back({"particles", "render_50k", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto ps = fountain(w, h);
+        return Op{[s, ps]() { ps->render(*s); }, 50000.0};
+    }});
+
+    // --- Display list replay vs. immediate drawing (UI-like scene) ---
+    auto record_ui = [](DisplayList& dl, int w, int h) {
+        dl.fill(Color(20, 20, 30, 255));
+        for (int i = 0; i < 2000; ++i) {
+            int x = static_cast<int>((i * 2654435761u) % static_cast<unsigned>(w));
+            int y = static_cast<int>((i * 40503u) % static_cast<unsigned>(h));
+            if (i % 2) dl.fill_round_rect(x, y, 24, 16, 4, Color(200, 80, 40, 200));
+            else dl.fill_circle(x, y, 6, Color(40, 90, 230, 160));
+        }
+    };
+    cases.push_back({"display_list", "replay_2000", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto dl = std::make_shared<DisplayList>();
+        record_ui(*dl, w, h);
+        return Op{[s, dl]() { dl->replay(*s); }, px(w, h)};
+    }});
+    cases.push_back({"display_list", "replay_damage_2000", [=](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto dl = std::make_shared<DisplayList>();
+        record_ui(*dl, w, h);
+        return Op{[s, dl, w, h]() { dl->replay(*s, w / 4, h / 4, w / 4, h / 4); }, px(w / 4, h / 4)};
+    }});
+
+    // --- Effects ---
+    cases.push_back(effect_case("box_blur_r4", [](Surface& s, int, int) { Effects::box_blur(s, 4); }));
+    cases.push_back(effect_case("box_blur_r16", [](Surface& s, int, int) { Effects::box_blur(s, 16); }));
+    cases.push_back(effect_case("gaussian_blur_s4", [](Surface& s, int, int) { Effects::gaussian_blur(s, 4.0f); }));
+    cases.push_back(effect_case("gaussian_blur_s20", [](Surface& s, int, int) { Effects::gaussian_blur(s, 20.0f); }));
+    cases.push_back(effect_case("blur_region", [](Surface& s, int w, int h) { Effects::blur_region(s, w / 4, h / 4, w / 2, h / 2, 6); }));
+    cases.push_back(effect_case("frosted_glass", [](Surface& s, int, int) { Effects::frosted_glass(s, 10); }));
+    cases.push_back(effect_case("frosted_glass_region", [](Surface& s, int w, int h) {
+        Effects::frosted_glass_region(s, w / 4, h / 4, w / 2, h / 2, 10);
+    }));
+    cases.push_back({"effects", "displace", [](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto map = make_pattern(w, h);
+        return Op{[s, map]() { Effects::displace(*s, *map, 8.0f); }, px(w, h)};
+    }});
+    cases.push_back(effect_case("wave_distort", [](Surface& s, int, int) { Effects::wave_distort(s, 6.0f, 0.05f, 0.3f); }));
+    cases.push_back(effect_case("ripple", [](Surface& s, int w, int h) { Effects::ripple(s, w / 2, h / 2, 4.0f, 24.0f, 0.3f); }));
+    cases.push_back(effect_case("brightness", [](Surface& s, int, int) { Effects::brightness(s, 0.1f); }));
+    cases.push_back(effect_case("contrast", [](Surface& s, int, int) { Effects::contrast(s, 1.1f); }));
+    cases.push_back(effect_case("saturation", [](Surface& s, int, int) { Effects::saturation(s, 0.8f); }));
+    cases.push_back(effect_case("hue_shift", [](Surface& s, int, int) { Effects::hue_shift(s, 30.0f); }));
+    cases.push_back(effect_case("invert", [](Surface& s, int, int) { Effects::invert(s); }));
+    cases.push_back(effect_case("grayscale", [](Surface& s, int, int) { Effects::grayscale(s); }));
+    cases.push_back(effect_case("sepia", [](Surface& s, int, int) { Effects::sepia(s, 0.8f); }));
+    cases.push_back({"effects", "blend", [](int w, int h) {
+        auto s = make_pattern(w, h);
+        auto src = make_pattern(w, h, 200);
+        return Op{[s, src]() { Effects::blend(*s, *src, 0.5f); }, px(w, h)};
+    }});
+    cases.push_back(effect_case("linear_gradient", [](Surface& s, int w, int h) {
+        Effects::linear_gradient(s, 0, 0, w, h, Color(0, 0, 0), Color(255, 255, 255));
+    }));
+    cases.push_back(effect_case("radial_gradient", [](Surface& s, int w, int h) {
+        Effects::radial_gradient(s, w / 2, h / 2, std::max(w, h) / 2, Color(255, 255, 255), Color(0, 0, 0));
+    }));
+    cases.push_back(effect_case("noise", [](Surface& s, int, int) { Effects::noise(s, 0.05f); }));
+    cases.push_back(effect_case("perlin_noise", [](Surface& s, int, int) { Effects::perlin_noise(s, 0.02f, 4); }));
+    cases.push_back({"effects", "drop_shadow", [](int w, int h) {
+        auto src = make_pattern(std::max(1, w / 2), std::max(1, h / 2), 200);
+        return Op{[src]() { auto shadow = Effects::drop_shadow(*src, 6, 6, 8, Color(0, 0, 0, 128)); },
+                  px(std::max(1, w / 2), std::max(1, h / 2))};
+    }});
+
+    // --- LayerStack::composite_to ---
+    auto composite_case = [](const std::string& name, int layer_count, BlendMode mode, float opacity,
+                             float scale, bool glass) {
+        return Case{"composite", name, [=](int w, int h) {
+            auto stack = std::make_shared<LayerStack>(w, h);
+            stack->set_background(Color(20, 20, 30));
+            for (int i = 0; i < layer_count; ++i) {
+                bool small = glass && i == layer_count - 1;
+                int lw = small ? std::max(1, w / 2) : w;
+                int lh = small ? std::max(1, h / 2) : h;
+                auto layer = stack->create_layer_from_surface(make_pattern(lw, lh, i == 0 ? 255 : 160));
+                layer->set_blend_mode(i == 0 ? BlendMode::Normal : mode);
+                layer->set_opacity(i == 0 ? 1.0f : opacity);
+                if (i > 0 && scale != 1.0f) layer->set_scale(scale);
+                if (small) {
+                    layer->set_position(w / 4, h / 4);
+                    layer->set_material(Material::frosted_glass(10.0f));
+                }
+            }
+            auto dest = std::make_shared<Surface>(w, h);
+            return Op{[stack, dest]() { stack->composite_to(*dest); }, px(w, h) * layer_count};
+        }};
+    };
+    cases.push_back(composite_case("normal_1_layer", 1, BlendMode::Normal, 1.0f, 1.0f, false));
+    cases.push_back(composite_case("normal_4_layers", 4, BlendMode::Normal, 1.0f, 1.0f, false));
+    cases.push_back(composite_case("opacity_50", 2, BlendMode::Normal, 0.5f, 1.0f, false));
+    cases.push_back(composite_case("scaled_layer", 2, BlendMode::Normal, 1.0f, 0.75f, false));
+    cases.push_back(composite_case("frosted_glass", 2, BlendMode::Normal, 1.0f, 1.0f, true));
+
+    const std::pair<const char*, BlendMode> modes[] = {
+        {"multiply", BlendMode::Multiply}, {"screen", BlendMode::Screen},
+        {"overlay", BlendMode::Overlay}, {"add", BlendMode::Add},
+        {"subtract", BlendMode::Subtract}, {"difference", BlendMode::Difference},
+        {"color_dodge", BlendMode::ColorDodge}, {"color_burn", BlendMode::ColorBurn},
+    };
+    for (const auto& m : modes) {
+        cases.push_back(composite_case(std::string("blend_") + m.first, 2, m.second, 1.0f, 1.0f, false));
+    }
+
+    return cases;
+}
+
+// Run `iterations` calls on each op concurrently; returns wall seconds
+double run_parallel(std::vector<Op>& ops, long long iterations)
+{
+    if (ops.size() == 1) {
+        auto start = bench::Clock::now();
+        for (long long i = 0; i < iterations; ++i) ops[0].run();
+        return bench::seconds_since(start);
+    }
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ops.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (long long i = 0; i < iterations; ++i) ops[t].run();
+        });
+    }
+    while (ready.load() < static_cast<int>(ops.size())) std::this_thread::yield();
+
+    auto start = bench::Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    return bench::seconds_since(start);
+}
+
+Result measure(const Case& c, int w, int h, int thread_count, double min_time)
+{
+    std::vector<Op> ops;
+    for (int t = 0; t < thread_count; ++t) ops.push_back(c.make(w, h));
+
+    // Warm up (fills pools/arenas), then grow the batch until it is long enough to time
+    ops[0].run();
+    long long iterations = 1;
+    double elapsed = 0.0;
+    for (;;) {
+        std::vector<Op> single(1, ops[0]);
+        elapsed = run_parallel(single, iterations);
+        if (elapsed >= min_time * 0.1 || iterations >= (1LL << 30)) break;
+        iterations *= 2;
+    }
+    double per_call = elapsed / iterations;
+    iterations = std::max(1LL, static_cast<long long>(min_time / std::max(per_call, 1e-9)));
+
+    elapsed = run_parallel(ops, iterations);
+
+    Result r;
+    r.category = c.category;
+    r.name = c.name;
+    r.width = w;
+    r.height = h;
+    r.threads = thread_count;
+    r.iterations = iterations;
+    r.ns_per_call = elapsed * 1e9 / iterations;
+    r.mpix_per_s = ops[0].pixels * iterations * thread_count / elapsed / 1e6;
+    return r;
+}
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: palladium_microbench [--filter substr] [--sizes WxH,...] [--threads N,...]\n"
+        "                            [--min-time seconds] [--json path|-] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string json_path;
+    std::vector<std::string> sizes = {"256x256", "1280x720"};
+    std::vector<int> thread_counts = {1};
+    double min_time = 0.25;
+    bool list_only = false;
+
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw > 1) thread_counts.push_back(static_cast<int>(hw));
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) { usage(); std::exit(2); }
+            return argv[++i];
+        };
+        if (arg == "--filter") filter = next();
+        else if (arg == "--sizes") sizes = bench::split(next());
+        else if (arg == "--threads") {
+            thread_counts.clear();
+            for (const auto& t : bench::split(next())) thread_counts.push_back(std::max(1, std::atoi(t.c_str())));
+        }
+        else if (arg == "--min-time") min_time = std::atof(next().c_str());
+        else if (arg == "--json") json_path = next();
+        else if (arg == "--list") list_only = true;
+        else { usage(); return 2; }
+    }
+
+    std::vector<Case> cases = build_cases();
+    std::vector<Result> results;
+
+    for (const Case& c : cases) {
+        std::string full = c.category + "/" + c.name;
+        if (!filter.empty() && full.find(filter) == std::string::npos) continue;
+        if (list_only) {
+            std::printf("%s\n", full.c_str());
+            continue;
+        }
+        for (const std::string& size : sizes) {
+            int w, h;
+            if (!bench::parse_size(size, w, h)) {
+                std::fprintf(stderr, "bad size '%s'\n", size.c_str());
+                return 2;
+            }
+            for (int t : thread_counts) {
+                Result r = measure(c, w, h, t, min_time);
+                std::fprintf(stderr, "%-34s %5dx%-5d t=%-2d %12.0f ns/call %10.1f MP/s\n",
+                             full.c_str(), w, h, t, r.ns_per_call, r.mpix_per_s);
+                results.push_back(r);
+            }
+        }
+    }
+
+    if (list_only) return 0;
+
+    if (!json_path.empty()) {
+        std::vector<std::string> items;
+        for (const Result& r : results) {
+            bench::JsonObject o;
+            o.add("category", r.category).add("name", r.name)
+             .add("width", r.width).add("height", r.height).add("threads", r.threads)
+             .add("iterations", r.iterations).add("ns_per_call", r.ns_per_call)
+             .add("mpix_per_s", r.mpix_per_s);
+            items.push_back(o.str());
+        }
+        bench::JsonObject root;
+        root.add("suite", "palladium_microbench").add("version", 1)
+            .add("min_time", min_time).add("hardware_threads", static_cast<int>(hw))
+            .raw("results", bench::json_array(items));
+        if (!bench::write_text(json_path, root.str() + "\n")) {
+            std::fprintf(stderr, "cannot write %s\n", json_path.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
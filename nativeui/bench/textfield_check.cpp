@@ -0,0 +1,196 @@
+/**
+ * palladium_textfield_check - TextField's incrementally spliced x-offset table
+ *
+ * Runs inserts, deletes and selection replacements (ASCII, kerning pairs and
+ * multi-byte UTF-8) through a TextField and, after every edit, compares the
+ * table TextField::text_edited() spliced against a full re-measure of the
+ * same text. The spliced table is kept across the whole run, so an error
+ * that drifts over many edits is caught too.
+ *
+ * Usage: palladium_textfield_check [font path or name]
+ * Without an argument the first face of the system font index is used. The
+ * exit status is 1 if any edit leaves a table that differs from a rebuild.
+ */
+
+#include "textfield.hpp"
+#include "font_index.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nativeui {
+
+// Reaches into TextField for the edit operations and the table they maintain
+struct TextFieldProbe {
+    TextField& field;
+
+    const std::string& text() const { return field.text_; }
+
+    void build() { field.text_x(0); }
+
+    void place(int cursor) {
+        field.cursor_pos_ = cursor;
+        field.sel_start_ = cursor;
+        field.sel_end_ = cursor;
+    }
+
+    void insert(int at, const std::string& s) {
+        place(at);
+        field.insert_text(s);
+    }
+
+    void backspace(int at) {
+        place(at);
+        field.backspace_char();
+    }
+
+    void backspace_word(int at) {
+        place(at);
+        field.backspace_word();
+    }
+
+    void erase(int at) {
+        place(at);
+        field.delete_char();
+    }
+
+    // Typing over a selection, as TextInput does
+    void replace(int begin, int end, const std::string& s) {
+        field.cursor_pos_ = end;
+        field.sel_start_ = begin;
+        field.sel_end_ = end;
+        field.delete_selection();
+        field.insert_text(s);
+    }
+
+    // Empty if the spliced table matches a full rebuild, else what differs
+    std::string verify() {
+        if (!field.x_offsets_valid_) return "table was rebuilt instead of spliced";
+        std::vector<int> spliced = field.x_offsets_;
+        int spliced_shift = field.x_shift_;
+
+        field.x_offsets_valid_ = false;
+        field.text_x(0);
+        std::string error;
+        if (field.x_shift_ != spliced_shift) {
+            error = "shift " + std::to_string(spliced_shift) + ", rebuilt " + std::to_string(field.x_shift_);
+        } else if (field.x_offsets_.size() != spliced.size()) {
+            error = "size " + std::to_string(spliced.size()) + ", rebuilt " + std::to_string(field.x_offsets_.size());
+        } else {
+            for (size_t i = 0; i < spliced.size(); ++i) {
+                if (spliced[i] != field.x_offsets_[i]) {
+                    error = "byte " + std::to_string(i) + ": " + std::to_string(spliced[i]) +
+                            ", rebuilt " + std::to_string(field.x_offsets_[i]);
+                    break;
+                }
+            }
+        }
+
+        // Carry on from the spliced table
+        field.x_offsets_ = std::move(spliced);
+        field.x_shift_ = spliced_shift;
+        return error;
+    }
+};
+
+} // namespace nativeui
+
+using namespace nativeui;
+
+namespace {
+
+// Start of the code point holding byte i (i itself at a boundary or the end)
+int boundary(const std::string& s, int i)
+{
+    while (i > 0 && i < static_cast<int>(s.size()) && (static_cast<unsigned char>(s[i]) & 0xC0) == 0x80) i--;
+    return i;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string font = argc > 1 ? argv[1] : "";
+    if (font.empty()) {
+        std::vector<FontFace> faces = FontIndex::instance().list();
+        if (faces.empty()) {
+            std::fprintf(stderr, "no fonts found; pass a font path\n");
+            return 2;
+        }
+        font = faces.front().path;
+    }
+    if (!FontCache::get(font, 16)) {
+        std::fprintf(stderr, "cannot open font %s\n", font.c_str());
+        return 2;
+    }
+
+    TextField field(400, 40, TextFieldShape::Rectangle, 0);
+    TypedTextStyle style;
+    style.font = font;
+    style.font_size = 16;
+    field.set_text_style(style);
+    field.set_text("AVAST Wave To");
+    TextFieldProbe probe{field};
+    probe.build();  // The table the edits then splice
+
+    int checks = 0, failures = 0;
+    auto check = [&](const std::string& what) {
+        std::string error = probe.verify();
+        checks++;
+        if (!error.empty()) {
+            failures++;
+            std::fprintf(stderr, "FAIL %-28s \"%s\": %s\n", what.c_str(), probe.text().c_str(), error.c_str());
+        }
+    };
+    auto end = [&]() { return static_cast<int>(probe.text().size()); };
+
+    // Fixed cases: both ends (the ink shift), kerning neighbours, 2- to 4-byte code points
+    probe.insert(0, "W");                   check("insert at start");
+    probe.insert(end(), "ry");              check("insert at end");
+    probe.insert(2, "V");                   check("insert inside kerning pair");
+    probe.insert(5, "\xC3\xA9");            check("insert 2-byte");
+    probe.insert(0, "\xE2\x82\xAC");        check("insert 3-byte at start");
+    probe.insert(end(), "\xF0\x9F\x98\x80"); check("insert 4-byte at end");
+    probe.insert(8, "caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC");  check("insert mixed");
+    probe.backspace(end());                 check("backspace 4-byte");
+    probe.backspace(3);                     check("backspace 3-byte");
+    probe.backspace(1);                     check("backspace first");
+    probe.erase(0);                         check("delete first");
+    probe.erase(boundary(probe.text(), 6)); check("delete inside");
+    probe.backspace_word(end());            check("backspace word");
+    probe.replace(1, 4, "To");              check("replace with kerning pair");
+    probe.replace(0, boundary(probe.text(), 5), "\xC3\x85\xC3\x85");  check("replace start with 2-byte");
+    probe.replace(2, end(), "");            check("replace to empty tail");
+    probe.replace(0, end(), "AV");          check("replace everything");
+
+    // Random edits, with a seeded engine whose raw output is the same on every platform
+    std::mt19937 rng(1234);
+    const std::vector<std::string> pieces = {
+        "a", "AV", "To", "W", " ", "yy", "\xC3\xA9", "\xC3\xB1o", "\xE2\x82\xAC", "\xE6\x97\xA5",
+        "\xF0\x9F\x98\x80", "Lorem ipsum", "fi", "\"'",
+    };
+    auto position = [&]() { return boundary(probe.text(), static_cast<int>(rng() % (probe.text().size() + 1))); };
+    for (int i = 0; i < 2000; ++i) {
+        const std::string& piece = pieces[rng() % pieces.size()];
+        switch (rng() % 5) {
+            case 0: case 1: probe.insert(position(), piece); check("random insert"); break;
+            case 2: probe.backspace(position()); check("random backspace"); break;
+            case 3: probe.erase(position()); check("random delete"); break;
+            default: {
+                int a = position(), b = position();
+                probe.replace(std::min(a, b), std::max(a, b), piece);
+                check("random replace");
+            }
+        }
+        if (probe.text().size() > 400) {
+            probe.replace(0, boundary(probe.text(), 200), "");
+            check("trim");
+        }
+    }
+
+    std::fprintf(stderr, "%s: %d edits, %d failed\n", font.c_str(), checks, failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -41,12 +41,12 @@ class BuildExt(build_ext):
     
     c_opts = {
         'msvc': ['/EHsc', '/std:c++17', '/O2', '/DNDEBUG'],
-        'unix': ['-std=c++17', '-O3', '-fvisibility=hidden'],
+        'unix': ['-std=c++17', '-O3', '-fvisibility=hidden', '-pthread'],
     }
     
     l_opts = {
         'msvc': [],
-        'unix': [],
+        'unix': ['-pthread'],  # ThreadPool
     }
     
     def build_extensions(self):
@@ -87,6 +87,23 @@ ext_modules = [
             'src/slider.cpp',
             'src/gpu_text.cpp',
             'src/cpu_text.cpp',
+            'src/profiler.cpp',
+            'src/latency.cpp',
+            'src/memory_tracker.cpp',
+            'src/buffer_pool.cpp',
+            'src/scratch_arena.cpp',
+            'src/event_record.cpp',
+            'src/thread_pool.cpp',
+            'src/batch.cpp',
+            'src/display_list.cpp',
+            'src/particles.cpp',
+            'src/atlas.cpp',
+            'src/glyph_atlas.cpp',
+            'src/text_cache.cpp',
+            'src/font_index.cpp',
+            'src/text_rasterizer.cpp',
+            'src/sdf_text.cpp',
+            'src/coverage_mask.cpp',
         ],
         include_dirs=[
             get_pybind_include(),
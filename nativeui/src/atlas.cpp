@@ -0,0 +1,232 @@
+#include "atlas.hpp"
+#include "memory_tracker.hpp"
+#include "profiler.hpp"
+#include "rect_packer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace nativeui {
+
+struct Atlas::State {
+    struct Page {
+        std::shared_ptr<Surface> surface;
+        GuillotinePacker packer;
+    };
+    struct Region {
+        size_t page;
+        PixelRect rect;
+    };
+
+    int page_width;
+    int page_height;
+    std::vector<Page> pages;
+    std::unordered_map<Surface*, Region> regions;  // Live views (not owned)
+    std::mutex mutex;
+
+    size_t add_page(int width, int height) {
+        AllocationTag tag("Atlas page");
+        pages.push_back(Page{std::make_shared<Surface>(width, height), GuillotinePacker(width, height)});
+        return pages.size() - 1;
+    }
+
+    // First page with room, or a new one (as large as the region if needed)
+    Region place(int width, int height) {
+        Region region;
+        for (size_t p = 0; p < pages.size(); ++p) {
+            if (pages[p].packer.insert(width, height, region.rect)) {
+                region.page = p;
+                return region;
+            }
+        }
+        region.page = add_page(std::max(page_width, width), std::max(page_height, height));
+        pages[region.page].packer.insert(width, height, region.rect);
+        return region;
+    }
+
+    void release(const Region& region) {
+        pages[region.page].packer.release(region.rect);
+    }
+
+    uint8_t* address(const Region& region) {
+        Surface& page = *pages[region.page].surface;
+        return page.get_data() + region.rect.y0 * page.get_pitch() + static_cast<size_t>(region.rect.x0) * 4;
+    }
+};
+
+Atlas::Atlas(int page_width, int page_height)
+    : state_(std::make_shared<State>())
+{
+    if (page_width <= 0 || page_height <= 0) {
+        throw std::invalid_argument("Atlas page dimensions must be positive");
+    }
+    state_->page_width = page_width;
+    state_->page_height = page_height;
+}
+
+Atlas::~Atlas() = default;
+
+void Atlas::retarget(Surface& view, uint8_t* data, size_t pitch, std::shared_ptr<void> owner)
+{
+    view.data_ = data;
+    view.pitch_ = pitch;
+    view.external_ = std::move(owner);
+}
+
+SurfaceView Atlas::allocate(int width, int height)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Atlas region dimensions must be positive");
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    State& st = *state_;
+    State::Region region = st.place(width, height);
+
+    // The region is cleared: it may hold pixels of a freed view
+    const auto& page = st.pages[region.page].surface;
+    uint8_t* data = st.address(region);
+    for (int y = 0; y < height; ++y) std::memset(data + y * page->get_pitch(), 0, static_cast<size_t>(width) * 4);
+
+    // Dropping the last reference returns the region (if the atlas still exists)
+    std::weak_ptr<State> weak = state_;
+    SurfaceView view(new Surface(data, width, height, page, page->get_pitch()), [weak](Surface* s) {
+        if (auto st = weak.lock()) {
+            std::lock_guard<std::mutex> lock(st->mutex);
+            auto it = st->regions.find(s);
+            if (it != st->regions.end()) {
+                st->release(it->second);
+                st->regions.erase(it);
+            }
+        }
+        delete s;
+    });
+    st.regions.emplace(view.get(), region);
+    return view;
+}
+
+SurfaceView Atlas::add(const Surface& source)
+{
+    SurfaceView view = allocate(source.get_width(), source.get_height());
+    size_t row = static_cast<size_t>(source.get_width()) * 4;
+    for (int y = 0; y < source.get_height(); ++y) {
+        std::memcpy(view->get_data() + y * view->get_pitch(), source.get_data() + y * source.get_pitch(), row);
+    }
+    return view;
+}
+
+void Atlas::free(const SurfaceView& view)
+{
+    if (!view) return;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto it = state_->regions.find(view.get());
+    if (it == state_->regions.end()) {
+        throw std::invalid_argument("Atlas::free: view does not belong to this atlas");
+    }
+    state_->release(it->second);
+    state_->regions.erase(it);
+}
+
+bool Atlas::owns(const SurfaceView& view) const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return view && state_->regions.count(view.get()) != 0;
+}
+
+void Atlas::defragment()
+{
+    ProfileScope scope("Atlas::defragment");
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    // Held throughout so no view is exported between the check and the move
+    std::lock_guard<std::mutex> pins(Surface::pin_mutex());
+    State& st = *state_;
+
+    // NumPy arrays point into the pages of pinned views; those pages stay
+    std::vector<bool> keep(st.pages.size(), false);
+    for (const auto& entry : st.regions) {
+        if (entry.first->pins_ > 0) keep[entry.second.page] = true;
+    }
+
+    // Tallest first packs guillotine pages tightest
+    std::vector<Surface*> views;
+    views.reserve(st.regions.size());
+    for (const auto& entry : st.regions) {
+        if (!keep[entry.second.page]) views.push_back(entry.first);
+    }
+    std::sort(views.begin(), views.end(), [&](Surface* a, Surface* b) {
+        if (a->get_height() != b->get_height()) return a->get_height() > b->get_height();
+        if (a->get_width() != b->get_width()) return a->get_width() > b->get_width();
+        // Current position breaks ties, so the result doesn't depend on hashing
+        const State::Region& ra = st.regions[a];
+        const State::Region& rb = st.regions[b];
+        return std::tie(ra.page, ra.rect.y0, ra.rect.x0) < std::tie(rb.page, rb.rect.y0, rb.rect.x0);
+    });
+
+    // Repack into the kept pages' free space and fresh pages; the old ones
+    // live on until no view uses them
+    std::vector<State::Page> old_pages;
+    old_pages.swap(st.pages);
+    std::vector<size_t> kept_index(old_pages.size());
+    for (size_t p = 0; p < old_pages.size(); ++p) {
+        if (!keep[p]) continue;
+        kept_index[p] = st.pages.size();
+        st.pages.push_back(std::move(old_pages[p]));
+    }
+    for (auto& entry : st.regions) {
+        if (keep[entry.second.page]) entry.second.page = kept_index[entry.second.page];
+    }
+
+    for (Surface* view : views) {
+        State::Region& region = st.regions[view];
+        const Surface& old_page = *old_pages[region.page].surface;
+        const uint8_t* src = old_page.get_data() + region.rect.y0 * old_page.get_pitch() +
+                             static_cast<size_t>(region.rect.x0) * 4;
+
+        State::Region moved = st.place(view->get_width(), view->get_height());
+        const auto& page = st.pages[moved.page].surface;
+        uint8_t* dst = st.address(moved);
+        for (int y = 0; y < view->get_height(); ++y) {
+            std::memcpy(dst + y * page->get_pitch(), src + y * old_page.get_pitch(),
+                        static_cast<size_t>(view->get_width()) * 4);
+        }
+        retarget(*view, dst, page->get_pitch(), page);
+        region = moved;
+    }
+}
+
+AtlasStats Atlas::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    AtlasStats stats;
+    stats.pages = state_->pages.size();
+    stats.regions = state_->regions.size();
+    for (const auto& page : state_->pages) {
+        stats.page_pixels += static_cast<size_t>(page.surface->get_width()) * page.surface->get_height();
+        stats.free_rects += page.packer.free_count();
+    }
+    for (const auto& entry : state_->regions) {
+        stats.used_pixels += static_cast<size_t>(entry.second.rect.width()) * entry.second.rect.height();
+    }
+    return stats;
+}
+
+size_t Atlas::get_page_count() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->pages.size();
+}
+
+std::shared_ptr<Surface> Atlas::get_page(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (index >= state_->pages.size()) throw std::out_of_range("Atlas: no such page");
+    return state_->pages[index].surface;
+}
+
+int Atlas::get_page_width() const { return state_->page_width; }
+int Atlas::get_page_height() const { return state_->page_height; }
+
+} // namespace nativeui
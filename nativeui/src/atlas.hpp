@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "surface.hpp"
+
+namespace nativeui {
+
+/**
+ * SurfaceView - A region of an atlas page
+ *
+ * An ordinary Surface whose rows are the page's rows (see Surface::get_pitch),
+ * so drawing, blits, effects, layers and the compositor take it directly.
+ * While a view is pinned (exported to NumPy, see Surface::pin) its page stays
+ * in place: defragment() leaves that page and every region on it untouched,
+ * so an exported array never outlives the memory it points into.
+ */
+using SurfaceView = std::shared_ptr<Surface>;
+
+struct AtlasStats {
+    size_t pages = 0;
+    size_t regions = 0;          // Live allocations
+    size_t used_pixels = 0;      // Pixels in live allocations
+    size_t page_pixels = 0;      // Pixels in all pages
+    size_t free_rects = 0;       // Free list length (fragmentation)
+};
+
+/**
+ * Atlas - Packs many small surfaces into a few large pages
+ *
+ * Pages are packed with the guillotine method: each page keeps a list of free
+ * rectangles, an allocation takes the best short-side fit and the leftover
+ * is split along the shorter axis. A region returns to its page, merged with
+ * free neighbours, when its last view reference is dropped (or on free()).
+ * defragment() repacks the live regions tallest first into as few pages as
+ * possible and moves their pixels, updating the views in place so handles stay
+ * valid. Pages holding a pinned view are kept as they are. Regions larger than a page get a page of their own. Views keep their
+ * page memory alive, so they may outlive the atlas.
+ *
+ * Thread-safe for allocate/free; drawing into views while defragment() runs
+ * is not.
+ */
+class Atlas {
+public:
+    explicit Atlas(int page_width = 1024, int page_height = 1024);
+    ~Atlas();
+    Atlas(const Atlas&) = delete;
+    Atlas& operator=(const Atlas&) = delete;
+
+    // New transparent region
+    SurfaceView allocate(int width, int height);
+    // New region holding a copy of `source`
+    SurfaceView add(const Surface& source);
+    // Return a region now; the view must not be drawn to afterwards
+    void free(const SurfaceView& view);
+
+    bool owns(const SurfaceView& view) const;
+    void defragment();
+
+    AtlasStats get_stats() const;
+    size_t get_page_count() const;
+    std::shared_ptr<Surface> get_page(size_t index) const;
+    int get_page_width() const;
+    int get_page_height() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+
+    // Point a view at new memory (defragment)
+    static void retarget(Surface& view, uint8_t* data, size_t pitch, std::shared_ptr<void> owner);
+};
+
+} // namespace nativeui
@@ -0,0 +1,346 @@
+#include "batch.hpp"
+#include "profiler.hpp"
+#include "surface_raster.hpp"
+#include "thread_pool.hpp"
+#include "tile_bins.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace nativeui {
+
+namespace {
+
+inline Color color_at(const Strided<uint8_t>& colors, size_t i)
+{
+    const uint8_t* c = colors[i];
+    return Color(c[0], c[1], c[2], c[3]);
+}
+
+// Bin items by bounds_of(i), then run draw(i, tile) for every tile in parallel
+template <typename BoundsFn, typename Draw>
+void run_batch(Surface& surface, size_t count, BoundsFn&& bounds_of, Draw&& draw)
+{
+    if (count == 0) return;
+
+    const int T = BatchDraw::kTileSize;
+    PixelRect area{0, 0, surface.get_width(), surface.get_height()};
+
+    // Binning costs about as much as drawing a small item, so it only pays
+    // off when the tiles can be drawn in parallel
+    if (ThreadPool::instance().get_threads() == 1 || (area.x1 <= T && area.y1 <= T)) {
+        for (size_t i = 0; i < count; ++i) draw(static_cast<uint32_t>(i), area);
+        return;
+    }
+
+    ScratchScope scratch;
+    PixelRect* bounds = scratch.alloc<PixelRect>(count);
+    for (size_t i = 0; i < count; ++i) bounds[i] = bounds_of(i);
+    TileBins bins = TileBins::build(scratch, area, T, bounds, count);
+
+    ThreadPool::instance().parallel_for(0, bins.count(), 1, [&](int t0, int t1) {
+        for (int t = t0; t < t1; ++t) {
+            PixelRect tile = bins.tile_rect(t);
+            for (uint32_t k = bins.offsets[t]; k < bins.offsets[t + 1]; ++k) {
+                draw(bins.items[k], tile);
+            }
+        }
+    });
+}
+
+
+using raster::blend_over;
+
+// Coverage of a small AA circle, the same for every integer center: one
+// span of alphas per row
+struct CoverageStamp {
+    struct Row { int dy, dx0; std::vector<float> alpha; };
+    std::vector<Row> rows;
+};
+
+// AA circles up to this radius draw from precomputed stamps (particles, markers)
+const int kMaxStampRadius = 8;
+
+// Filled circles; hard edges replace pixels unless `blend`
+void draw_circles(Surface& surface, const int32_t* xy, Strided<int32_t> radii,
+                  Strided<uint8_t> colors, size_t count, bool blend)
+{
+    bool aa = AntiAliasingSettings::instance().is_enabled();
+    int64_t pad = aa ? 1 : 0;  // AA edges reach one pixel past the radius
+
+    static const std::vector<CoverageStamp> stamps = [] {
+        std::vector<CoverageStamp> all(kMaxStampRadius + 1);
+        for (int r = 0; r <= kMaxStampRadius; ++r) {
+            raster::filled_circle_aa(0, 0, r, -r - 1, -r - 1, r + 2, r + 2, [&](int x, int y, float alpha) {
+                auto& rows = all[r].rows;
+                if (rows.empty() || rows.back().dy != y) rows.push_back({y, x, {}});
+                rows.back().alpha.resize(x - rows.back().dx0 + 1, 0.0f);
+                rows.back().alpha.back() = alpha;
+            });
+        }
+        return all;
+    }();
+
+    run_batch(surface, count, [&](size_t i) {
+        int64_t cx = xy[i * 2], cy = xy[i * 2 + 1], r = *radii[i];
+        return PixelRect::from_bounds(cx - r - pad, cy - r - pad, cx + r + pad + 1, cy + r + pad + 1);
+    }, [&](uint32_t i, const PixelRect& tile) {
+        int cx = xy[i * 2], cy = xy[i * 2 + 1], r = *radii[i];
+        Color color = color_at(colors, i);
+        if (aa && r >= 0 && r <= kMaxStampRadius) {
+            // Surface::plot_aa_pixel on raw pixels
+            uint8_t* data = surface.get_data();
+            size_t pitch = surface.get_pitch();
+            for (const auto& row : stamps[r].rows) {
+                int y = cy + row.dy;
+                if (y < tile.y0 || y >= tile.y1) continue;
+                int x0 = cx + row.dx0, n = static_cast<int>(row.alpha.size());
+                int k0 = std::max(0, tile.x0 - x0), k1 = std::min(n, tile.x1 - x0);
+                uint8_t* p = data + y * pitch + static_cast<size_t>(x0) * 4;
+                for (int k = k0; k < k1; ++k) {
+                    blend_over(p + k * 4, color.r, color.g, color.b, static_cast<uint8_t>(color.a * row.alpha[k]));
+                }
+            }
+        } else if (aa) {
+            raster::filled_circle_aa(cx, cy, r, tile.x0, tile.y0, tile.x1, tile.y1,
+                                     [&](int x, int y, float alpha) { surface.plot_aa_pixel(x, y, color, alpha); });
+        } else if (blend) {
+            raster::filled_circle(cx, cy, r, tile.x0, tile.y0, tile.x1, tile.y1,
+                                  [&](int x, int y) { surface.blend_pixel(x, y, color); });
+        } else {
+            raster::filled_circle(cx, cy, r, tile.x0, tile.y0, tile.x1, tile.y1,
+                                  [&](int x, int y) { surface.set_pixel(x, y, color); });
+        }
+    });
+}
+
+// Tint and opacity applied to every source pixel of one sprite instance
+struct SpriteShade {
+    int r, g, b, a;
+    float alpha;
+    bool identity;
+
+    SpriteShade(const uint8_t* tint, float opacity)
+        : r(tint[0]), g(tint[1]), b(tint[2]), a(tint[3]), alpha(std::clamp(opacity, 0.0f, 1.0f)),
+          identity(r == 255 && g == 255 && b == 255 && a == 255 && alpha >= 1.0f) {}
+
+    void apply(const uint8_t* s, uint8_t* d) const {
+        if (identity) {
+            blend_over(d, s[0], s[1], s[2], s[3]);
+            return;
+        }
+        // Same rounding as Surface::blit_alpha when the tint is white
+        blend_over(d, static_cast<uint8_t>(s[0] * r / 255), static_cast<uint8_t>(s[1] * g / 255),
+                   static_cast<uint8_t>(s[2] * b / 255), static_cast<uint8_t>((s[3] * a / 255) * alpha));
+    }
+};
+
+// Placement of one sprite instance in target pixels
+struct SpriteGeometry {
+    int rx, ry, rw, rh;        // Source rect
+    float cx, cy;              // Center on the target
+    float scale, cos_r, sin_r;
+    bool axis_aligned;         // Unit scale, no rotation, whole-pixel position
+    PixelRect bounds;          // Target pixels the instance may cover
+};
+
+SpriteGeometry sprite_geometry(const SpriteInstances& in, size_t i)
+{
+    SpriteGeometry g;
+    const int32_t* rect = in.rects[i];
+    g.rx = rect[0]; g.ry = rect[1]; g.rw = rect[2]; g.rh = rect[3];
+    float x = in.xy[i * 2], y = in.xy[i * 2 + 1];
+    float rotation = *in.rotation[i];
+    g.scale = *in.scale[i];
+    g.cos_r = std::cos(rotation);
+    g.sin_r = std::sin(rotation);
+    g.axis_aligned = rotation == 0.0f && g.scale == 1.0f && x == std::floor(x) && y == std::floor(y);
+
+    float half_w = g.rw * std::fabs(g.scale) * 0.5f;
+    float half_h = g.rh * std::fabs(g.scale) * 0.5f;
+    g.cx = x + half_w;
+    g.cy = y + half_h;
+    float ex = std::fabs(g.cos_r) * half_w + std::fabs(g.sin_r) * half_h;
+    float ey = std::fabs(g.sin_r) * half_w + std::fabs(g.cos_r) * half_h;
+    if (g.rw <= 0 || g.rh <= 0 || g.scale == 0.0f || !std::isfinite(ex + ey + g.cx + g.cy)) {
+        g.bounds = PixelRect{};
+    } else if (g.axis_aligned) {
+        g.bounds = PixelRect::from_bounds(int64_t(x), int64_t(y), int64_t(x) + g.rw, int64_t(y) + g.rh);
+    } else {
+        g.bounds = PixelRect::from_bounds(static_cast<int64_t>(std::floor(g.cx - ex)),
+                                          static_cast<int64_t>(std::floor(g.cy - ey)),
+                                          static_cast<int64_t>(std::ceil(g.cx + ex)) + 1,
+                                          static_cast<int64_t>(std::ceil(g.cy + ey)) + 1);
+    }
+    return g;
+}
+
+void draw_sprite(Surface& target, const Surface& source, const SpriteGeometry& g,
+                 const SpriteShade& shade, const PixelRect& tile)
+{
+    PixelRect area = g.bounds.intersect(tile);
+    if (area.empty()) return;
+    uint8_t* data = target.get_data();
+    size_t pitch = target.get_pitch();
+    const uint8_t* src = source.get_data();
+    size_t src_pitch = source.get_pitch();
+
+    if (g.axis_aligned) {
+        // Row copy: bounds start at the sprite's top-left
+        int sx = g.rx + (area.x0 - g.bounds.x0);
+        int sy = g.ry + (area.y0 - g.bounds.y0);
+        for (int y = area.y0; y < area.y1; ++y, ++sy) {
+            const uint8_t* s = src + sy * src_pitch + static_cast<size_t>(sx) * 4;
+            uint8_t* d = data + y * pitch + static_cast<size_t>(area.x0) * 4;
+            for (int x = area.x0; x < area.x1; ++x, s += 4, d += 4) shade.apply(s, d);
+        }
+        return;
+    }
+
+    // Inverse-map pixel centers into the source rect, nearest sample. Rows
+    // are stepped from the instance's own left edge so every tile samples alike.
+    float inv = 1.0f / g.scale;
+    float du = g.cos_r * inv, dv = -g.sin_r * inv;
+    for (int y = area.y0; y < area.y1; ++y) {
+        float fx = g.bounds.x0 + 0.5f - g.cx;
+        float fy = y + 0.5f - g.cy;
+        float u0 = (fx * g.cos_r + fy * g.sin_r) * inv + g.rw * 0.5f;
+        float v0 = (fy * g.cos_r - fx * g.sin_r) * inv + g.rh * 0.5f;
+        uint8_t* d = data + y * pitch + static_cast<size_t>(area.x0) * 4;
+        for (int k = area.x0 - g.bounds.x0; k < area.x1 - g.bounds.x0; ++k, d += 4) {
+            int u = static_cast<int>(std::floor(u0 + k * du));
+            int v = static_cast<int>(std::floor(v0 + k * dv));
+            if (static_cast<unsigned>(u) >= static_cast<unsigned>(g.rw) ||
+                static_cast<unsigned>(v) >= static_cast<unsigned>(g.rh)) continue;
+            shade.apply(src + (g.ry + v) * src_pitch + static_cast<size_t>(g.rx + u) * 4, d);
+        }
+    }
+}
+
+} // namespace
+
+void BatchDraw::fill_circles(Surface& surface, const int32_t* xy, Strided<int32_t> radii,
+                             Strided<uint8_t> colors, size_t count)
+{
+    ProfileScope scope("BatchDraw::fill_circles");
+    draw_circles(surface, xy, radii, colors, count, false);
+}
+
+void BatchDraw::blend_circles(Surface& surface, const int32_t* xy, Strided<int32_t> radii,
+                              Strided<uint8_t> colors, size_t count)
+{
+    ProfileScope scope("BatchDraw::blend_circles");
+    draw_circles(surface, xy, radii, colors, count, true);
+}
+
+void BatchDraw::draw_lines(Surface& surface, const int32_t* segments, Strided<uint8_t> colors, size_t count)
+{
+    ProfileScope scope("BatchDraw::draw_lines");
+    bool aa = AntiAliasingSettings::instance().is_enabled();
+    int64_t pad = aa ? 1 : 0;  // Wu lines cover the pixel below/right of the ideal line
+
+    run_batch(surface, count, [&](size_t i) {
+        const int32_t* s = segments + i * 4;
+        return PixelRect::from_bounds(std::min(s[0], s[2]) - pad, std::min(s[1], s[3]) - pad,
+                                      int64_t(std::max(s[0], s[2])) + pad + 1, int64_t(std::max(s[1], s[3])) + pad + 1);
+    }, [&](uint32_t i, const PixelRect& tile) {
+        // Each tile walks only the steps of the line inside it
+        const int32_t* s = segments + i * 4;
+        Color color = color_at(colors, i);
+        if (aa) {
+            raster::line_aa(s[0], s[1], s[2], s[3], tile.x0, tile.y0, tile.x1, tile.y1,
+                            [&](int x, int y, float brightness) { surface.plot_aa_pixel(x, y, color, brightness); });
+        } else {
+            raster::line(s[0], s[1], s[2], s[3], tile.x0, tile.y0, tile.x1, tile.y1,
+                         [&](int x, int y) { surface.set_pixel(x, y, color); });
+        }
+    });
+}
+
+void BatchDraw::fill_rects(Surface& surface, const int32_t* rects, Strided<uint8_t> colors, size_t count)
+{
+    ProfileScope scope("BatchDraw::fill_rects");
+    uint8_t* data = surface.get_data();
+    size_t pitch = surface.get_pitch();
+
+    run_batch(surface, count, [&](size_t i) {
+        const int32_t* r = rects + i * 4;
+        return PixelRect::from_bounds(r[0], r[1], int64_t(r[0]) + r[2], int64_t(r[1]) + r[3]);
+    }, [&](uint32_t i, const PixelRect& tile) {
+        const int32_t* r = rects + i * 4;
+        int x0 = std::max(tile.x0, r[0]);
+        int y0 = std::max(tile.y0, r[1]);
+        int x1 = static_cast<int>(std::min<int64_t>(tile.x1, int64_t(r[0]) + r[2]));
+        int y1 = static_cast<int>(std::min<int64_t>(tile.y1, int64_t(r[1]) + r[3]));
+        const uint8_t* rgba = colors[i];
+        for (int y = y0; y < y1; ++y) {
+            uint8_t* p = data + y * pitch + static_cast<size_t>(x0) * 4;
+            for (int x = x0; x < x1; ++x, p += 4) std::memcpy(p, rgba, 4);
+        }
+    });
+}
+
+void BatchDraw::set_pixels(Surface& surface, const int32_t* xy, Strided<uint8_t> colors, size_t count)
+{
+    ProfileScope scope("BatchDraw::set_pixels");
+    uint8_t* data = surface.get_data();
+    size_t pitch = surface.get_pitch();
+
+    run_batch(surface, count, [&](size_t i) {
+        int64_t x = xy[i * 2], y = xy[i * 2 + 1];
+        return PixelRect::from_bounds(x, y, x + 1, y + 1);
+    }, [&](uint32_t i, const PixelRect& tile) {
+        int x = xy[i * 2], y = xy[i * 2 + 1];
+        if (tile.contains(x, y)) std::memcpy(data + y * pitch + static_cast<size_t>(x) * 4, colors[i], 4);
+    });
+}
+
+// ============ SpriteBatch ============
+
+SpriteBatch::SpriteBatch(std::shared_ptr<Surface> source)
+{
+    set_source(std::move(source));
+}
+
+void SpriteBatch::set_source(std::shared_ptr<Surface> source)
+{
+    if (!source) throw std::invalid_argument("SpriteBatch: source surface is null");
+    source_ = std::move(source);
+}
+
+void SpriteBatch::draw(Surface& target, const SpriteInstances& instances) const
+{
+    ProfileScope scope("SpriteBatch::draw");
+    if (instances.count == 0) return;
+    if (!instances.xy) throw std::invalid_argument("SpriteBatch::draw: positions are required");
+    if (&target == source_.get()) throw std::invalid_argument("SpriteBatch::draw: target is the source surface");
+
+    // Fill in defaults for attributes that were not given
+    static const float kOne = 1.0f, kZero = 0.0f;
+    static const uint8_t kWhite[4] = {255, 255, 255, 255};
+    const int32_t whole[4] = {0, 0, source_->get_width(), source_->get_height()};
+    SpriteInstances in = instances;
+    if (!in.scale.data) in.scale = Strided<float>(&kOne, 0);
+    if (!in.rotation.data) in.rotation = Strided<float>(&kZero, 0);
+    if (!in.tint.data) in.tint = Strided<uint8_t>(kWhite, 0);
+    if (!in.alpha.data) in.alpha = Strided<float>(&kOne, 0);
+    if (!in.rects.data) in.rects = Strided<int32_t>(whole, 0);
+
+    PixelRect src_area{0, 0, source_->get_width(), source_->get_height()};
+    for (size_t i = 0; i < (in.rects.stride ? in.count : 1); ++i) {
+        const int32_t* r = in.rects[i];
+        if (!src_area.contains(PixelRect::from_bounds(r[0], r[1], int64_t(r[0]) + r[2], int64_t(r[1]) + r[3]))) {
+            throw std::invalid_argument("SpriteBatch::draw: source rect outside the source surface");
+        }
+    }
+
+    const Surface& source = *source_;
+    run_batch(target, in.count, [&](size_t i) {
+        return sprite_geometry(in, i).bounds;
+    }, [&](uint32_t i, const PixelRect& tile) {
+        draw_sprite(target, source, sprite_geometry(in, i), SpriteShade(in.tint[i], *in.alpha[i]), tile);
+    });
+}
+
+} // namespace nativeui
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "surface.hpp"
+
+namespace nativeui {
+
+/**
+ * Strided - Per-item attribute array; stride 0 shares one value between all items
+ */
+template <typename T>
+struct Strided {
+    const T* data = nullptr;
+    size_t stride = 0;
+
+    Strided() = default;
+    Strided(const T* data, size_t stride) : data(data), stride(stride) {}
+
+    const T* operator[](size_t i) const { return data + i * stride; }
+};
+
+/**
+ * BatchDraw - Draw thousands of primitives in one call
+ *
+ * With more than one pool thread, items are binned into square tiles in
+ * submission order and the tiles are drawn in parallel on the ThreadPool,
+ * every item clipped to its tile. Each pixel still sees its items in
+ * submission order, so the result is the same as issuing the single Surface
+ * calls one by one (AA follows AntiAliasingSettings). Colors are RGBA bytes.
+ */
+class BatchDraw {
+public:
+    static const int kTileSize = 64;
+
+    // xy: count * (cx, cy); radii: one per item, or shared with stride 0
+    static void fill_circles(Surface& surface, const int32_t* xy, Strided<int32_t> radii,
+                             Strided<uint8_t> colors, size_t count);
+
+    // Like fill_circles, but always alpha-blends (hard edges when AA is off)
+    static void blend_circles(Surface& surface, const int32_t* xy, Strided<int32_t> radii,
+                              Strided<uint8_t> colors, size_t count);
+
+    // segments: count * (x1, y1, x2, y2)
+    static void draw_lines(Surface& surface, const int32_t* segments, Strided<uint8_t> colors, size_t count);
+
+    // rects: count * (x, y, w, h); replaces pixels like Surface::fill_rect
+    static void fill_rects(Surface& surface, const int32_t* rects, Strided<uint8_t> colors, size_t count);
+
+    // xy: count * (x, y); replaces pixels like Surface::set_pixel
+    static void set_pixels(Surface& surface, const int32_t* xy, Strided<uint8_t> colors, size_t count);
+};
+
+/**
+ * SpriteInstances - Per-instance arrays for SpriteBatch::draw
+ *
+ * Attributes left with null data take their default (scale 1, no rotation,
+ * white tint, alpha 1, the whole source).
+ */
+struct SpriteInstances {
+    const float* xy = nullptr;     // count * (x, y): top-left of the unrotated sprite
+    Strided<float> scale;          // Uniform scale; negative flips
+    Strided<float> rotation;       // Radians, clockwise on screen, about the sprite center
+    Strided<uint8_t> tint;         // RGBA multiplied into the source pixels
+    Strided<float> alpha;          // Opacity 0..1
+    Strided<int32_t> rects;        // Source rect (x, y, w, h) in an atlas
+    size_t count = 0;
+};
+
+/**
+ * SpriteBatch - Draw many instances of one surface (or atlas) in one call
+ *
+ * Instances are binned per tile like BatchDraw and blended in order with the
+ * same math as Surface::blit_alpha. Untransformed instances (scale 1, no
+ * rotation, whole-pixel position) take a row-copy path and match
+ * Surface::blit exactly; the rest sample the source nearest-neighbour.
+ */
+class SpriteBatch {
+public:
+    explicit SpriteBatch(std::shared_ptr<Surface> source);
+
+    void set_source(std::shared_ptr<Surface> source);
+    std::shared_ptr<Surface> get_source() const { return source_; }
+
+    void draw(Surface& target, const SpriteInstances& instances) const;
+
+private:
+    std::shared_ptr<Surface> source_;
+};
+
+} // namespace nativeui
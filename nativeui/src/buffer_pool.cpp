@@ -0,0 +1,118 @@
+#include "buffer_pool.hpp"
+#include "memory_tracker.hpp"
+
+namespace nativeui {
+
+static const size_t MIN_CLASS_BYTES = 4096;
+
+BufferPool::BufferPool()
+    : pooled_bytes_(0)
+    , pooled_buffers_(0)
+    , max_pooled_bytes_(64 * 1024 * 1024)
+    , hits_(0)
+    , misses_(0)
+{
+    // Idle buffers are the cheapest memory to give back
+    MemoryTracker::instance().add_evictor([this](MemoryPressure pressure) {
+        std::vector<std::vector<uint8_t>> victims;  // Freed after the lock is dropped
+        std::lock_guard<std::mutex> lock(mutex_);
+        trim_locked(pressure == MemoryPressure::Hard ? 0 : pooled_bytes_ / 2, victims);
+    });
+}
+
+size_t BufferPool::size_class(size_t bytes)
+{
+    if (bytes <= MIN_CLASS_BYTES) return MIN_CLASS_BYTES;
+
+    // Quarter steps between powers of two: 2^k, 1.25*2^k, 1.5*2^k, 1.75*2^k
+    size_t high = 1;
+    while ((high << 1) < bytes) high <<= 1;
+    size_t step = high / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+std::vector<uint8_t> BufferPool::acquire(size_t bytes)
+{
+    size_t cls = size_class(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = buckets_.find(cls);
+        if (it != buckets_.end() && !it->second.empty()) {
+            std::vector<uint8_t> buffer = std::move(it->second.back());
+            it->second.pop_back();
+            pooled_bytes_ -= buffer.capacity();
+            pooled_buffers_--;
+            hits_++;
+            buffer.clear();
+            return buffer;
+        }
+        misses_++;
+    }
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(cls);
+    return buffer;
+}
+
+void BufferPool::release(std::vector<uint8_t>&& buffer) noexcept
+{
+    size_t cap = buffer.capacity();
+    if (cap < MIN_CLASS_BYTES || size_class(cap) != cap) return;  // Not ours; let it free
+
+    // Pooling needs a map node or bucket growth; if that can't be had the
+    // buffer is simply left to the caller to free
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pooled_bytes_ + cap > max_pooled_bytes_) return;
+
+        buckets_[cap].push_back(std::move(buffer));
+        pooled_bytes_ += cap;
+        pooled_buffers_++;
+    } catch (...) {
+    }
+}
+
+void BufferPool::trim(size_t keep_bytes)
+{
+    // Move victims out so they are freed after the lock is dropped
+    std::vector<std::vector<uint8_t>> victims;
+    std::lock_guard<std::mutex> lock(mutex_);
+    trim_locked(keep_bytes, victims);
+}
+
+void BufferPool::trim_locked(size_t keep_bytes, std::vector<std::vector<uint8_t>>& victims)
+{
+    // Largest classes first: they free the most per buffer
+    for (auto it = buckets_.rbegin(); it != buckets_.rend() && pooled_bytes_ > keep_bytes; ++it) {
+        auto& bucket = it->second;
+        while (!bucket.empty() && pooled_bytes_ > keep_bytes) {
+            pooled_bytes_ -= bucket.back().capacity();
+            pooled_buffers_--;
+            victims.push_back(std::move(bucket.back()));
+            bucket.pop_back();
+        }
+    }
+}
+
+void BufferPool::set_max_pooled_bytes(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_pooled_bytes_ = bytes;
+    }
+    trim(bytes);
+}
+
+BufferPoolStats BufferPool::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    BufferPoolStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.pooled_buffers = pooled_buffers_;
+    stats.pooled_bytes = pooled_bytes_;
+    stats.max_pooled_bytes = max_pooled_bytes_;
+    return stats;
+}
+
+} // namespace nativeui
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * Buffer pool statistics
+ */
+struct BufferPoolStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t pooled_buffers = 0;
+    size_t pooled_bytes = 0;
+    size_t max_pooled_bytes = 0;
+};
+
+/**
+ * BufferPool - Size-bucketed reuse of pixel storage (singleton)
+ *
+ * Surfaces take their pixel vector from here and hand it back on
+ * destruction, so a surface of a recently freed size costs no heap
+ * allocation. Sizes are rounded up to quarter-power-of-two classes
+ * (at most 25% slack). Idle storage is capped and released under
+ * memory pressure.
+ */
+class BufferPool {
+public:
+    static BufferPool& instance() {
+        // Leaked on purpose: ~Surface returns buffers here, and surfaces
+        // owned by other statics can be destroyed after a local static
+        static BufferPool* inst = new BufferPool();
+        return *inst;
+    }
+
+    // Empty vector whose capacity is at least `bytes`
+    std::vector<uint8_t> acquire(size_t bytes);
+
+    // Return storage for reuse (dropped if the pool is full). Never throws:
+    // Surface calls it from its destructor and noexcept move assignment.
+    void release(std::vector<uint8_t>&& buffer) noexcept;
+
+    // Free idle storage down to `keep_bytes`
+    void trim(size_t keep_bytes = 0);
+
+    void set_max_pooled_bytes(size_t bytes);
+    BufferPoolStats get_stats() const;
+
+    // Size class a request is rounded up to
+    static size_t size_class(size_t bytes);
+
+private:
+    BufferPool();
+
+    // Move idle storage beyond keep_bytes into victims; mutex_ held
+    void trim_locked(size_t keep_bytes, std::vector<std::vector<uint8_t>>& victims);
+
+    mutable std::mutex mutex_;
+    std::map<size_t, std::vector<std::vector<uint8_t>>> buckets_;
+    size_t pooled_bytes_;
+    size_t pooled_buffers_;
+    size_t max_pooled_bytes_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+} // namespace nativeui
@@ -1,5 +1,6 @@
 #include "button.hpp"
 #include "font.hpp"
+#include "text_cache.hpp"
 #include <iostream>
 #include <cmath> // For std::exp
 #include <algorithm> // For min/max
@@ -146,22 +147,17 @@ void Button::set_text_style(const ButtonTextStyle& style) {
 void Button::draw_text(Surface& s) {
     if (!text_style_.has_text()) return;
 
-    // Load font
-    auto font = FontCache::get(text_style_.font_name, text_style_.font_size);
-    if (!font) return;
-
-    // Render text
-    // Note: This renders new surface every frame -> Inefficient for static text.
-    // Optimization: Cache rendered text surface if style hasn't changed.
-    // For now: Direct rendering.
-    auto text_surf = font->render(text_style_.text, text_style_.color);
-    if (!text_surf) return;
+    // Laid out once per (text, font, size) and shared with other widgets
+    auto layout = TextLayoutCache::instance().layout(text_style_.font_name, text_style_.font_size,
+                                                     text_style_.text);
+    if (!layout || layout->glyphs.empty()) return;
+    const GlyphRun& run = *layout;
 
     // Calculate Position
     int btn_w = s.get_width();
     int btn_h = s.get_height();
-    int txt_w = text_surf->get_width();
-    int txt_h = text_surf->get_height();
+    int txt_w = run.width;
+    int txt_h = run.height;
 
     int x = 0;
     int y = 0;
@@ -199,30 +195,13 @@ void Button::draw_text(Surface& s) {
     // "Horizontal padding will be ignored for top center and bottom center" -> handled by using center x logic above
     // "all padding will be ignored for center" -> handled by both
     
-    // Blit
-    // (If rotation needed, we'd rotate text_surf here)
-    // Currently no rotation support in Surface::blit, simple copy
-    
-    // Simple alpha blending blit
-    for (int ty = 0; ty < txt_h; ++ty) {
-        for (int tx = 0; tx < txt_w; ++tx) {
-            Color c = text_surf->get_pixel(tx, ty);
-            if (c.a > 0) {
-                // Apply opacity from button style if needed? 
-                // Usually text opacity is part of text color.
-                // But if button fades out, text should too? 
-                // Let's assume text color alpha is master, multiplied by button opacity.
-                
-                float global_opacity = get_opacity();
-                if (global_opacity < 1.0f) {
-                     c.a = static_cast<uint8_t>(c.a * global_opacity);
-                }
-                
-                // Blend
-                s.blend_pixel(x + tx, y + ty, c);
-            }
-        }
+    // Text color alpha is the master, multiplied by the button's opacity
+    Color color = text_style_.color;
+    float global_opacity = get_opacity();
+    if (global_opacity < 1.0f) {
+        color.a = static_cast<uint8_t>(color.a * global_opacity);
     }
+    run.draw(s, x, y, color);
 }
 
 void Button::redraw() {
@@ -0,0 +1,115 @@
+#include "coverage_mask.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace nativeui {
+
+namespace {
+
+// Box radius of each of the three blur passes
+int box_radius(float radius)
+{
+    return radius > 0.0f ? std::max(1, static_cast<int>(std::lround(radius / 3.0f))) : 0;
+}
+
+// Sliding-window box filter of n samples `stride` apart, via tmp
+void box_pass(uint8_t* p, int n, int stride, int r, uint32_t* tmp)
+{
+    for (int i = 0; i < n; ++i) tmp[i] = p[i * stride];
+    uint32_t sum = 0;
+    for (int i = 0; i <= std::min(r, n - 1); ++i) sum += tmp[i];
+    uint32_t div = 2 * r + 1;
+    for (int i = 0; i < n; ++i) {
+        p[i * stride] = static_cast<uint8_t>((sum + div / 2) / div);
+        if (i + r + 1 < n) sum += tmp[i + r + 1];
+        if (i - r >= 0) sum -= tmp[i - r];
+    }
+}
+
+} // namespace
+
+CoverageMask::CoverageMask(int width, int height)
+    : width_(std::max(0, width))
+    , height_(std::max(0, height))
+    , data_(static_cast<size_t>(width_) * height_, 0)
+{
+}
+
+void CoverageMask::add_run(const GlyphRun& run, int x, int y)
+{
+    for (const GlyphRun::Glyph& g : run.glyphs) {
+        int x0 = std::max(0, x + g.x), x1 = std::min(width_, x + g.x + g.width);
+        int y0 = std::max(0, y + g.y), y1 = std::min(height_, y + g.y + g.height);
+        for (int ty = y0; ty < y1; ++ty) {
+            const uint8_t* c = g.coverage + static_cast<size_t>(ty - y - g.y) * g.pitch + (x0 - x - g.x);
+            uint8_t* d = row(ty) + x0;
+            for (int tx = x0; tx < x1; ++tx, ++c, ++d) *d = std::max(*d, *c);
+        }
+    }
+}
+
+CoverageMask CoverageMask::dilated(float radius) const
+{
+    CoverageMask out(width_, height_);
+    if (empty() || radius <= 0.0f) {
+        out.data_ = data_;
+        return out;
+    }
+
+    // Disc offsets, weighted by how much of each pixel the disc covers
+    struct Tap {
+        int dx, dy;
+        uint32_t weight;  // 0..256
+    };
+    std::vector<Tap> taps;
+    int reach = static_cast<int>(std::ceil(radius + 0.5f));
+    for (int dy = -reach; dy <= reach; ++dy) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            float w = std::clamp(radius + 0.5f - std::sqrt(static_cast<float>(dx * dx + dy * dy)), 0.0f, 1.0f);
+            if (w > 0.0f) taps.push_back(Tap{dx, dy, static_cast<uint32_t>(w * 256.0f)});
+        }
+    }
+
+    for (int y = 0; y < height_; ++y) {
+        uint8_t* d = out.row(y);
+        for (int x = 0; x < width_; ++x) {
+            uint32_t best = 0;
+            for (const Tap& t : taps) {
+                int sx = x + t.dx, sy = y + t.dy;
+                if (sx < 0 || sy < 0 || sx >= width_ || sy >= height_) continue;
+                best = std::max(best, row(sy)[sx] * t.weight);
+                if (best >= 255u * 256u) break;
+            }
+            d[x] = static_cast<uint8_t>(best >> 8);
+        }
+    }
+    return out;
+}
+
+CoverageMask CoverageMask::shifted(int dx, int dy) const
+{
+    CoverageMask out(width_, height_);
+    int x0 = std::max(0, dx), x1 = std::min(width_, width_ + dx);
+    for (int y = std::max(0, dy); y < std::min(height_, height_ + dy); ++y) {
+        if (x0 < x1) std::copy(row(y - dy) + x0 - dx, row(y - dy) + x1 - dx, out.row(y) + x0);
+    }
+    return out;
+}
+
+void CoverageMask::blur(float radius)
+{
+    int r = box_radius(radius);
+    if (r == 0 || empty()) return;
+    std::vector<uint32_t> tmp(std::max(width_, height_));
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int y = 0; y < height_; ++y) box_pass(row(y), width_, 1, r, tmp.data());
+        for (int x = 0; x < width_; ++x) box_pass(data_.data() + x, height_, width_, r, tmp.data());
+    }
+}
+
+int CoverageMask::blur_reach(float radius)
+{
+    return 3 * box_radius(radius);
+}
+
+} // namespace nativeui
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "font.hpp"
+
+namespace nativeui {
+
+/**
+ * CoverageMask - An 8-bit coverage plane, tinted when it is drawn
+ *
+ * Text effects work on masks instead of colored surfaces: an outline is the
+ * text mask dilated by a disc, and a soft shadow is a mask blurred alone
+ * (alpha only), so each costs one pass over one byte per pixel.
+ */
+class CoverageMask {
+public:
+    CoverageMask() = default;
+    CoverageMask(int width, int height);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    bool empty() const { return width_ <= 0 || height_ <= 0; }
+    uint8_t* row(int y) { return data_.data() + static_cast<size_t>(y) * width_; }
+    const uint8_t* row(int y) const { return data_.data() + static_cast<size_t>(y) * width_; }
+
+    // Max in the glyphs of run with its top-left at (x, y)
+    void add_run(const GlyphRun& run, int x, int y);
+
+    // Grown by a disc of `radius` pixels (fractional radii get a soft edge)
+    CoverageMask dilated(float radius) const;
+
+    // Copy moved by (dx, dy) within the same box
+    CoverageMask shifted(int dx, int dy) const;
+
+    // Three box passes approximating a gaussian that reaches blur_reach(radius)
+    void blur(float radius);
+    static int blur_reach(float radius);
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<uint8_t> data_;
+};
+
+} // namespace nativeui
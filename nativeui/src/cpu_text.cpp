@@ -1,4 +1,7 @@
 #include "cpu_text.hpp"
+#include "text_cache.hpp"
+#include "surface_raster.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -30,11 +33,8 @@ void CPUText::set_size(float size) {
 }
 
 void CPUText::set_color(const nativeui::Color& color) {
-    if (color_.r != color.r || color_.g != color.g || 
-        color_.b != color.b || color_.a != color.a) {
-        color_ = color;
-        dirty_ = true;
-    }
+    // Masks are tinted at draw time; no rebuild
+    color_ = color;
 }
 
 void CPUText::set_position(float x, float y) {
@@ -88,46 +88,73 @@ void CPUText::set_outline(const nativeui::Color& color, float width) {
     dirty_ = true;
 }
 
+void CPUText::set_sdf(bool enabled) {
+    if (sdf_ != enabled) {
+        sdf_ = enabled;
+        dirty_ = true;
+    }
+}
+
+void CPUText::set_rotation(float degrees) {
+    rotation_ = degrees;
+}
+
+void CPUText::set_glow(const nativeui::Color& color, float radius) {
+    glow_color_ = color;
+    glow_radius_ = radius;
+}
+
 void CPUText::rebuild_cache() {
-    cached_surface_ = nullptr;
-    shadow_surface_ = nullptr;
-    outline_surface_ = nullptr;
+    fill_mask_ = nativeui::CoverageMask();
+    outline_mask_ = nativeui::CoverageMask();
+    shadow_mask_ = nativeui::CoverageMask();
+    text_w_ = text_h_ = 0;
+    sdf_font_ = nullptr;
 
     if (text_.empty()) return;
 
-    // Load font
-    // Note: CPU Font size is int
-    auto font = nativeui::FontCache::get(font_, static_cast<int>(size_));
-    if (!font) return;
-
-    // Main Text
-    if (width_ > 0) {
-        cached_surface_ = font->render_wrapped(text_, color_, static_cast<int>(width_));
-    } else {
-        cached_surface_ = font->render(text_, color_);
+    // Distance fields are drawn directly at any size; nothing to render here
+    if (sdf_) {
+        sdf_font_ = nativeui::SdfFont::get(font_);
+        dirty_ = false;
+        return;
     }
 
-    if (!cached_surface_) return;
-
-    // Shadow Surface (re-render with shadow color)
+    // Coverage comes from the shared text cache: identical labels (and the
+    // same text re-set later) are laid out once, whatever their colors
+    // Note: CPU Font size is int
+    int size = static_cast<int>(size_);
+    int wrap = width_ > 0 ? static_cast<int>(width_) : 0;
+    auto run = nativeui::TextLayoutCache::instance().layout(font_, size, text_, wrap);
+    if (!run || run->width <= 0 || run->height <= 0) return;
+    text_w_ = run->width;
+    text_h_ = run->height;
+
+    // One box holds the text, the outline around it and the offset, blurred shadow
+    int grow = outline_.enabled ? static_cast<int>(std::ceil(outline_.width + 0.5f)) : 0;
+    int sx = 0, sy = 0, soft = 0;
     if (shadow_.enabled) {
-        // Just render same text with shadow color
-        if (width_ > 0) {
-            shadow_surface_ = font->render_wrapped(text_, shadow_.color, static_cast<int>(width_));
-        } else {
-            shadow_surface_ = font->render(text_, shadow_.color);
-        }
+        sx = static_cast<int>(std::lround(shadow_.offset_x));
+        sy = static_cast<int>(std::lround(shadow_.offset_y));
+        soft = nativeui::CoverageMask::blur_reach(shadow_.blur);
     }
+    int x0 = -grow, y0 = -grow, x1 = text_w_ + grow, y1 = text_h_ + grow;
+    if (shadow_.enabled) {
+        x0 = std::min(x0, sx - grow - soft);
+        y0 = std::min(y0, sy - grow - soft);
+        x1 = std::max(x1, text_w_ + sx + grow + soft);
+        y1 = std::max(y1, text_h_ + sy + grow + soft);
+    }
+    mask_x_ = x0;
+    mask_y_ = y0;
 
-    // Outline Surface (Poor man's outline: Render with outline color)
-    if (outline_.enabled) {
-        // We render the text in outline color. 
-        // We will draw it at offsets during draw().
-        if (width_ > 0) {
-            outline_surface_ = font->render_wrapped(text_, outline_.color, static_cast<int>(width_));
-        } else {
-            outline_surface_ = font->render(text_, outline_.color);
-        }
+    fill_mask_ = nativeui::CoverageMask(x1 - x0, y1 - y0);
+    fill_mask_.add_run(*run, -x0, -y0);
+    if (outline_.enabled) outline_mask_ = fill_mask_.dilated(outline_.width);
+    if (shadow_.enabled) {
+        // The shadow is cast by everything drawn, outline included
+        shadow_mask_ = (outline_.enabled ? outline_mask_ : fill_mask_).shifted(sx, sy);
+        shadow_mask_.blur(shadow_.blur);
     }
 
     dirty_ = false;
@@ -135,50 +162,78 @@ void CPUText::rebuild_cache() {
 
 void CPUText::draw(std::shared_ptr<nativeui::Surface> surface) {
     if (dirty_) rebuild_cache();
-    if (!cached_surface_) return;
-    if (!surface) return;
-
-    int ix = static_cast<int>(x_);
-    int iy = static_cast<int>(y_);
-
-    // Draw Shadow
-    if (shadow_.enabled && shadow_surface_) {
-        // Simple offset. No blur on CPU for now.
-        surface->blit(*shadow_surface_, ix + static_cast<int>(shadow_.offset_x), iy + static_cast<int>(shadow_.offset_y));
-    }
-
-    // Draw Outline (Poor man's stroke - 4 directions)
-    if (outline_.enabled && outline_surface_) {
-        int w = static_cast<int>(outline_.width);
-        if (w < 1) w = 1;
-        
-        // Very basic stroke
-        surface->blit(*outline_surface_, ix - w, iy);
-        surface->blit(*outline_surface_, ix + w, iy);
-        surface->blit(*outline_surface_, ix, iy - w);
-        surface->blit(*outline_surface_, ix, iy + w);
-        
-        // Diagonals for thicker stroke?
-        if (w > 1) {
-            surface->blit(*outline_surface_, ix - w, iy - w);
-            surface->blit(*outline_surface_, ix + w, iy - w);
-            surface->blit(*outline_surface_, ix - w, iy + w);
-            surface->blit(*outline_surface_, ix + w, iy + w);
+    if (sdf_) {
+        draw_sdf(surface);
+        return;
+    }
+    if (fill_mask_.empty() || !surface) return;
+
+    int ox = static_cast<int>(x_) + mask_x_;
+    int oy = static_cast<int>(y_) + mask_y_;
+    int x0 = std::max(0, ox), x1 = std::min(surface->get_width(), ox + fill_mask_.width());
+    int y0 = std::max(0, oy), y1 = std::min(surface->get_height(), oy + fill_mask_.height());
+    bool shadow = !shadow_mask_.empty() && shadow_.color.a > 0;
+    bool outline = !outline_mask_.empty();
+
+    // Shadow, outline and text tinted and blended in a single pass
+    auto tint = [](uint8_t* d, const nativeui::Color& c, uint8_t coverage) {
+        if (coverage) nativeui::raster::blend_over(d, c.r, c.g, c.b, static_cast<uint8_t>(coverage * c.a / 255));
+    };
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t* f = fill_mask_.row(y - oy) + (x0 - ox);
+        const uint8_t* o = outline ? outline_mask_.row(y - oy) + (x0 - ox) : nullptr;
+        const uint8_t* sh = shadow ? shadow_mask_.row(y - oy) + (x0 - ox) : nullptr;
+        uint8_t* d = surface->get_data() + y * surface->get_pitch() + static_cast<size_t>(x0) * 4;
+        for (int x = x0; x < x1; ++x, d += 4) {
+            int i = x - x0;
+            if (sh) tint(d, shadow_.color, sh[i]);
+            if (o) tint(d, outline_.color, o[i]);
+            tint(d, color_, f[i]);
         }
     }
+}
+
+void CPUText::draw_sdf(std::shared_ptr<nativeui::Surface> surface) {
+    if (!sdf_font_ || !surface) return;
+    float wrap = width_ > 0 ? width_ : 0.0f;
 
-    // Draw Main Text
-    surface->blit(*cached_surface_, ix, iy);
+    // Shadow: the same shape, softened by a glow of its own color
+    if (shadow_.enabled) {
+        nativeui::SdfTextStyle soft;
+        soft.glow_color = shadow_.color;
+        soft.glow_radius = shadow_.blur;
+        sdf_font_->draw(*surface, text_, x_ + shadow_.offset_x, y_ + shadow_.offset_y, size_, shadow_.color,
+                        rotation_, soft, wrap);
+    }
+
+    nativeui::SdfTextStyle style;
+    if (outline_.enabled) {
+        style.outline_color = outline_.color;
+        style.outline_width = outline_.width;
+    }
+    style.glow_color = glow_color_;
+    style.glow_radius = glow_radius_;
+    sdf_font_->draw(*surface, text_, x_, y_, size_, color_, rotation_, style, wrap);
 }
 
 float CPUText::get_render_width() const {
     if (dirty_) const_cast<CPUText*>(this)->rebuild_cache();
-    return cached_surface_ ? static_cast<float>(cached_surface_->get_width()) : 0.0f;
+    if (sdf_) {
+        float w = 0.0f, h = 0.0f;
+        if (sdf_font_) sdf_font_->measure(text_, size_, w, h, width_ > 0 ? width_ : 0.0f);
+        return w;
+    }
+    return static_cast<float>(text_w_);
 }
 
 float CPUText::get_render_height() const {
     if (dirty_) const_cast<CPUText*>(this)->rebuild_cache();
-    return cached_surface_ ? static_cast<float>(cached_surface_->get_height()) : 0.0f;
+    if (sdf_) {
+        float w = 0.0f, h = 0.0f;
+        if (sdf_font_) sdf_font_->measure(text_, size_, w, h, width_ > 0 ? width_ : 0.0f);
+        return h;
+    }
+    return static_cast<float>(text_h_);
 }
 
 } // namespace palladium
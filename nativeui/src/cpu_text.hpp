@@ -4,6 +4,8 @@
 #include <memory>
 #include "surface.hpp"
 #include "font.hpp"
+#include "sdf_text.hpp"
+#include "coverage_mask.hpp"
 #include "text_common.hpp"
 
 // Enums are in text_common.hpp
@@ -50,6 +52,17 @@ public:
     
     void set_shadow(const nativeui::Color& color, float off_x, float off_y, float blur);
     void set_outline(const nativeui::Color& color, float width);
+
+    // Distance field rendering (SdfFont): any size, including fractional and
+    // animated ones, without re-rasterizing; enables rotation and glow, and
+    // blurs the shadow by its `blur` radius
+    void set_sdf(bool enabled);
+    bool get_sdf() const { return sdf_; }
+
+    void set_rotation(float degrees);   // Clockwise about (x, y); SDF only
+    float get_rotation() const { return rotation_; }
+
+    void set_glow(const nativeui::Color& color, float radius);  // SDF only
     
     void draw(std::shared_ptr<nativeui::Surface> surface);
     
@@ -58,6 +71,7 @@ public:
 
 private:
     void rebuild_cache();
+    void draw_sdf(std::shared_ptr<nativeui::Surface> surface);
     
     std::string text_;
     std::string font_;
@@ -72,13 +86,24 @@ private:
     
     TextShadow shadow_;
     TextOutline outline_;
+    nativeui::Color glow_color_ = nativeui::Color(0, 0, 0, 0);
+    float glow_radius_ = 0.0f;
+    float rotation_ = 0.0f;
+    bool sdf_ = false;
     
     bool dirty_ = true;
     
     // Cache
-    std::shared_ptr<nativeui::Surface> cached_surface_;
-    std::shared_ptr<nativeui::Surface> shadow_surface_;
-    std::shared_ptr<nativeui::Surface> outline_surface_;
+    // Coverage of the text, its outline and its shadow over one box whose
+    // top-left is (mask_x_, mask_y_) from the text position; tinted at draw
+    nativeui::CoverageMask fill_mask_;
+    nativeui::CoverageMask outline_mask_;
+    nativeui::CoverageMask shadow_mask_;
+    int mask_x_ = 0;
+    int mask_y_ = 0;
+    int text_w_ = 0;
+    int text_h_ = 0;
+    std::shared_ptr<nativeui::SdfFont> sdf_font_;
 };
 
 } // namespace palladium
@@ -0,0 +1,335 @@
+#include "display_list.hpp"
+#include "effects.hpp"
+#include "profiler.hpp"
+#include "scratch_arena.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace nativeui {
+
+namespace {
+
+const PixelRect kUnbounded{INT_MIN, INT_MIN, INT_MAX, INT_MAX};
+
+// Copy a w x h block of pixels between two surfaces (no blending, no bounds checks)
+void copy_pixels(const Surface& src, int sx, int sy, Surface& dst, int dx, int dy, int w, int h)
+{
+    size_t row = static_cast<size_t>(w) * 4;
+    for (int y = 0; y < h; ++y) {
+        std::memcpy(dst.get_data() + (dy + y) * dst.get_pitch() + static_cast<size_t>(dx) * 4,
+                    src.get_data() + (sy + y) * src.get_pitch() + static_cast<size_t>(sx) * 4, row);
+    }
+}
+
+} // namespace
+
+DisplayList::DisplayList()
+{
+    clear();
+}
+
+void DisplayList::clear()
+{
+    commands_.clear();
+    clips_.assign(1, kUnbounded);
+    clip_stack_.assign(1, 0);
+    surfaces_.clear();
+    texts_.clear();
+    effects_.clear();
+    stats_ = DisplayListStats();
+}
+
+void DisplayList::record(DrawOp op, int a, int b, int c, int d, const Color& color,
+                         int radius, float alpha, int resource)
+{
+    commands_.push_back(DrawCommand{op, clip_stack_.back(), a, b, c, d, radius, alpha, color, resource});
+}
+
+// ============ Recording ============
+
+void DisplayList::fill(const Color& color) { record(DrawOp::Fill, 0, 0, 0, 0, color); }
+void DisplayList::fill_rect(int x, int y, int w, int h, const Color& color) { record(DrawOp::FillRect, x, y, w, h, color); }
+void DisplayList::draw_rect(int x, int y, int w, int h, const Color& color) { record(DrawOp::DrawRect, x, y, w, h, color); }
+void DisplayList::draw_line(int x1, int y1, int x2, int y2, const Color& color) { record(DrawOp::DrawLine, x1, y1, x2, y2, color); }
+void DisplayList::draw_circle(int cx, int cy, int radius, const Color& color) { record(DrawOp::DrawCircle, cx, cy, 0, 0, color, radius); }
+void DisplayList::fill_circle(int cx, int cy, int radius, const Color& color) { record(DrawOp::FillCircle, cx, cy, 0, 0, color, radius); }
+
+void DisplayList::draw_round_rect(int x, int y, int w, int h, int radius, const Color& color)
+{
+    record(DrawOp::DrawRoundRect, x, y, w, h, color, radius);
+}
+
+void DisplayList::fill_round_rect(int x, int y, int w, int h, int radius, const Color& color)
+{
+    record(DrawOp::FillRoundRect, x, y, w, h, color, radius);
+}
+
+void DisplayList::draw_pill(int x, int y, int w, int h, const Color& color) { record(DrawOp::DrawPill, x, y, w, h, color); }
+void DisplayList::fill_pill(int x, int y, int w, int h, const Color& color) { record(DrawOp::FillPill, x, y, w, h, color); }
+void DisplayList::draw_squircle(int x, int y, int w, int h, const Color& color) { record(DrawOp::DrawSquircle, x, y, w, h, color); }
+void DisplayList::fill_squircle(int x, int y, int w, int h, const Color& color) { record(DrawOp::FillSquircle, x, y, w, h, color); }
+
+void DisplayList::blit(std::shared_ptr<Surface> source, int x, int y)
+{
+    if (!source) throw std::invalid_argument("DisplayList::blit needs a source surface");
+    surfaces_.push_back(std::move(source));
+    record(DrawOp::Blit, x, y, 0, 0, Color(), 0, 1.0f, static_cast<int>(surfaces_.size() - 1));
+}
+
+void DisplayList::blit_alpha(std::shared_ptr<Surface> source, int x, int y, float alpha)
+{
+    if (!source) throw std::invalid_argument("DisplayList::blit_alpha needs a source surface");
+    surfaces_.push_back(std::move(source));
+    record(DrawOp::BlitAlpha, x, y, 0, 0, Color(), 0, alpha, static_cast<int>(surfaces_.size() - 1));
+}
+
+void DisplayList::blit_scaled(std::shared_ptr<Surface> source, int x, int y, int w, int h)
+{
+    if (!source) throw std::invalid_argument("DisplayList::blit_scaled needs a source surface");
+    surfaces_.push_back(std::move(source));
+    record(DrawOp::BlitScaled, x, y, w, h, Color(), 0, 1.0f, static_cast<int>(surfaces_.size() - 1));
+}
+
+void DisplayList::draw_text(TextRasterizer rasterize, int x, int y)
+{
+    texts_.push_back(TextEntry{std::move(rasterize), nullptr});
+    record(DrawOp::Text, x, y, 0, 0, Color(), 0, 1.0f, static_cast<int>(texts_.size() - 1));
+}
+
+void DisplayList::push_clip(int x, int y, int w, int h)
+{
+    PixelRect clip = PixelRect::from_bounds(x, y, int64_t(x) + w, int64_t(y) + h);
+    clips_.push_back(clip.intersect(clips_[clip_stack_.back()]));
+    clip_stack_.push_back(static_cast<int>(clips_.size() - 1));
+}
+
+void DisplayList::pop_clip()
+{
+    if (clip_stack_.size() <= 1) {
+        throw std::runtime_error("DisplayList::pop_clip without a matching push_clip");
+    }
+    clip_stack_.pop_back();
+}
+
+void DisplayList::effect(int x, int y, int w, int h, EffectFn fn)
+{
+    if (!fn) throw std::invalid_argument("DisplayList::effect needs a function");
+    effects_.push_back(std::move(fn));
+    record(DrawOp::Effect, x, y, w, h, Color(), 0, 1.0f, static_cast<int>(effects_.size() - 1));
+}
+
+void DisplayList::blur_region(int x, int y, int w, int h, int radius)
+{
+    effect(x, y, w, h, [radius](Surface& s, int rx, int ry, int rw, int rh) {
+        Effects::blur_region(s, rx, ry, rw, rh, radius);
+    });
+}
+
+void DisplayList::frosted_glass_region(int x, int y, int w, int h, int blur_radius)
+{
+    effect(x, y, w, h, [blur_radius](Surface& s, int rx, int ry, int rw, int rh) {
+        Effects::frosted_glass_region(s, rx, ry, rw, rh, blur_radius);
+    });
+}
+
+// ============ Replay ============
+
+PixelRect DisplayList::bounds_of(const DrawCommand& cmd) const
+{
+    int64_t a = cmd.a, b = cmd.b, c = cmd.c, d = cmd.d, r = cmd.radius;
+    switch (cmd.op) {
+        case DrawOp::FillRect:
+        case DrawOp::BlitScaled:
+            return PixelRect::from_bounds(a, b, a + c, b + d);
+        case DrawOp::DrawRect:
+            return PixelRect::from_bounds(a - 1, b - 1, a + c + 1, b + d + 1);
+        case DrawOp::DrawLine:
+            return PixelRect::from_bounds(std::min(a, c) - 1, std::min(b, d) - 1,
+                                          std::max(a, c) + 2, std::max(b, d) + 2);
+        case DrawOp::DrawCircle:
+        case DrawOp::FillCircle:
+            return PixelRect::from_bounds(a - r - 2, b - r - 2, a + r + 3, b + r + 3);
+        case DrawOp::DrawRoundRect:
+        case DrawOp::FillRoundRect:
+        case DrawOp::DrawPill:
+        case DrawOp::FillPill:
+        case DrawOp::DrawSquircle:
+        case DrawOp::FillSquircle:
+            return PixelRect::from_bounds(a - 2, b - 2, a + c + 2, b + d + 2);
+        case DrawOp::Blit:
+        case DrawOp::BlitAlpha: {
+            const Surface& s = *surfaces_[cmd.resource];
+            return PixelRect::from_bounds(a, b, a + s.get_width(), b + s.get_height());
+        }
+        case DrawOp::Text: {
+            const auto& s = texts_[cmd.resource].surface;
+            if (!s) return PixelRect();
+            return PixelRect::from_bounds(a, b, a + s->get_width(), b + s->get_height());
+        }
+        case DrawOp::Fill:
+        case DrawOp::Effect:
+        default:
+            return kUnbounded;
+    }
+}
+
+void DisplayList::draw(const DrawCommand& cmd, Surface& dst, int ox, int oy) const
+{
+    // (ox, oy) is the target position of dst's top-left pixel
+    int x = cmd.a - ox, y = cmd.b - oy;
+    const Color& color = cmd.color;
+    switch (cmd.op) {
+        case DrawOp::Fill: dst.fill(color); break;
+        case DrawOp::FillRect: dst.fill_rect(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::DrawRect: dst.draw_rect(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::DrawLine: dst.draw_line(x, y, cmd.c - ox, cmd.d - oy, color); break;
+        case DrawOp::DrawCircle: dst.draw_circle(x, y, cmd.radius, color); break;
+        case DrawOp::FillCircle: dst.fill_circle(x, y, cmd.radius, color); break;
+        case DrawOp::DrawRoundRect: dst.draw_round_rect(x, y, cmd.c, cmd.d, cmd.radius, color); break;
+        case DrawOp::FillRoundRect: dst.fill_round_rect(x, y, cmd.c, cmd.d, cmd.radius, color); break;
+        case DrawOp::DrawPill: dst.draw_pill(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::FillPill: dst.fill_pill(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::DrawSquircle: dst.draw_squircle(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::FillSquircle: dst.fill_squircle(x, y, cmd.c, cmd.d, color); break;
+        case DrawOp::Blit: dst.blit(*surfaces_[cmd.resource], x, y); break;
+        case DrawOp::BlitAlpha: dst.blit_alpha(*surfaces_[cmd.resource], x, y, cmd.alpha); break;
+        case DrawOp::BlitScaled: dst.blit_scaled(*surfaces_[cmd.resource], x, y, cmd.c, cmd.d); break;
+        case DrawOp::Text:
+            if (texts_[cmd.resource].surface) dst.blit(*texts_[cmd.resource].surface, x, y);
+            break;
+        case DrawOp::Effect: break;  // Run by replay() between segments
+    }
+}
+
+void DisplayList::replay(Surface& target)
+{
+    replay(target, 0, 0, target.get_width(), target.get_height());
+}
+
+void DisplayList::replay(Surface& target, int x, int y, int w, int h)
+{
+    ProfileScope scope("DisplayList::replay");
+    stats_ = DisplayListStats();
+
+    // Rasterize text on first use; its size is needed for binning
+    for (auto& text : texts_) {
+        if (text.rasterize) {
+            text.surface = text.rasterize();
+            text.rasterize = nullptr;
+        }
+    }
+
+    PixelRect damage = PixelRect::from_bounds(x, y, int64_t(x) + w, int64_t(y) + h)
+                           .intersect(PixelRect{0, 0, target.get_width(), target.get_height()});
+    if (damage.empty()) return;
+
+    // Effects read neighbouring pixels, so everything before one must land first
+    size_t begin = 0;
+    for (size_t i = 0; i < commands_.size(); ++i) {
+        const DrawCommand& cmd = commands_[i];
+        if (cmd.op != DrawOp::Effect) continue;
+
+        replay_segment(target, damage, begin, i);
+        begin = i + 1;
+
+        stats_.commands++;
+        PixelRect region = PixelRect::from_bounds(cmd.a, cmd.b, int64_t(cmd.a) + cmd.c, int64_t(cmd.b) + cmd.d)
+                               .intersect(clips_[cmd.clip]).intersect(damage);
+        if (region.empty()) {
+            stats_.culled++;
+            continue;
+        }
+        effects_[cmd.resource](target, region.x0, region.y0, region.width(), region.height());
+    }
+    replay_segment(target, damage, begin, commands_.size());
+}
+
+void DisplayList::replay_segment(Surface& target, const PixelRect& damage, size_t begin, size_t end)
+{
+    size_t count = end - begin;
+    if (count == 0) return;
+
+    ScratchScope scratch;
+    PixelRect* bounds = scratch.alloc<PixelRect>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const DrawCommand& cmd = commands_[begin + i];
+        bounds[i] = bounds_of(cmd).intersect(clips_[cmd.clip]);
+        if (bounds[i].intersect(damage).empty()) stats_.culled++;
+    }
+    stats_.commands += count;
+
+    // One tile covering the damage when tiles could not run in parallel
+    const int T = kTileSize;
+    bool serial = ThreadPool::instance().get_threads() == 1 || (damage.width() <= T && damage.height() <= T);
+    int tile = serial ? std::max(damage.width(), damage.height()) : T;
+    TileBins bins = TileBins::build(scratch, damage, tile, bounds, count);
+
+    // A single tile over the whole target is drawn in place
+    bool direct = serial && damage.width() == target.get_width() && damage.height() == target.get_height();
+
+    std::atomic<size_t> tiles{0}, pairs{0};
+    ThreadPool::instance().parallel_for(0, bins.count(), 1, [&](int t0, int t1) {
+        for (int t = t0; t < t1; ++t) {
+            size_t n = bins.offsets[t + 1] - bins.offsets[t];
+            if (n == 0) continue;
+            draw_tile(target, bins.tile_rect(t), bins.items + bins.offsets[t], n, begin, direct);
+            tiles.fetch_add(1, std::memory_order_relaxed);
+            pairs.fetch_add(n, std::memory_order_relaxed);
+        }
+    });
+    stats_.tiles += tiles.load();
+    stats_.tile_commands += pairs.load();
+}
+
+void DisplayList::draw_tile(Surface& target, const PixelRect& region, const uint32_t* items, size_t count,
+                            size_t base, bool direct) const
+{
+    // Draw into a copy of the tile so that surface bounds do the clipping
+    ScratchScope scratch;
+    std::shared_ptr<Surface> tile;
+    Surface* dst = &target;
+    int ox = 0, oy = 0;
+    if (!direct) {
+        uint8_t* pixels = scratch.alloc<uint8_t>(static_cast<size_t>(region.width()) * region.height() * 4);
+        tile = Surface::wrap(pixels, region.width(), region.height(), nullptr);
+        copy_pixels(target, region.x0, region.y0, *tile, 0, 0, region.width(), region.height());
+        dst = tile.get();
+        ox = region.x0;
+        oy = region.y0;
+    }
+
+    for (size_t k = 0; k < count;) {
+        const DrawCommand& cmd = commands_[base + items[k]];
+        const PixelRect& clip = clips_[cmd.clip];
+        if (clip.contains(region)) {
+            draw(cmd, *dst, ox, oy);
+            ++k;
+            continue;
+        }
+
+        // A run of commands under a clip smaller than the tile: draw them into the clipped part
+        size_t run = k + 1;
+        while (run < count && commands_[base + items[run]].clip == cmd.clip) ++run;
+        PixelRect sub = clip.intersect(region);
+        if (!sub.empty()) {
+            ScratchScope inner;
+            uint8_t* pixels = inner.alloc<uint8_t>(static_cast<size_t>(sub.width()) * sub.height() * 4);
+            auto part = Surface::wrap(pixels, sub.width(), sub.height(), nullptr);
+            copy_pixels(*dst, sub.x0 - ox, sub.y0 - oy, *part, 0, 0, sub.width(), sub.height());
+            for (size_t j = k; j < run; ++j) {
+                draw(commands_[base + items[j]], *part, sub.x0, sub.y0);
+            }
+            copy_pixels(*part, 0, 0, *dst, sub.x0 - ox, sub.y0 - oy, sub.width(), sub.height());
+        }
+        k = run;
+    }
+
+    if (!direct) {
+        copy_pixels(*tile, 0, 0, target, region.x0, region.y0, region.width(), region.height());
+    }
+}
+
+} // namespace nativeui
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "surface.hpp"
+#include "tile_bins.hpp"
+
+namespace nativeui {
+
+enum class DrawOp : uint8_t {
+    Fill,
+    FillRect,
+    DrawRect,
+    DrawLine,
+    DrawCircle,
+    FillCircle,
+    DrawRoundRect,
+    FillRoundRect,
+    DrawPill,
+    FillPill,
+    DrawSquircle,
+    FillSquircle,
+    Blit,
+    BlitAlpha,
+    BlitScaled,
+    Text,
+    Effect  // Barrier: runs alone between the tiled segments
+};
+
+/**
+ * DrawCommand - One recorded draw call (plain data, no virtual dispatch)
+ */
+struct DrawCommand {
+    DrawOp op;
+    int clip;          // Index into the list's clip rects (0 = none)
+    int a, b, c, d;    // x, y, w, h  or  x1, y1, x2, y2
+    int radius;
+    float alpha;
+    Color color;
+    int resource;      // Index into surfaces / texts / effects, -1 if unused
+};
+
+struct DisplayListStats {
+    size_t commands = 0;       // Commands replayed (effects included)
+    size_t culled = 0;         // Skipped: outside the target, clip or damage
+    size_t tiles = 0;          // Tiles rasterized
+    size_t tile_commands = 0;  // Command x tile pairs drawn
+};
+
+/**
+ * DisplayList - Records draw calls and replays them tile-parallel
+ *
+ * Recording only appends plain commands; nothing is rasterized until
+ * replay(). Replay culls commands by bounding box, bins the rest into screen
+ * tiles and rasterizes the tiles on the ThreadPool, each tile drawing its
+ * commands in recorded order. Effects are barriers: the commands before one
+ * finish before it runs. A list can be replayed every frame, or only inside a
+ * damage rect. Sources of blits are referenced, not copied; text is
+ * rasterized once on first replay and cached.
+ *
+ * Pixels match immediate drawing except that anti-aliased edges are computed
+ * relative to the tile and may differ by float rounding.
+ */
+class DisplayList {
+public:
+    static const int kTileSize = 64;
+
+    using TextRasterizer = std::function<std::shared_ptr<Surface>()>;
+    // fn(surface, x, y, w, h): the effect's region, clipped to the damage rect
+    using EffectFn = std::function<void(Surface&, int, int, int, int)>;
+
+    DisplayList();
+
+    void clear();
+    size_t size() const { return commands_.size(); }
+
+    // Shapes (same semantics as the Surface methods)
+    void fill(const Color& color);
+    void fill_rect(int x, int y, int w, int h, const Color& color);
+    void draw_rect(int x, int y, int w, int h, const Color& color);
+    void draw_line(int x1, int y1, int x2, int y2, const Color& color);
+    void draw_circle(int cx, int cy, int radius, const Color& color);
+    void fill_circle(int cx, int cy, int radius, const Color& color);
+    void draw_round_rect(int x, int y, int w, int h, int radius, const Color& color);
+    void fill_round_rect(int x, int y, int w, int h, int radius, const Color& color);
+    void draw_pill(int x, int y, int w, int h, const Color& color);
+    void fill_pill(int x, int y, int w, int h, const Color& color);
+    void draw_squircle(int x, int y, int w, int h, const Color& color);
+    void fill_squircle(int x, int y, int w, int h, const Color& color);
+
+    // Blits (the source is read at replay time)
+    void blit(std::shared_ptr<Surface> source, int x, int y);
+    void blit_alpha(std::shared_ptr<Surface> source, int x, int y, float alpha);
+    void blit_scaled(std::shared_ptr<Surface> source, int x, int y, int w, int h);
+
+    // Text drawn from a surface produced once by `rasterize` on first replay
+    void draw_text(TextRasterizer rasterize, int x, int y);
+
+    // Clip stack; later commands are clipped to the intersection
+    void push_clip(int x, int y, int w, int h);
+    void pop_clip();
+
+    // Effects over a region
+    void effect(int x, int y, int w, int h, EffectFn fn);
+    void blur_region(int x, int y, int w, int h, int radius);
+    void frosted_glass_region(int x, int y, int w, int h, int blur_radius);
+
+    // Replay everything, or only inside a damage rect
+    void replay(Surface& target);
+    void replay(Surface& target, int x, int y, int w, int h);
+
+    const DisplayListStats& get_last_stats() const { return stats_; }
+
+private:
+    struct TextEntry {
+        TextRasterizer rasterize;
+        std::shared_ptr<Surface> surface;  // Null until first replay
+    };
+
+    std::vector<DrawCommand> commands_;
+    std::vector<PixelRect> clips_;       // clips_[0] is unbounded
+    std::vector<int> clip_stack_;
+    std::vector<std::shared_ptr<Surface>> surfaces_;
+    std::vector<TextEntry> texts_;
+    std::vector<EffectFn> effects_;
+    DisplayListStats stats_;
+
+    void record(DrawOp op, int a, int b, int c, int d, const Color& color,
+                int radius = 0, float alpha = 1.0f, int resource = -1);
+    PixelRect bounds_of(const DrawCommand& cmd) const;
+    void draw(const DrawCommand& cmd, Surface& dst, int ox, int oy) const;
+    void replay_segment(Surface& target, const PixelRect& damage, size_t begin, size_t end);
+    void draw_tile(Surface& target, const PixelRect& region, const uint32_t* items, size_t count,
+                   size_t base, bool direct) const;
+};
+
+} // namespace nativeui
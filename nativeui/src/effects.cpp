@@ -1,62 +1,84 @@
 #include "effects.hpp"
+#include "profiler.hpp"
+#include "memory_tracker.hpp"
+#include "scratch_arena.hpp"
+#include "thread_pool.hpp"
 #include <cmath>
 
 namespace nativeui {
 
+// Pixel from a raw RGBA buffer (scratch snapshots)
+static inline Color read_pixel(const uint8_t* data, int width, int x, int y)
+{
+    const uint8_t* p = data + (static_cast<size_t>(y) * width + x) * 4;
+    return Color(p[0], p[1], p[2], p[3]);
+}
+
 std::mt19937& Effects::get_rng()
 {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    // Per thread, so noise can be generated off the main thread
+    thread_local std::mt19937 gen(std::random_device{}());
     return gen;
 }
 
+void Effects::seed(uint32_t value)
+{
+    get_rng().seed(value);
+}
+
 void Effects::horizontal_box_blur(Surface& surface, int radius)
 {
     int width = surface.get_width();
     int height = surface.get_height();
     
-    std::vector<uint8_t> temp(width * height * 4);
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    ScratchScope scratch;
+    uint8_t* temp = scratch.alloc<uint8_t>(bytes);
     const uint8_t* src = surface.get_data();
+    size_t pitch = surface.get_pitch();
     
     int kernel_size = 2 * radius + 1;
     float inv_kernel = 1.0f / kernel_size;
     
-    for (int y = 0; y < height; ++y) {
-        // Initialize accumulator with left edge padding
-        int r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
-        
-        for (int i = -radius; i <= radius; ++i) {
-            int x = std::max(0, std::min(width - 1, i));
-            size_t offset = (y * width + x) * 4;
-            r_sum += src[offset];
-            g_sum += src[offset + 1];
-            b_sum += src[offset + 2];
-            a_sum += src[offset + 3];
-        }
-        
-        for (int x = 0; x < width; ++x) {
-            size_t dst_offset = (y * width + x) * 4;
-            temp[dst_offset] = static_cast<uint8_t>(r_sum * inv_kernel);
-            temp[dst_offset + 1] = static_cast<uint8_t>(g_sum * inv_kernel);
-            temp[dst_offset + 2] = static_cast<uint8_t>(b_sum * inv_kernel);
-            temp[dst_offset + 3] = static_cast<uint8_t>(a_sum * inv_kernel);
-            
-            // Slide window
-            int left_x = std::max(0, x - radius);
-            int right_x = std::min(width - 1, x + radius + 1);
+    // Rows are independent: split into bands across the pool
+    ThreadPool::instance().parallel_rows(width, height, [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            // Initialize accumulator with left edge padding
+            int r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
             
-            size_t left_offset = (y * width + left_x) * 4;
-            size_t right_offset = (y * width + right_x) * 4;
+            for (int i = -radius; i <= radius; ++i) {
+                int x = std::max(0, std::min(width - 1, i));
+                size_t offset = y * pitch + x * 4;
+                r_sum += src[offset];
+                g_sum += src[offset + 1];
+                b_sum += src[offset + 2];
+                a_sum += src[offset + 3];
+            }
             
-            r_sum += src[right_offset] - src[left_offset];
-            g_sum += src[right_offset + 1] - src[left_offset + 1];
-            b_sum += src[right_offset + 2] - src[left_offset + 2];
-            a_sum += src[right_offset + 3] - src[left_offset + 3];
+            for (int x = 0; x < width; ++x) {
+                size_t dst_offset = (y * width + x) * 4;
+                temp[dst_offset] = static_cast<uint8_t>(r_sum * inv_kernel);
+                temp[dst_offset + 1] = static_cast<uint8_t>(g_sum * inv_kernel);
+                temp[dst_offset + 2] = static_cast<uint8_t>(b_sum * inv_kernel);
+                temp[dst_offset + 3] = static_cast<uint8_t>(a_sum * inv_kernel);
+                
+                // Slide window
+                int left_x = std::max(0, x - radius);
+                int right_x = std::min(width - 1, x + radius + 1);
+                
+                size_t left_offset = y * pitch + left_x * 4;
+                size_t right_offset = y * pitch + right_x * 4;
+                
+                r_sum += src[right_offset] - src[left_offset];
+                g_sum += src[right_offset + 1] - src[left_offset + 1];
+                b_sum += src[right_offset + 2] - src[left_offset + 2];
+                a_sum += src[right_offset + 3] - src[left_offset + 3];
+            }
         }
-    }
+    });
     
     // Copy back to surface
-    std::memcpy(surface.get_data(), temp.data(), temp.size());
+    surface.write_pixels(temp);
 }
 
 void Effects::vertical_box_blur(Surface& surface, int radius)
@@ -64,49 +86,57 @@ void Effects::vertical_box_blur(Surface& surface, int radius)
     int width = surface.get_width();
     int height = surface.get_height();
     
-    std::vector<uint8_t> temp(width * height * 4);
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    ScratchScope scratch;
+    uint8_t* temp = scratch.alloc<uint8_t>(bytes);
     const uint8_t* src = surface.get_data();
+    size_t pitch = surface.get_pitch();
     
     int kernel_size = 2 * radius + 1;
     float inv_kernel = 1.0f / kernel_size;
     
-    for (int x = 0; x < width; ++x) {
-        int r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
-        
-        for (int i = -radius; i <= radius; ++i) {
-            int y = std::max(0, std::min(height - 1, i));
-            size_t offset = (y * width + x) * 4;
-            r_sum += src[offset];
-            g_sum += src[offset + 1];
-            b_sum += src[offset + 2];
-            a_sum += src[offset + 3];
-        }
-        
-        for (int y = 0; y < height; ++y) {
-            size_t dst_offset = (y * width + x) * 4;
-            temp[dst_offset] = static_cast<uint8_t>(r_sum * inv_kernel);
-            temp[dst_offset + 1] = static_cast<uint8_t>(g_sum * inv_kernel);
-            temp[dst_offset + 2] = static_cast<uint8_t>(b_sum * inv_kernel);
-            temp[dst_offset + 3] = static_cast<uint8_t>(a_sum * inv_kernel);
-            
-            int top_y = std::max(0, y - radius);
-            int bottom_y = std::min(height - 1, y + radius + 1);
+    // Columns are independent: split into bands across the pool
+    int columns = std::max(1, 16384 / std::max(1, height));
+    ThreadPool::instance().parallel_for(0, width, columns, [&](int x0, int x1) {
+        for (int x = x0; x < x1; ++x) {
+            int r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
             
-            size_t top_offset = (top_y * width + x) * 4;
-            size_t bottom_offset = (bottom_y * width + x) * 4;
+            for (int i = -radius; i <= radius; ++i) {
+                int y = std::max(0, std::min(height - 1, i));
+                size_t offset = y * pitch + x * 4;
+                r_sum += src[offset];
+                g_sum += src[offset + 1];
+                b_sum += src[offset + 2];
+                a_sum += src[offset + 3];
+            }
             
-            r_sum += src[bottom_offset] - src[top_offset];
-            g_sum += src[bottom_offset + 1] - src[top_offset + 1];
-            b_sum += src[bottom_offset + 2] - src[top_offset + 2];
-            a_sum += src[bottom_offset + 3] - src[top_offset + 3];
+            for (int y = 0; y < height; ++y) {
+                size_t dst_offset = (y * width + x) * 4;
+                temp[dst_offset] = static_cast<uint8_t>(r_sum * inv_kernel);
+                temp[dst_offset + 1] = static_cast<uint8_t>(g_sum * inv_kernel);
+                temp[dst_offset + 2] = static_cast<uint8_t>(b_sum * inv_kernel);
+                temp[dst_offset + 3] = static_cast<uint8_t>(a_sum * inv_kernel);
+                
+                int top_y = std::max(0, y - radius);
+                int bottom_y = std::min(height - 1, y + radius + 1);
+                
+                size_t top_offset = top_y * pitch + x * 4;
+                size_t bottom_offset = bottom_y * pitch + x * 4;
+                
+                r_sum += src[bottom_offset] - src[top_offset];
+                g_sum += src[bottom_offset + 1] - src[top_offset + 1];
+                b_sum += src[bottom_offset + 2] - src[top_offset + 2];
+                a_sum += src[bottom_offset + 3] - src[top_offset + 3];
+            }
         }
-    }
+    });
     
-    std::memcpy(surface.get_data(), temp.data(), temp.size());
+    surface.write_pixels(temp);
 }
 
 void Effects::box_blur(Surface& surface, int radius)
 {
+    ProfileScope scope("Effects::box_blur");
     if (radius <= 0) return;
     
     // Separable box blur (two 1D passes)
@@ -139,6 +169,7 @@ std::vector<float> Effects::generate_gaussian_kernel(float sigma)
 
 void Effects::gaussian_blur(Surface& surface, float sigma)
 {
+    ProfileScope scope("Effects::gaussian_blur");
     if (sigma <= 0.0f) return;
     
     // Use multi-pass box blur as approximation
@@ -161,6 +192,7 @@ void Effects::gaussian_blur(Surface& surface, float sigma)
 
 void Effects::blur_region(Surface& surface, int x, int y, int w, int h, int radius)
 {
+    ProfileScope scope("Effects::blur_region");
     auto region = surface.subsurface(x, y, w, h);
     box_blur(*region, radius);
     
@@ -173,6 +205,7 @@ void Effects::blur_region(Surface& surface, int x, int y, int w, int h, int radi
 
 void Effects::frosted_glass(Surface& surface, int blur_radius, float noise_amount, float sat)
 {
+    ProfileScope scope("Effects::frosted_glass");
     // Apply blur
     gaussian_blur(surface, static_cast<float>(blur_radius));
     
@@ -185,6 +218,7 @@ void Effects::frosted_glass(Surface& surface, int blur_radius, float noise_amoun
 
 void Effects::frosted_glass_region(Surface& surface, int x, int y, int w, int h, int blur_radius)
 {
+    ProfileScope scope("Effects::frosted_glass_region");
     auto region = surface.subsurface(x, y, w, h);
     frosted_glass(*region, blur_radius);
     
@@ -197,10 +231,15 @@ void Effects::frosted_glass_region(Surface& surface, int x, int y, int w, int h,
 
 void Effects::displace(Surface& surface, const Surface& displacement_map, float strength)
 {
+    ProfileScope scope("Effects::displace");
     int width = surface.get_width();
     int height = surface.get_height();
     
-    auto original = surface.copy();
+    // Read from a scratch snapshot so writes don't feed back into sampling
+    ScratchScope scratch;
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    uint8_t* original = scratch.alloc<uint8_t>(bytes);
+    surface.read_pixels(original);
     
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
@@ -213,34 +252,44 @@ void Effects::displace(Surface& surface, const Surface& displacement_map, float
             int src_x = std::clamp(static_cast<int>(x + dx), 0, width - 1);
             int src_y = std::clamp(static_cast<int>(y + dy), 0, height - 1);
             
-            surface.set_pixel(x, y, original->get_pixel(src_x, src_y));
+            surface.set_pixel(x, y, read_pixel(original, width, src_x, src_y));
         }
     }
 }
 
 void Effects::wave_distort(Surface& surface, float amplitude, float frequency, float phase)
 {
+    ProfileScope scope("Effects::wave_distort");
     int width = surface.get_width();
     int height = surface.get_height();
     
-    auto original = surface.copy();
+    // Read from a scratch snapshot so writes don't feed back into sampling
+    ScratchScope scratch;
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    uint8_t* original = scratch.alloc<uint8_t>(bytes);
+    surface.read_pixels(original);
     
     for (int y = 0; y < height; ++y) {
         float offset = amplitude * std::sin(frequency * y + phase);
         
         for (int x = 0; x < width; ++x) {
             int src_x = std::clamp(static_cast<int>(x + offset), 0, width - 1);
-            surface.set_pixel(x, y, original->get_pixel(src_x, y));
+            surface.set_pixel(x, y, read_pixel(original, width, src_x, y));
         }
     }
 }
 
 void Effects::ripple(Surface& surface, int center_x, int center_y, float amplitude, float wavelength, float phase)
 {
+    ProfileScope scope("Effects::ripple");
     int width = surface.get_width();
     int height = surface.get_height();
     
-    auto original = surface.copy();
+    // Read from a scratch snapshot so writes don't feed back into sampling
+    ScratchScope scratch;
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    uint8_t* original = scratch.alloc<uint8_t>(bytes);
+    surface.read_pixels(original);
     float two_pi_over_wavelength = 6.28318530718f / wavelength;
     
     // Bilinear interpolation helper
@@ -257,10 +306,10 @@ void Effects::ripple(Surface& surface, int center_x, int center_y, float amplitu
         float tx = fx - x0;
         float ty = fy - y0;
         
-        Color c00 = original->get_pixel(x0, y0);
-        Color c10 = original->get_pixel(x1, y0);
-        Color c01 = original->get_pixel(x0, y1);
-        Color c11 = original->get_pixel(x1, y1);
+        Color c00 = read_pixel(original, width, x0, y0);
+        Color c10 = read_pixel(original, width, x1, y0);
+        Color c01 = read_pixel(original, width, x0, y1);
+        Color c11 = read_pixel(original, width, x1, y1);
         
         // Bilinear interpolate each channel
         auto lerp = [](float a, float b, float t) { return a + t * (b - a); };
@@ -298,6 +347,7 @@ void Effects::ripple(Surface& surface, int center_x, int center_y, float amplitu
 
 void Effects::brightness(Surface& surface, float amount)
 {
+    ProfileScope scope("Effects::brightness");
     int width = surface.get_width();
     int height = surface.get_height();
     int adjustment = static_cast<int>(amount * 255);
@@ -315,6 +365,7 @@ void Effects::brightness(Surface& surface, float amount)
 
 void Effects::contrast(Surface& surface, float amount)
 {
+    ProfileScope scope("Effects::contrast");
     int width = surface.get_width();
     int height = surface.get_height();
     float factor = (259.0f * (amount * 255.0f + 255.0f)) / (255.0f * (259.0f - amount * 255.0f));
@@ -332,6 +383,7 @@ void Effects::contrast(Surface& surface, float amount)
 
 void Effects::saturation(Surface& surface, float amount)
 {
+    ProfileScope scope("Effects::saturation");
     int width = surface.get_width();
     int height = surface.get_height();
     
@@ -350,6 +402,7 @@ void Effects::saturation(Surface& surface, float amount)
 
 void Effects::hue_shift(Surface& surface, float degrees)
 {
+    ProfileScope scope("Effects::hue_shift");
     int width = surface.get_width();
     int height = surface.get_height();
     
@@ -379,6 +432,7 @@ void Effects::hue_shift(Surface& surface, float degrees)
 
 void Effects::invert(Surface& surface)
 {
+    ProfileScope scope("Effects::invert");
     int width = surface.get_width();
     int height = surface.get_height();
     
@@ -395,11 +449,13 @@ void Effects::invert(Surface& surface)
 
 void Effects::grayscale(Surface& surface)
 {
+    ProfileScope scope("Effects::grayscale");
     saturation(surface, 0.0f);
 }
 
 void Effects::sepia(Surface& surface, float strength)
 {
+    ProfileScope scope("Effects::sepia");
     int width = surface.get_width();
     int height = surface.get_height();
     float inv_strength = 1.0f - strength;
@@ -423,6 +479,7 @@ void Effects::sepia(Surface& surface, float strength)
 
 void Effects::blend(Surface& dest, const Surface& source, float alpha)
 {
+    ProfileScope scope("Effects::blend");
     int width = std::min(dest.get_width(), source.get_width());
     int height = std::min(dest.get_height(), source.get_height());
     float inv_alpha = 1.0f - alpha;
@@ -443,6 +500,7 @@ void Effects::blend(Surface& dest, const Surface& source, float alpha)
 void Effects::linear_gradient(Surface& surface, int x1, int y1, int x2, int y2,
                                const Color& color1, const Color& color2)
 {
+    ProfileScope scope("Effects::linear_gradient");
     int width = surface.get_width();
     int height = surface.get_height();
     
@@ -473,6 +531,7 @@ void Effects::linear_gradient(Surface& surface, int x1, int y1, int x2, int y2,
 void Effects::radial_gradient(Surface& surface, int cx, int cy, int radius,
                                const Color& inner_color, const Color& outer_color)
 {
+    ProfileScope scope("Effects::radial_gradient");
     int width = surface.get_width();
     int height = surface.get_height();
     float radius_f = static_cast<float>(radius);
@@ -496,6 +555,7 @@ void Effects::radial_gradient(Surface& surface, int cx, int cy, int radius,
 
 void Effects::noise(Surface& surface, float amount)
 {
+    ProfileScope scope("Effects::noise");
     int width = surface.get_width();
     int height = surface.get_height();
     
@@ -519,6 +579,7 @@ void Effects::noise(Surface& surface, float amount)
 
 void Effects::perlin_noise(Surface& surface, float scale, int octaves)
 {
+    ProfileScope scope("Effects::perlin_noise");
     // Simple Perlin-like noise implementation
     int width = surface.get_width();
     int height = surface.get_height();
@@ -589,6 +650,8 @@ void Effects::perlin_noise(Surface& surface, float scale, int octaves)
 std::shared_ptr<Surface> Effects::drop_shadow(const Surface& source, int offset_x, int offset_y,
                                                 int blur_radius, const Color& shadow_color)
 {
+    ProfileScope scope("Effects::drop_shadow");
+    AllocationTag tag("Effects::drop_shadow");
     int width = source.get_width() + std::abs(offset_x) + blur_radius * 2;
     int height = source.get_height() + std::abs(offset_y) + blur_radius * 2;
     
@@ -720,6 +783,8 @@ void BlurredSurface::update(float dt)
 
 std::shared_ptr<Surface> BlurredSurface::render() const
 {
+    AllocationTag tag("BlurredSurface::render");
+    
     if (current_radius_ <= 0.5f) {
         // No blur, just return a copy
         return surface_->copy();
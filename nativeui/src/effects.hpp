@@ -50,6 +50,7 @@ public:
     // Noise generation
     static void noise(Surface& surface, float amount);  // 0.0 to 1.0
     static void perlin_noise(Surface& surface, float scale, int octaves = 4);
+    static void seed(uint32_t value);  // Reproducible noise (tests, golden images); per thread
     
     // Shadow effect
     static std::shared_ptr<Surface> drop_shadow(const Surface& source, int offset_x, int offset_y, 
@@ -61,7 +62,7 @@ private:
     static void vertical_box_blur(Surface& surface, int radius);
     static std::vector<float> generate_gaussian_kernel(float sigma);
     
-    // Random number generator for noise
+    // Random number generator for noise (thread-local)
     static std::mt19937& get_rng();
 };
 
@@ -0,0 +1,293 @@
+#include "event_record.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace nativeui {
+
+// File layout (little endian):
+//   "PDEV" u8 version, u8[3] reserved, u32 events, u32 frames, f32 mean dt
+//   per event: u8 type | ctrl<<4 | shift<<5 | alt<<6, varint frame delta,
+//              varint ms delta, then a type-specific payload (signed values
+//              zigzag-encoded, mouse motion relative to the last position)
+static const char kMagic[4] = {'P', 'D', 'E', 'V'};
+static const uint8_t kVersion = 1;
+
+namespace {
+
+class Writer {
+public:
+    void u8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) u8(static_cast<uint8_t>(v >> (i * 8)));
+    }
+    void varint(uint32_t v) {
+        while (v >= 0x80) {
+            u8(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        u8(static_cast<uint8_t>(v));
+    }
+    void svarint(int32_t v) {
+        varint((static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31));
+    }
+
+    std::string out;
+};
+
+class Reader {
+public:
+    Reader(const std::string& data) : data_(data), pos_(0) {}
+
+    uint8_t u8() {
+        if (pos_ >= data_.size()) fail("truncated");
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(u8()) << (i * 8);
+        return v;
+    }
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b = u8();
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        fail("bad varint");
+        return 0;
+    }
+    int32_t svarint() {
+        uint32_t v = varint();
+        return static_cast<int32_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+    std::string bytes(size_t n) {
+        if (n > data_.size() - pos_) fail("truncated");
+        std::string s = data_.substr(pos_, n);
+        pos_ += n;
+        return s;
+    }
+
+    static void fail(const char* what) {
+        throw std::runtime_error(std::string("Invalid event recording: ") + what);
+    }
+
+private:
+    const std::string& data_;
+    size_t pos_;
+};
+
+} // namespace
+
+// ============================================================================
+// EventRecorder
+// ============================================================================
+
+void EventRecorder::begin(uint64_t frame_id, uint32_t now_ms)
+{
+    clear();
+    start_frame_ = frame_id;
+    start_ms_ = now_ms;
+}
+
+void EventRecorder::record(const Event& event, uint64_t frame_id, uint32_t now_ms)
+{
+    if (event.type == EventType::None) return;
+
+    RecordedEvent rec;
+    rec.event = event;
+    rec.frame = static_cast<uint32_t>(frame_id - start_frame_);
+    rec.time_ms = now_ms - start_ms_;
+    // Keep time monotonic so deltas stay unsigned
+    if (!events_.empty() && static_cast<int32_t>(rec.time_ms - events_.back().time_ms) < 0) {
+        rec.time_ms = events_.back().time_ms;
+    }
+    events_.push_back(std::move(rec));
+}
+
+void EventRecorder::on_frame(float delta_time)
+{
+    frames_++;
+    total_dt_ += delta_time;
+}
+
+void EventRecorder::clear()
+{
+    events_.clear();
+    frames_ = 0;
+    total_dt_ = 0.0;
+}
+
+void EventRecorder::save(const std::string& path) const
+{
+    Writer w;
+    w.out.append(kMagic, sizeof(kMagic));
+    w.u8(kVersion);
+    w.u8(0); w.u8(0); w.u8(0);
+    w.u32(static_cast<uint32_t>(events_.size()));
+    w.u32(frames_);
+    float dt = get_mean_dt();
+    uint32_t dt_bits;
+    std::memcpy(&dt_bits, &dt, sizeof(dt_bits));
+    w.u32(dt_bits);
+
+    uint32_t last_frame = 0, last_ms = 0;
+    int last_x = 0, last_y = 0;
+    for (const auto& rec : events_) {
+        const Event& e = rec.event;
+        w.u8(static_cast<uint8_t>(static_cast<int>(e.type) |
+                                  (e.ctrl ? 0x10 : 0) | (e.shift ? 0x20 : 0) | (e.alt ? 0x40 : 0)));
+        w.varint(rec.frame - last_frame);
+        w.varint(rec.time_ms - last_ms);
+        last_frame = rec.frame;
+        last_ms = rec.time_ms;
+
+        switch (e.type) {
+            case EventType::KeyDown:
+            case EventType::KeyUp:
+                w.svarint(e.key);
+                break;
+            case EventType::MouseButtonDown:
+            case EventType::MouseButtonUp:
+            case EventType::MouseMotion:
+                w.svarint(e.mouse_x - last_x);
+                w.svarint(e.mouse_y - last_y);
+                last_x = e.mouse_x;
+                last_y = e.mouse_y;
+                if (e.type != EventType::MouseMotion) w.u8(static_cast<uint8_t>(e.mouse_button));
+                break;
+            case EventType::MouseWheel:
+                w.svarint(e.wheel_x);
+                w.svarint(e.wheel_y);
+                break;
+            case EventType::TextInput:
+                w.varint(static_cast<uint32_t>(e.text.size()));
+                w.out += e.text;
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open event recording for writing: " + path);
+    }
+    file.write(w.out.data(), static_cast<std::streamsize>(w.out.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write event recording: " + path);
+    }
+}
+
+// ============================================================================
+// EventReplay
+// ============================================================================
+
+EventReplay::EventReplay(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open event recording: " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader r(data);
+    if (r.bytes(4) != std::string(kMagic, sizeof(kMagic))) Reader::fail("not a .pdev file");
+    if (r.u8() != kVersion) Reader::fail("unsupported version");
+    r.u8(); r.u8(); r.u8();
+    uint32_t count = r.u32();
+    frames_ = r.u32();
+    uint32_t dt_bits = r.u32();
+    std::memcpy(&recorded_dt_, &dt_bits, sizeof(recorded_dt_));
+
+    // Each event takes at least 3 bytes; reject counts the file cannot hold
+    if (count > data.size() / 3) Reader::fail("event count exceeds file size");
+    events_.reserve(count);
+
+    uint32_t frame = 0, time_ms = 0;
+    int x = 0, y = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        RecordedEvent rec;
+        Event& e = rec.event;
+        uint8_t head = r.u8();
+        int type = head & 0x0F;
+        if (type > static_cast<int>(EventType::TextInput)) Reader::fail("unknown event type");
+        e.type = static_cast<EventType>(type);
+        e.ctrl = (head & 0x10) != 0;
+        e.shift = (head & 0x20) != 0;
+        e.alt = (head & 0x40) != 0;
+        frame += r.varint();
+        time_ms += r.varint();
+        rec.frame = frame;
+        rec.time_ms = time_ms;
+
+        switch (e.type) {
+            case EventType::KeyDown:
+            case EventType::KeyUp:
+                e.key = r.svarint();
+                break;
+            case EventType::MouseButtonDown:
+            case EventType::MouseButtonUp:
+            case EventType::MouseMotion:
+                x += r.svarint();
+                y += r.svarint();
+                e.mouse_x = x;
+                e.mouse_y = y;
+                if (e.type != EventType::MouseMotion) e.mouse_button = r.u8();
+                break;
+            case EventType::MouseWheel:
+                e.wheel_x = r.svarint();
+                e.wheel_y = r.svarint();
+                break;
+            case EventType::TextInput:
+                e.text = r.bytes(r.varint());
+                break;
+            default:
+                break;
+        }
+        events_.push_back(std::move(rec));
+    }
+}
+
+EventReplay::EventReplay(const EventRecorder& recorder)
+    : events_(recorder.get_events())
+    , frames_(recorder.get_frame_count())
+    , recorded_dt_(recorder.get_mean_dt())
+{
+}
+
+void EventReplay::begin(uint64_t frame_id, uint32_t now_ms)
+{
+    position_ = 0;
+    start_frame_ = frame_id;
+    start_ms_ = now_ms;
+}
+
+bool EventReplay::next(uint64_t frame_id, uint32_t now_ms, Event& event)
+{
+    if (is_finished()) return false;
+    const RecordedEvent& rec = events_[position_];
+
+    bool due;
+    if (mode_ == ReplayMode::Frames) {
+        due = frame_id - start_frame_ >= rec.frame;
+    } else if (recorded_dt_ > 0.0f) {
+        // Replayed time advances one fixed step per frame, never with the wall clock
+        double elapsed = static_cast<double>(frame_id - start_frame_) * recorded_dt_ * 1000.0;
+        due = elapsed >= rec.time_ms;
+    } else {
+        // No frames recorded, so no step to replay on
+        double elapsed = static_cast<double>(now_ms - start_ms_) * speed_;
+        due = elapsed >= rec.time_ms;
+    }
+    if (!due) return false;
+
+    event = rec.event;
+    event.timestamp = 0;  // Stamped on delivery
+    position_++;
+    return true;
+}
+
+} // namespace nativeui
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "window.hpp"
+
+namespace nativeui {
+
+/**
+ * RecordedEvent - Event with its position in the recording
+ */
+struct RecordedEvent {
+    Event event;
+    uint32_t frame = 0;    // Frames presented since recording began
+    uint32_t time_ms = 0;  // Milliseconds since recording began
+};
+
+/**
+ * EventRecorder - Captures a window's event stream for later replay
+ *
+ * Attach with Window::start_recording(). Every event the window hands out
+ * (SDL, injected or replayed) is stored with its frame offset and time.
+ * save() writes a compact binary file (.pdev): a fixed header followed by
+ * varint-encoded deltas, typically 4-6 bytes per mouse event.
+ */
+class EventRecorder {
+public:
+    EventRecorder() = default;
+
+    // Called by Window
+    void begin(uint64_t frame_id, uint32_t now_ms);
+    void record(const Event& event, uint64_t frame_id, uint32_t now_ms);
+    void on_frame(float delta_time);
+
+    // Write the recording; throws std::runtime_error on I/O failure
+    void save(const std::string& path) const;
+
+    void clear();
+
+    const std::vector<RecordedEvent>& get_events() const { return events_; }
+    size_t get_event_count() const { return events_.size(); }
+    uint32_t get_frame_count() const { return frames_; }
+    uint32_t get_duration_ms() const { return events_.empty() ? 0 : events_.back().time_ms; }
+
+    // Mean frame time while recording (seconds, 0 if no frames)
+    float get_mean_dt() const { return frames_ > 0 ? static_cast<float>(total_dt_ / frames_) : 0.0f; }
+
+private:
+    std::vector<RecordedEvent> events_;
+    uint64_t start_frame_ = 0;
+    uint32_t start_ms_ = 0;
+    uint32_t frames_ = 0;
+    double total_dt_ = 0.0;
+};
+
+/**
+ * ReplayMode - How an EventReplay schedules events
+ */
+enum class ReplayMode {
+    Frames,    // On the recorded frame offset, as fast as frames render
+    Realtime   // On the recorded timestamps, frames paced to wall time scaled by speed
+};
+
+/**
+ * EventReplay - Feeds a recording back through a window
+ *
+ * Attach with Window::start_replay(). While active, the window delivers the
+ * recorded events in place of live input (Quit still comes through). Both
+ * modes run with the recorded dt as fixed timestep and schedule events on
+ * that frame clock, so the same events land on the same frames with the same
+ * dt on every run and a reported stutter can be profiled exactly. Realtime
+ * only paces the frames to the recording's speed (or a multiple of it).
+ */
+class EventReplay {
+public:
+    // Load a .pdev file; throws std::runtime_error if missing or malformed
+    explicit EventReplay(const std::string& path);
+    explicit EventReplay(const EventRecorder& recorder);
+
+    void set_mode(ReplayMode mode) { mode_ = mode; }
+    ReplayMode get_mode() const { return mode_; }
+
+    // Realtime playback rate (2.0 = twice as fast)
+    void set_speed(float speed) { speed_ = speed > 0.0f ? speed : 1.0f; }
+    float get_speed() const { return speed_; }
+
+    // Called by Window
+    void begin(uint64_t frame_id, uint32_t now_ms);
+    bool next(uint64_t frame_id, uint32_t now_ms, Event& event);
+
+    bool is_finished() const { return position_ >= events_.size(); }
+    size_t get_position() const { return position_; }
+    size_t get_event_count() const { return events_.size(); }
+    uint32_t get_frame_count() const { return frames_; }
+    float get_recorded_dt() const { return recorded_dt_; }
+
+private:
+    std::vector<RecordedEvent> events_;
+    uint32_t frames_ = 0;
+    float recorded_dt_ = 0.0f;
+
+    ReplayMode mode_ = ReplayMode::Frames;
+    float speed_ = 1.0f;
+    size_t position_ = 0;
+    uint64_t start_frame_ = 0;
+    uint32_t start_ms_ = 0;
+};
+
+} // namespace nativeui
@@ -1,201 +1,741 @@
 #include "font.hpp"
+#include "font_index.hpp"
+#include "glyph_atlas.hpp"
+#include "text_cache.hpp"
+#include "profiler.hpp"
+#include "memory_tracker.hpp"
+#include "surface_raster.hpp"
+#include "thread_pool.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <iostream>
 #include <stdexcept>
 #include <filesystem>
 #include <algorithm>
-
-// Define common font locations for Windows (simplistic)
-#ifdef _WIN32
-const std::string SYSTEM_FONT_DIR = "C:\\Windows\\Fonts\\";
-#else
-const std::string SYSTEM_FONT_DIR = "/usr/share/fonts/"; // Fallback
-#endif
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace nativeui {
 
 struct Font::Impl {
     TTF_Font* font = nullptr;
+    std::mutex mutex;  // SDL_ttf fonts are not reentrant; also guards the tables below
+    std::string path;
+    int size = 0;
+
+    // More handles on the same file and size, one per pool thread rasterizing
+    // for prepare() at once; idle ones wait here until prepare() returns
+    std::vector<TTF_Font*> worker_fonts;
+    std::mutex worker_mutex;
+
+    struct Glyph {
+        GlyphSlot slot;         // No pixels for blank glyphs (space)
+        int left = 0, top = 0;  // Coverage offset from the pen position / line top
+        int minx = 0, maxx = 0, advance = 0;
+    };
+    std::unordered_map<uint32_t, Glyph> glyphs;
+    std::unordered_map<uint64_t, int> kerning;  // Keyed by (previous << 32 | next)
+    int height = 0;
+    int ascent = 0;
+    int line_skip = 0;
+
+    ~Impl() {
+        for (const auto& entry : glyphs) GlyphAtlas::instance().release(entry.second.slot);
+    }
+
+    const Glyph& glyph(uint32_t cp);
+    // Rasterize with `face` (font, or a worker handle) without touching the tables
+    Glyph rasterize(TTF_Font* face, uint32_t cp) const;
+    int kern(uint32_t previous, uint32_t next);
+
+    // Pen walk over text[begin, end) as one line: emit(glyph, pen_x) per
+    // character; returns the leftmost ink/pen position (<= 0) and sets
+    // `right` to the rightmost
+    template <typename Emit>
+    int walk(const std::string& text, size_t begin, size_t end, int& right, Emit&& emit);
+
+    // Greedy word wrap to wrap_width pixels; byte range of each line
+    std::vector<std::pair<size_t, size_t>> wrap(const std::string& text, int wrap_width);
+
+    void measure(const std::string& text, TextMetrics& metrics);
+
+    // Glyphs of text[begin, end) appended to run at line top y; returns the line width
+    int append_line(GlyphRun& run, const std::string& text, size_t begin, size_t end, int y);
 };
 
-void Font::init() {
+namespace {
+
+// prepare() rasterizes fewer new glyphs than this on the caller
+const int kParallelGlyphs = 32;
+
+// Next code point of a UTF-8 string; malformed bytes decode as U+FFFD
+uint32_t next_code_point(const std::string& s, size_t& i)
+{
+    unsigned char c = static_cast<unsigned char>(s[i++]);
+    if (c < 0x80) return c;
+    int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+    if (extra < 0) return 0xFFFD;
+    uint32_t cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        if (i >= s.size() || (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | (static_cast<unsigned char>(s[i++]) & 0x3F);
+    }
+    return cp;
+}
+
+} // namespace
+
+const Font::Impl::Glyph& Font::Impl::glyph(uint32_t cp)
+{
+    auto it = glyphs.find(cp);
+    if (it != glyphs.end()) return it->second;
+    return glyphs.emplace(cp, rasterize(font, cp)).first->second;
+}
+
+Font::Impl::Glyph Font::Impl::rasterize(TTF_Font* face, uint32_t cp) const
+{
+    Glyph g;
+    int miny = 0, maxy = 0;
+    TTF_GlyphMetrics32(face, cp, &g.minx, &g.maxx, &miny, &maxy, &g.advance);
+
+    SDL_Surface* surface = TTF_RenderGlyph32_Blended(face, cp, SDL_Color{255, 255, 255, 255});
+    if (surface && surface->format->BytesPerPixel == 4) {
+        // Coverage is the alpha channel; only its ink bounds are kept
+        int w = surface->w, h = surface->h;
+        std::vector<uint8_t> alpha(static_cast<size_t>(w) * h);
+        int x0 = w, y0 = h, x1 = 0, y1 = 0;
+        SDL_LockSurface(surface);
+        for (int y = 0; y < h; ++y) {
+            const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch;
+            for (int x = 0; x < w; ++x) {
+                uint8_t r, gr, b, a;
+                SDL_GetRGBA(*reinterpret_cast<const uint32_t*>(row + x * 4), surface->format, &r, &gr, &b, &a);
+                alpha[static_cast<size_t>(y) * w + x] = a;
+                if (a == 0) continue;
+                x0 = std::min(x0, x); x1 = std::max(x1, x + 1);
+                y0 = std::min(y0, y); y1 = std::max(y1, y + 1);
+            }
+        }
+        SDL_UnlockSurface(surface);
+
+        if (x0 < x1) {
+            // SDL_ttf 2.0.18+ renders a glyph in its line box (baseline at the
+            // ascent, pen moved right by a negative minx); older versions
+            // return just the ink box
+            int origin_x = h == height ? std::max(0, -g.minx) : -g.minx;
+            int origin_y = h == height ? 0 : maxy - ascent;
+            g.left = x0 - origin_x;
+            g.top = y0 - origin_y;
+            g.slot = GlyphAtlas::instance().insert(alpha.data() + static_cast<size_t>(y0) * w + x0, w,
+                                                   x1 - x0, y1 - y0);
+        }
+    }
+    if (surface) SDL_FreeSurface(surface);
+    return g;
+}
+
+int Font::Impl::kern(uint32_t previous, uint32_t next)
+{
+    uint64_t key = (static_cast<uint64_t>(previous) << 32) | next;
+    auto it = kerning.find(key);
+    if (it != kerning.end()) return it->second;
+    int k = TTF_GetFontKerning(font) ? TTF_GetFontKerningSizeGlyphs32(font, previous, next) : 0;
+    kerning.emplace(key, k);
+    return k;
+}
+
+template <typename Emit>
+int Font::Impl::walk(const std::string& text, size_t begin, size_t end, int& right, Emit&& emit)
+{
+    int pen = 0, left = 0;
+    right = 0;
+    uint32_t previous = 0;
+    for (size_t i = begin; i < end;) {
+        uint32_t cp = next_code_point(text, i);
+        if (previous) pen += kern(previous, cp);
+        const Glyph& g = glyph(cp);
+        left = std::min(left, pen + g.minx);
+        right = std::max(right, pen + std::max(g.maxx, g.advance));
+        emit(g, pen);
+        pen += g.advance;
+        previous = cp;
+    }
+    return left;
+}
+
+std::vector<std::pair<size_t, size_t>> Font::Impl::wrap(const std::string& text, int wrap_width)
+{
+    std::vector<std::pair<size_t, size_t>> lines;
+    size_t start = 0, space = std::string::npos;
+    int pen = 0;
+    uint32_t previous = 0;
+    auto end_line = [&](size_t end, size_t next) {
+        while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t')) --end;
+        lines.emplace_back(start, end);
+        start = next;
+        space = std::string::npos;
+        pen = 0;
+        previous = 0;
+    };
+
+    for (size_t i = 0; i < text.size();) {
+        size_t at = i;
+        uint32_t cp = next_code_point(text, i);
+        if (cp == '\n') {
+            end_line(at, i);
+            continue;
+        }
+        int kerned = previous ? pen + kern(previous, cp) : pen;
+        const Glyph& g = glyph(cp);
+        if (kerned + std::max(g.maxx, g.advance) > wrap_width && at > start && cp != ' ') {
+            // Break after the last space, or inside a word too long for a line
+            if (space != std::string::npos) {
+                end_line(space, space + 1);
+            } else {
+                end_line(at, at);
+            }
+            i = start;
+            continue;
+        }
+        if (cp == ' ' || cp == '\t') space = at;
+        pen = kerned + g.advance;
+        previous = cp;
+    }
+    end_line(text.size(), text.size());
+    return lines;
+}
+
+int Font::Impl::append_line(GlyphRun& run, const std::string& text, size_t begin, size_t end, int y)
+{
+    size_t first = run.glyphs.size();
+    int right = 0;
+    int left = walk(text, begin, end, right, [&](const Glyph& g, int pen) {
+        if (!g.slot.pixels) return;
+        run.glyphs.push_back(GlyphRun::Glyph{g.slot.pixels, g.slot.pitch, pen + g.left, y + g.top,
+                                             g.slot.rect.width(), g.slot.rect.height()});
+    });
+    // Ink left of the first pen position shifts the whole line right
+    for (size_t k = first; k < run.glyphs.size(); ++k) run.glyphs[k].x -= left;
+    return right - left;
+}
+
+void Font::Impl::measure(const std::string& text, TextMetrics& m)
+{
+    m.byte_offsets.reserve(text.size() + 1);
+    m.positions.reserve(text.size() + 1);
+    int pen = 0, left = 0, right = 0;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < text.size();) {
+        size_t at = i;
+        uint32_t cp = next_code_point(text, i);
+        if (previous) pen += kern(previous, cp);
+        const Glyph& g = glyph(cp);
+        left = std::min(left, pen + g.minx);
+        right = std::max(right, pen + std::max(g.maxx, g.advance));
+        m.byte_offsets.push_back(at);
+        m.positions.push_back(pen);
+        pen += g.advance;
+        previous = cp;
+    }
+    m.byte_offsets.push_back(text.size());
+    m.positions.push_back(pen);
+    for (int& x : m.positions) x -= left;
+
+    m.advances.resize(m.positions.size() - 1);
+    for (size_t k = 0; k < m.advances.size(); ++k) m.advances[k] = m.positions[k + 1] - m.positions[k];
+    m.width = right - left;
+    m.height = height;
+}
+
+namespace {
+
+// Ink outside the run's box (tall accents in some fonts) is cropped, as SDL_ttf does
+void crop_to_box(GlyphRun& run)
+{
+    for (GlyphRun::Glyph& g : run.glyphs) {
+        int x0 = std::max(0, g.x), x1 = std::min(run.width, g.x + g.width);
+        int y0 = std::max(0, g.y), y1 = std::min(run.height, g.y + g.height);
+        g.coverage += static_cast<size_t>(y0 - g.y) * g.pitch + (x0 - g.x);
+        g.x = x0;
+        g.y = y0;
+        g.width = std::max(0, x1 - x0);
+        g.height = std::max(0, y1 - y0);
+    }
+}
+
+// Straight color with coverage as alpha, like TTF_RenderUTF8_Blended
+std::shared_ptr<Surface> colorize(const GlyphRun& run, const Color& color, const char* origin)
+{
+    if (run.width <= 0 || run.height <= 0) return nullptr;
+
+    std::shared_ptr<Surface> result;
+    {
+        AllocationTag tag(origin);
+        result = std::make_shared<Surface>(run.width, run.height);
+    }
+    result->fill(Color(color.r, color.g, color.b, 0));
+    for (const GlyphRun::Glyph& g : run.glyphs) {
+        for (int y = 0; y < g.height; ++y) {
+            const uint8_t* c = g.coverage + static_cast<size_t>(y) * g.pitch;
+            uint8_t* d = result->get_data() + (g.y + y) * result->get_pitch() + static_cast<size_t>(g.x) * 4;
+            for (int x = 0; x < g.width; ++x, d += 4) {
+                uint8_t a = static_cast<uint8_t>(c[x] * color.a / 255);
+                if (a > d[3]) d[3] = a;  // Overlapping glyphs keep the stronger coverage
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// Guards TTF_OpenFont/TTF_CloseFont, which share the FreeType library.
+// Leaked: FontCache's statics close fonts during static destruction.
+static std::mutex& library_mutex() {
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+}
+
+static std::atomic<size_t> open_fonts{0};
+static bool ttf_ready = false;  // Guarded by library_mutex()
+
+// library_mutex() held
+static void ensure_ttf() {
+    if (ttf_ready) return;
     if (TTF_Init() == -1) {
         throw std::runtime_error("TTF_Init: " + std::string(TTF_GetError()));
     }
+    ttf_ready = true;
+}
+
+void Font::init() {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    ensure_ttf();
 }
 
 void Font::quit() {
-    TTF_Quit();
+    // Cached fonts close here; fonts still held elsewhere keep TTF alive.
+    // Cached layouts hold fonts too.
+    TextLayoutCache::instance().clear();
+    FontCache::clear();
+    std::lock_guard<std::mutex> lock(library_mutex());
+    if (ttf_ready && open_fonts == 0) {
+        TTF_Quit();
+        ttf_ready = false;
+    }
 }
 
 Font::Font(const std::string& path, int size) : impl_(std::make_unique<Impl>()) {
+    std::lock_guard<std::mutex> lock(library_mutex());
+    ensure_ttf();
     impl_->font = TTF_OpenFont(path.c_str(), size);
     if (!impl_->font) {
         throw std::runtime_error("TTF_OpenFont: " + std::string(TTF_GetError()) + " (Path: " + path + ")");
     }
+    impl_->height = TTF_FontHeight(impl_->font);
+    impl_->ascent = TTF_FontAscent(impl_->font);
+    impl_->line_skip = TTF_FontLineSkip(impl_->font);
+    impl_->path = path;
+    impl_->size = size;
+    open_fonts++;
 }
 
 Font::~Font() {
-    if (impl_->font) {
+    if (impl_ && impl_->font) {
+        std::lock_guard<std::mutex> lock(library_mutex());
         TTF_CloseFont(impl_->font);
+        for (TTF_Font* face : impl_->worker_fonts) TTF_CloseFont(face);
+        open_fonts -= 1 + impl_->worker_fonts.size();
     }
 }
 
-std::shared_ptr<Surface> Font::render(const std::string& text, const Color& color) {
-    if (!impl_->font || text.empty()) return nullptr;
+void Font::prepare(const std::vector<std::string>& texts) {
+    if (!impl_->font) return;
+    ProfileScope scope("Font::prepare");
 
-    SDL_Color sdl_color = { color.r, color.g, color.b, color.a };
-    
-    // Use blended (high quality, alpha) rendering
-    SDL_Surface* surface = TTF_RenderUTF8_Blended(impl_->font, text.c_str(), sdl_color);
-    
-    if (!surface) {
-        // If empty text or error, return null or throw?
-        // TTF_RenderText returns null on error.
-        return nullptr;
+    // Distinct code points without a glyph yet
+    std::vector<uint32_t> missing;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        std::unordered_set<uint32_t> seen;
+        for (const std::string& text : texts) {
+            for (size_t i = 0; i < text.size();) {
+                uint32_t cp = next_code_point(text, i);
+                if (cp != '\n' && !impl_->glyphs.count(cp) && seen.insert(cp).second) missing.push_back(cp);
+            }
+        }
+        if (missing.size() < static_cast<size_t>(kParallelGlyphs)) {
+            for (uint32_t cp : missing) impl_->glyph(cp);
+            return;
+        }
     }
 
-    // Convert SDL_Surface to our Surface
-    // SDL_ttf blended mode returns ARGB8888 usually (32-bit)
-    if (surface->format->BytesPerPixel != 4) {
-         SDL_FreeSurface(surface);
-         return nullptr; // Only support 32-bit for now simplicity
-    }
+    ThreadPool::instance().parallel_for(0, static_cast<int>(missing.size()), kParallelGlyphs / 2,
+                                        [&](int begin, int end) {
+        // Borrow an idle handle on this file and size, or open one
+        TTF_Font* face = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(impl_->worker_mutex);
+            if (!impl_->worker_fonts.empty()) {
+                face = impl_->worker_fonts.back();
+                impl_->worker_fonts.pop_back();
+            }
+        }
+        if (!face) {
+            std::lock_guard<std::mutex> lock(library_mutex());
+            face = TTF_OpenFont(impl_->path.c_str(), impl_->size);
+            if (face) open_fonts++;
+        }
 
-    auto result = std::make_shared<Surface>(surface->w, surface->h);
-    
-    // Copy pixels
-    // We assume SDL surface is locked or doesn't need locking for software surfaces usually
-    // But safe to lock.
-    SDL_LockSurface(surface);
-    
-    uint8_t* src_pixels = static_cast<uint8_t*>(surface->pixels);
-    int pitch = surface->pitch;
-    
-    for (int y = 0; y < surface->h; ++y) {
-        for (int x = 0; x < surface->w; ++x) {
-            // Extract from SDL surface (BGRA or RGBA depending on endian)
-            // TTF blended is typically ARGB (on big endian) or BGRA (little endian)
-            // Actually it depends. Let's rely on GetRGBA
-            uint32_t pixel = *reinterpret_cast<uint32_t*>(src_pixels + y * pitch + x * 4);
-            uint8_t r, g, b, a;
-            SDL_GetRGBA(pixel, surface->format, &r, &g, &b, &a);
-            
-            result->set_pixel(x, y, Color(r, g, b, a));
+        std::vector<std::pair<uint32_t, Impl::Glyph>> done;
+        done.reserve(end - begin);
+        if (face) {
+            for (int i = begin; i < end; ++i) done.emplace_back(missing[i], impl_->rasterize(face, missing[i]));
+            std::lock_guard<std::mutex> lock(impl_->worker_mutex);
+            impl_->worker_fonts.push_back(face);
+        }
+
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!face) {
+            for (int i = begin; i < end; ++i) impl_->glyph(missing[i]);
         }
+        for (auto& entry : done) {
+            // Drawing may have rasterized it meanwhile; keep the first copy
+            if (!impl_->glyphs.emplace(entry.first, entry.second).second) {
+                GlyphAtlas::instance().release(entry.second.slot);
+            }
+        }
+    }, TaskPriority::Normal);
+
+    // Don't keep a face per worker alive between batches, out of sight of
+    // FontCache's handle cap and the memory evictor. A prepare() still
+    // running on this font closes the handles it returns when it finishes.
+    std::vector<TTF_Font*> idle;
+    {
+        std::lock_guard<std::mutex> lock(impl_->worker_mutex);
+        idle.swap(impl_->worker_fonts);
     }
-    
-    SDL_UnlockSurface(surface);
-    SDL_FreeSurface(surface);
-    
-    return result;
+    if (!idle.empty()) {
+        std::lock_guard<std::mutex> lock(library_mutex());
+        for (TTF_Font* face : idle) TTF_CloseFont(face);
+        open_fonts -= idle.size();
+    }
+}
+
+std::shared_ptr<Surface> Font::render(const std::string& text, const Color& color) {
+    if (!impl_->font || text.empty()) return nullptr;
+    ProfileScope scope("Font::render");
+    return colorize(layout(text), color, "Font::render");
 }
 
 std::shared_ptr<Surface> Font::render_wrapped(const std::string& text, const Color& color, int wrap_width) {
     if (!impl_->font || text.empty()) return nullptr;
+    ProfileScope scope("Font::render_wrapped");
+    return colorize(layout_wrapped(text, wrap_width), color, "Font::render_wrapped");
+}
 
-    SDL_Color sdl_color = { color.r, color.g, color.b, color.a };
-    
-    // Use wrapped rendering
-    SDL_Surface* surface = TTF_RenderUTF8_Blended_Wrapped(impl_->font, text.c_str(), sdl_color, wrap_width);
-    
-    if (!surface) {
-        return nullptr;
-    }
+GlyphRun Font::layout(const std::string& text) {
+    GlyphRun run;
+    if (!impl_->font) return run;
 
-    // Convert SDL_Surface to our Surface (duplicate logic for now to avoid refactor overhead)
-    // SDL_ttf blended mode returns 32-bit usually
-    if (surface->format->BytesPerPixel != 4) {
-         SDL_FreeSurface(surface);
-         return nullptr; 
-    }
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    run.height = impl_->height;
+    run.width = impl_->append_line(run, text, 0, text.size(), 0);
+    crop_to_box(run);
+    return run;
+}
 
-    auto result = std::make_shared<Surface>(surface->w, surface->h);
-    
-    SDL_LockSurface(surface);
-    
-    uint8_t* src_pixels = static_cast<uint8_t*>(surface->pixels);
-    int pitch = surface->pitch;
-    
-    for (int y = 0; y < surface->h; ++y) {
-        for (int x = 0; x < surface->w; ++x) {
-            uint32_t pixel = *reinterpret_cast<uint32_t*>(src_pixels + y * pitch + x * 4);
-            uint8_t r, g, b, a;
-            SDL_GetRGBA(pixel, surface->format, &r, &g, &b, &a);
-            result->set_pixel(x, y, Color(r, g, b, a));
-        }
+GlyphRun Font::layout_wrapped(const std::string& text, int wrap_width) {
+    if (wrap_width <= 0) return layout(text);
+    GlyphRun run;
+    if (!impl_->font) return run;
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto lines = impl_->wrap(text, wrap_width);
+    int widest = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        int y = static_cast<int>(i) * impl_->line_skip;
+        widest = std::max(widest, impl_->append_line(run, text, lines[i].first, lines[i].second, y));
     }
-    
-    SDL_UnlockSurface(surface);
-    SDL_FreeSurface(surface);
-    
-    return result;
+    // Several lines fill the wrap width, as SDL_ttf's wrapped surfaces do
+    run.width = lines.size() > 1 ? std::max(widest, wrap_width) : widest;
+    run.height = impl_->height + static_cast<int>(lines.size() - 1) * impl_->line_skip;
+    crop_to_box(run);
+    return run;
+}
+
+void Font::draw_text(Surface& target, const std::string& text, int x, int y, const Color& color) {
+    if (text.empty()) return;
+    ProfileScope scope("Font::draw_text");
+    layout(text).draw(target, x, y, color);
+}
+
+size_t Font::get_open_count() {
+    return open_fonts.load();
 }
 
 int Font::get_height() const {
     if (!impl_->font) return 0;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
     return TTF_FontHeight(impl_->font);
 }
 
+TextMetrics Font::measure(const std::string& text) {
+    TextMetrics metrics;
+    if (!impl_->font) return metrics;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->measure(text, metrics);
+    return metrics;
+}
+
+std::vector<TextMetrics> Font::measure_all(const std::vector<std::string>& texts) {
+    std::vector<TextMetrics> metrics(texts.size());
+    if (!impl_->font) return metrics;
+    ProfileScope scope("Font::measure_all");
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (size_t i = 0; i < texts.size(); ++i) impl_->measure(texts[i], metrics[i]);
+    return metrics;
+}
+
+int Font::get_line_skip() const {
+    return impl_->line_skip;
+}
+
+Font::GlyphInfo Font::get_glyph(uint32_t code_point) {
+    GlyphInfo info{nullptr, 0, 0, 0, 0, 0, 0};
+    if (!impl_->font) return info;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl::Glyph& g = impl_->glyph(code_point);
+    info.coverage = g.slot.pixels;
+    info.pitch = g.slot.pitch;
+    info.left = g.left;
+    info.top = g.top;
+    info.width = g.slot.rect.width();
+    info.height = g.slot.rect.height();
+    info.advance = g.advance;
+    return info;
+}
+
+int Font::get_kerning(uint32_t previous, uint32_t next) {
+    if (!impl_->font) return 0;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->kern(previous, next);
+}
+
+std::vector<std::pair<size_t, size_t>> Font::break_lines(const std::string& text, int wrap_width) {
+    if (!impl_->font) return {};
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->wrap(text, wrap_width);
+}
+
+uint32_t Font::decode_utf8(const std::string& text, size_t& i) {
+    return next_code_point(text, i);
+}
+
 void Font::get_size(const std::string& text, int& w, int& h) {
     if (!impl_->font) { w=0; h=0; return; }
-    TTF_SizeUTF8(impl_->font, text.c_str(), &w, &h);
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    // Same metrics as layout(), so measured and drawn text agree
+    int right = 0;
+    int left = impl_->walk(text, 0, text.size(), right, [](const Impl::Glyph&, int) {});
+    w = right - left;
+    h = impl_->height;
+}
+
+// ============ GlyphRun ============
+
+void GlyphRun::draw(Surface& target, int x, int y, const Color& color) const {
+    draw(target, x, y, color, PixelRect{0, 0, target.get_width(), target.get_height()});
+}
+
+void GlyphRun::draw(Surface& target, int x, int y, const Color& color, const PixelRect& clip) const {
+    if (color.a == 0) return;
+    PixelRect area = clip.intersect(PixelRect{0, 0, target.get_width(), target.get_height()});
+    for (const Glyph& g : glyphs) {
+        PixelRect box = PixelRect{x + g.x, y + g.y, x + g.x + g.width, y + g.y + g.height}.intersect(area);
+        if (box.empty()) continue;
+        for (int ty = box.y0; ty < box.y1; ++ty) {
+            const uint8_t* c = g.coverage + static_cast<size_t>(ty - y - g.y) * g.pitch + (box.x0 - x - g.x);
+            uint8_t* d = target.get_data() + ty * target.get_pitch() + static_cast<size_t>(box.x0) * 4;
+            for (int tx = box.x0; tx < box.x1; ++tx, ++c, d += 4) {
+                if (*c) raster::blend_over(d, color.r, color.g, color.b, static_cast<uint8_t>(*c * color.a / 255));
+            }
+        }
+    }
 }
 
 // ============ FontCache ============
 
-std::map<std::pair<std::string, int>, std::shared_ptr<Font>> FontCache::cache_;
+std::list<FontCache::Entry> FontCache::lru_;
+std::unordered_map<FontCache::Key, std::list<FontCache::Entry>::iterator, FontCache::KeyHash> FontCache::index_;
+std::unordered_map<std::string, std::string> FontCache::resolved_;
+size_t FontCache::capacity_ = 32;
+size_t FontCache::hits_ = 0;
+size_t FontCache::misses_ = 0;
+size_t FontCache::evictions_ = 0;
+std::mutex FontCache::mutex_;
+
+size_t FontCache::KeyHash::operator()(const Key& key) const {
+    return std::hash<std::string>()(key.first) * 31 + static_cast<size_t>(key.second);
+}
 
 std::string FontCache::resolve_path(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = resolved_.find(name);
+        if (it != resolved_.end()) return it->second;
+    }
+    // Probe outside the lock; racing threads resolve to the same path
+    std::string path = find_path(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolved_.emplace(name, path);
+    return path;
+}
+
+std::string FontCache::find_path(const std::string& name) {
     if (std::filesystem::exists(name)) return name;
     
-    // Try system font dir
-    std::string sys_path = SYSTEM_FONT_DIR + name + ".ttf";
-    if (std::filesystem::exists(sys_path)) return sys_path;
-    
-    sys_path = SYSTEM_FONT_DIR + name;
-    if (std::filesystem::exists(sys_path)) return sys_path;
+    // Family ("DejaVu Sans"), family and style ("DejaVu Sans Bold") or file name
+    FontIndex& index = FontIndex::instance();
+    std::string path = index.find(name);
+    if (!path.empty()) return path;
     
     // Fallback: simple mapping (very basic)
     std::string lower_name = name;
     std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
     
-    std::map<std::string, std::string> font_map = {
-        {"arial", "arial.ttf"},
-        {"roboto", "arial.ttf"}, // Mapped to Arial
-        {"roboto bold", "arialbd.ttf"}, // Map to Arial Bold
-        {"segoe ui", "segoeui.ttf"},
-        {"times new roman", "times.ttf"},
-        {"verdana", "verdana.ttf"},
-        {"consolas", "consolas.ttf"}
+    static const std::unordered_map<std::string, std::string> font_map = {
+        {"arial", "arial"},
+        {"roboto", "arial"}, // Mapped to Arial
+        {"roboto bold", "arialbd"}, // Map to Arial Bold
+        {"segoe ui", "segoeui"},
+        {"times new roman", "times"},
+        {"verdana", "verdana"},
+        {"consolas", "consolas"}
     };
     
-    if (font_map.find(lower_name) != font_map.end()) {
-        sys_path = SYSTEM_FONT_DIR + font_map[lower_name];
-        if (std::filesystem::exists(sys_path)) return sys_path;
+    auto mapped = font_map.find(lower_name);
+    if (mapped != font_map.end()) {
+        path = index.find(mapped->second);
+        if (!path.empty()) return path;
     }
     
     return name; // Return original if nothing found, let TTF fail
 }
 
+// Let memory pressure drop fonts nobody else holds
+static void register_font_evictor() {
+    static std::once_flag registered;
+    std::call_once(registered, []() {
+        MemoryTracker::instance().add_evictor([](MemoryPressure) { FontCache::trim(); });
+    });
+}
+
+// A font that failed to open is tried again after this long
+static const auto kFailedOpenRetry = std::chrono::seconds(2);
+
 std::shared_ptr<Font> FontCache::get(const std::string& name, int size) {
-    std::string path = resolve_path(name);
-    auto key = std::make_pair(path, size);
+    register_font_evictor();
+    Key key(resolve_path(name), size);
+    auto now = std::chrono::steady_clock::now();
     
-    if (cache_.find(key) == cache_.end()) {
-        try {
-            cache_[key] = std::make_shared<Font>(path, size);
-        } catch (...) {
-            return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            if (it->second->font || now - it->second->opened < kFailedOpenRetry) {
+                hits_++;
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return it->second->font;
+            }
+            lru_.erase(it->second);
+            index_.erase(it);
         }
     }
     
-    return cache_[key];
+    // TTF_OpenFont reads the file; other lookups must not wait behind it
+    std::shared_ptr<Font> font;
+    try {
+        font = std::make_shared<Font>(key.first, size);
+    } catch (...) {
+        // Remembered as missing for a while, so redraws don't retry the open
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    misses_++;
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        // Another thread opened it meanwhile: share theirs (ours closes on return)
+        lru_.splice(lru_.begin(), lru_, it->second);
+        if (!it->second->font) it->second->font = font;
+        return it->second->font;
+    }
+    lru_.push_front(Entry{key, font, now});
+    index_.emplace(std::move(key), lru_.begin());
+    evict_unused(capacity_);
+    return font;
+}
+
+void FontCache::evict_unused(size_t keep) {
+    // Oldest first; fonts still held elsewhere stay open and cached
+    for (auto it = lru_.end(); lru_.size() > keep && it != lru_.begin();) {
+        --it;
+        if (it->font && it->font.use_count() > 1) continue;
+        index_.erase(it->key);
+        it = lru_.erase(it);
+        evictions_++;
+    }
 }
 
 void FontCache::clear() {
-    cache_.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    lru_.clear();
+    resolved_.clear();
+}
+
+void FontCache::forget_resolved() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolved_.clear();
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->font) {
+            ++it;
+            continue;
+        }
+        index_.erase(it->key);
+        it = lru_.erase(it);
+    }
+}
+
+size_t FontCache::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t before = lru_.size();
+    evict_unused(0);
+    return before - lru_.size();
+}
+
+void FontCache::set_capacity(size_t fonts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = fonts;
+    evict_unused(capacity_);
+}
+
+size_t FontCache::get_capacity() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+FontCacheStats FontCache::get_stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FontCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.cached = lru_.size();
+    stats.open_handles = Font::get_open_count();
+    stats.capacity = capacity_;
+    return stats;
 }
 
 } // namespace nativeui
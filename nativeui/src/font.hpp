@@ -1,19 +1,74 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <memory>
-#include <map>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <vector>
 #include "surface.hpp"
+#include "tile_bins.hpp"
 
 namespace nativeui {
 
+/**
+ * GlyphRun - Text laid out from cached glyph coverage
+ *
+ * Glyph positions are relative to the top-left of the text box (width x the
+ * font height, plus the line skip per extra line). The coverage belongs to the Font's glyphs in the GlyphAtlas, so
+ * a run must not outlive the Font that made it. Drawing tints the coverage
+ * with a color and blends it like Surface::blit_alpha of Font::render's output.
+ */
+struct GlyphRun {
+    struct Glyph {
+        const uint8_t* coverage;
+        int pitch;
+        int x, y, width, height;
+    };
+    std::vector<Glyph> glyphs;
+    int width = 0;
+    int height = 0;
+
+    void draw(Surface& target, int x, int y, const Color& color) const;
+    void draw(Surface& target, int x, int y, const Color& color, const PixelRect& clip) const;
+};
+
+/**
+ * TextMetrics - Per code point positions of one line of text, from cached glyph metrics
+ *
+ * positions[k] is the pen x of code point k as layout() places it (the line's
+ * leftward ink shift included); positions has one more entry, the end of the
+ * last advance. advances[k] = positions[k + 1] - positions[k], so kerning with
+ * the next code point is included. byte_offsets[k] is where code point k
+ * starts in the UTF-8 text (plus text.size()). width/height match get_size().
+ */
+struct TextMetrics {
+    std::vector<size_t> byte_offsets;
+    std::vector<int> advances;
+    std::vector<int> positions;
+    int width = 0;
+    int height = 0;
+};
+
 /**
  * Font - Wrapper around TTF_Font
+ *
+ * Thread-safe: SDL_ttf calls on one font are serialized by a per-font mutex,
+ * and opening/closing fonts (which touches the shared FreeType library) by a
+ * global one. Pixel conversion runs outside the locks.
+ *
+ * Glyphs are rasterized once each, on first use, into the shared GlyphAtlas;
+ * render(), render_wrapped(), draw_text() and get_size() lay strings out from
+ * those glyphs with the font's kerning, so new text or colors never rasterize
+ * again.
+ *
+ * SDL_ttf initializes on the first font opened; init() only does it early.
  */
 class Font {
 public:
     static void init();
-    static void quit();
+    static void quit();  // Closes cached fonts and layouts; TTF shuts down once none are open
 
     // Load a font from file
     Font(const std::string& path, int size);
@@ -27,32 +82,118 @@ public:
 
     // Render text
     std::shared_ptr<Surface> render(const std::string& text, const Color& color);
+
+    // Lay out one line of text (see GlyphRun)
+    GlyphRun layout(const std::string& text);
+
+    // Lay out text word-wrapped to wrap_width pixels ('\n' also breaks lines)
+    GlyphRun layout_wrapped(const std::string& text, int wrap_width);
+
+    // Draw text with its line box's top-left at (x, y), without an intermediate surface
+    void draw_text(Surface& target, const std::string& text, int x, int y, const Color& color);
+
+    // Rasterize the glyphs these strings need that aren't cached yet, spread
+    // over the thread pool; each pool thread uses its own TTF_Font on this file
+    // and size, closed again before returning. Few new glyphs are rasterized
+    // on the caller.
+    void prepare(const std::vector<std::string>& texts);
     
     // Render text wrapped to a specific width (pixels)
     std::shared_ptr<Surface> render_wrapped(const std::string& text, const Color& color, int wrap_width);
     
     // Metrics
     int get_height() const;
+    int get_line_skip() const;
     void get_size(const std::string& text, int& w, int& h);
 
+    // All positions of a line in one pass (see TextMetrics); measure_all takes
+    // the font lock once for the whole list
+    TextMetrics measure(const std::string& text);
+    std::vector<TextMetrics> measure_all(const std::vector<std::string>& texts);
+
+    // One glyph as layout() places it: coverage (valid while the font lives;
+    // nullptr for blank glyphs) offset from the pen position and line top
+    struct GlyphInfo {
+        const uint8_t* coverage;
+        int pitch;
+        int left, top, width, height;
+        int advance;
+    };
+    GlyphInfo get_glyph(uint32_t code_point);
+    int get_kerning(uint32_t previous, uint32_t next);
+
+    // Byte ranges of the lines layout_wrapped() breaks text into
+    std::vector<std::pair<size_t, size_t>> break_lines(const std::string& text, int wrap_width);
+
+    // Next code point of UTF-8 text at byte i (advanced); bad bytes give U+FFFD
+    static uint32_t decode_utf8(const std::string& text, size_t& i);
+
+    // Fonts currently open (TTF_Font handles)
+    static size_t get_open_count();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
 };
 
+struct FontCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;          // Lookups that opened (or failed to open) a font
+    size_t evictions = 0;
+    size_t cached = 0;          // Fonts held by the cache
+    size_t open_handles = 0;    // Live TTF_Font handles, cached or not
+    size_t capacity = 0;
+};
+
 /**
- * FontCache - Manages loaded fonts to avoid duplicates
+ * FontCache - Manages loaded fonts to avoid duplicates (thread-safe)
+ *
+ * Font names resolve to paths once (through the FontIndex) and fonts that fail
+ * to open are remembered for a few seconds, so a lookup is two hash probes.
+ * Fonts are opened outside the lock, so a slow open never stalls lookups of
+ * other fonts. At most `capacity` fonts (32 by default) are kept; beyond that
+ * the least recently used ones nobody else holds are closed. clear() forgets
+ * resolved names too.
  */
 class FontCache {
 public:
     static std::shared_ptr<Font> get(const std::string& name, int size);
     static void clear();
+    
+    // Drop fonts not referenced outside the cache; returns how many were closed
+    static size_t trim();
+
+    static void set_capacity(size_t fonts);
+    static size_t get_capacity();
+    static FontCacheStats get_stats();
 
-    // Helper to find system fonts or bundled fonts
+    // Helper to find system fonts or bundled fonts (memoized)
     static std::string resolve_path(const std::string& name);
 
+    // Forget resolved names and failed opens, keeping open fonts; call after
+    // the FontIndex is rebuilt
+    static void forget_resolved();
+
 private:
-    static std::map<std::pair<std::string, int>, std::shared_ptr<Font>> cache_;
+    using Key = std::pair<std::string, int>;  // (path, size)
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<Font> font;  // nullptr: failed to open
+        std::chrono::steady_clock::time_point opened;
+    };
+
+    static std::list<Entry> lru_;  // Most recently used first
+    static std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    static std::unordered_map<std::string, std::string> resolved_;
+    static size_t capacity_;
+    static size_t hits_, misses_, evictions_;
+    static std::mutex mutex_;
+
+    static std::string find_path(const std::string& name);
+    static void evict_unused(size_t keep);  // mutex_ held
 };
 
 } // namespace nativeui
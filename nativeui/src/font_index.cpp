@@ -0,0 +1,558 @@
+#include "font_index.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace nativeui {
+
+namespace {
+
+// ---- Cache file layout (native byte order; the magic catches a foreign one) ----
+const uint32_t kMagic = 0x58494650;  // "PFIX"
+const uint32_t kVersion = 1;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t root_count;    // The first root_count directories are the search roots
+    uint32_t dir_count;
+    uint32_t face_count;
+    uint32_t key_count;
+    uint32_t strings_size;
+    uint32_t reserved;
+};
+
+struct DirRecord {
+    uint32_t path;
+    uint32_t reserved;
+    int64_t mtime;          // -1: did not exist
+};
+
+struct FaceRecord {
+    uint32_t family;
+    uint32_t style;
+    uint32_t path;
+};
+
+struct KeyRecord {          // Sorted by key
+    uint32_t key;
+    uint32_t face;
+};
+
+// Paths are kept as UTF-8 strings (what TTF_OpenFont takes on every
+// platform); path::string() is the ANSI code page on Windows and throws for
+// names it can't represent
+std::string utf8(const fs::path& path)
+{
+    auto s = path.u8string();
+    return std::string(s.begin(), s.end());
+}
+
+fs::path from_utf8(const std::string& s)
+{
+    return fs::u8path(s);
+}
+
+int64_t modification_time(const fs::path& dir)
+{
+    std::error_code ec;
+    auto time = fs::last_write_time(dir, ec);
+    return ec ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+std::string lower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+bool is_font_file(const fs::path& path)
+{
+    std::string ext = lower(utf8(path.extension()));
+    return ext == ".ttf" || ext == ".otf" || ext == ".ttc";
+}
+
+bool is_regular(const std::string& style)
+{
+    std::string s = lower(style);
+    return s == "regular" || s == "book" || s == "normal" || s == "roman";
+}
+
+std::string env(const char* name)
+{
+    const char* value = std::getenv(name);
+    return value && *value ? value : "";
+}
+
+// ---- sfnt name table: family (ID 1) and subfamily (ID 2) ----
+
+uint16_t be16(const unsigned char* p) { return static_cast<uint16_t>(p[0] << 8 | p[1]); }
+uint32_t be32(const unsigned char* p) { return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3]; }
+
+bool read_at(std::ifstream& in, uint32_t offset, unsigned char* out, size_t size)
+{
+    in.seekg(offset);
+    in.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(in.gcount()) == size;
+}
+
+void append_utf8(std::string& out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | cp >> 6);
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | cp >> 12);
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | cp >> 18);
+        out += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+std::string decode_name(const unsigned char* p, size_t length, bool utf16)
+{
+    std::string out;
+    if (!utf16) {
+        // Mac Roman; the non-ASCII half is rare in family names
+        for (size_t i = 0; i < length; ++i) append_utf8(out, p[i] < 0x80 ? p[i] : '?');
+        return out;
+    }
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        uint32_t cp = be16(p + i);
+        if (cp >= 0xD800 && cp < 0xDC00 && i + 3 < length) {
+            uint32_t lo = be16(p + i + 2);
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            i += 2;
+        }
+        append_utf8(out, cp);
+    }
+    return out;
+}
+
+bool read_names(const std::string& path, std::string& family, std::string& style)
+{
+    std::ifstream in(from_utf8(path), std::ios::binary);
+    unsigned char head[16];
+    if (!in || !read_at(in, 0, head, 16)) return false;
+
+    // Collections: the first face names the file
+    uint32_t font = 0;
+    if (std::memcmp(head, "ttcf", 4) == 0) {
+        font = be32(head + 12);
+        if (!read_at(in, font, head, 12)) return false;
+    }
+    uint16_t tables = be16(head + 4);
+    std::vector<unsigned char> dir(size_t(tables) * 16);
+    if (!read_at(in, font + 12, dir.data(), dir.size())) return false;
+
+    uint32_t name_offset = 0, name_length = 0;
+    for (uint16_t t = 0; t < tables; ++t) {
+        if (std::memcmp(&dir[t * 16], "name", 4) == 0) {
+            name_offset = be32(&dir[t * 16 + 8]);
+            name_length = be32(&dir[t * 16 + 12]);
+        }
+    }
+    if (name_length < 6 || name_length > (1u << 20)) return false;
+    std::vector<unsigned char> table(name_length);
+    if (!read_at(in, name_offset, table.data(), table.size())) return false;
+
+    uint16_t count = be16(&table[2]);
+    uint16_t strings = be16(&table[4]);
+    // Best record per name ID: Windows English, then any Windows, then Mac
+    int best_rank[3] = {0, 0, 0};
+    for (uint16_t r = 0; r < count && 6 + (r + 1) * 12u <= name_length; ++r) {
+        const unsigned char* rec = &table[6 + r * 12];
+        uint16_t platform = be16(rec), language = be16(rec + 4), id = be16(rec + 6);
+        uint16_t length = be16(rec + 8), offset = be16(rec + 10);
+        if (id != 1 && id != 2) continue;
+        if (size_t(strings) + offset + length > name_length) continue;
+        int rank = platform == 3 ? (language == 0x409 ? 3 : 2) : platform == 1 ? 1 : 0;
+        if (rank <= best_rank[id]) continue;
+        best_rank[id] = rank;
+        (id == 1 ? family : style) = decode_name(&table[strings + offset], length, platform == 3);
+    }
+    if (style.empty()) style = "Regular";
+    return !family.empty();
+}
+
+// ---- Building ----
+
+struct Builder {
+    std::vector<std::string> roots;
+    std::vector<std::pair<std::string, int64_t>> dirs;
+    std::vector<FontFace> faces;
+
+    void scan()
+    {
+        for (const std::string& root : roots) {
+            dirs.emplace_back(root, modification_time(root));
+        }
+        for (const std::string& root : roots) {
+            std::error_code ec;
+            if (!fs::is_directory(root, ec)) continue;
+            std::vector<std::string> files;
+            fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+            for (; !ec && it != end; it.increment(ec)) {
+                // A name that can't be converted skips that entry, not the scan
+                try {
+                    if (it->is_directory(ec)) {
+                        dirs.emplace_back(utf8(it->path()), modification_time(it->path()));
+                    } else if (is_font_file(it->path())) {
+                        files.push_back(utf8(it->path()));
+                    }
+                } catch (const std::exception&) {
+                }
+            }
+            // Directory order is unspecified; keep the index deterministic
+            std::sort(files.begin(), files.end());
+            for (const std::string& file : files) {
+                FontFace face;
+                if (read_names(file, face.family, face.style)) {
+                    face.path = file;
+                    faces.push_back(std::move(face));
+                }
+            }
+        }
+    }
+
+    std::vector<char> serialize() const
+    {
+        std::string strings;
+        auto add = [&](const std::string& s) {
+            uint32_t at = static_cast<uint32_t>(strings.size());
+            strings += s;
+            strings += '\0';
+            return at;
+        };
+
+        std::vector<DirRecord> dir_records;
+        for (const auto& dir : dirs) dir_records.push_back(DirRecord{add(dir.first), 0, dir.second});
+
+        // Earlier roots win; a family name alone prefers its regular face
+        std::map<std::string, uint32_t> keys;
+        std::vector<FaceRecord> face_records;
+        for (uint32_t f = 0; f < faces.size(); ++f) {
+            const FontFace& face = faces[f];
+            face_records.push_back(FaceRecord{add(face.family), add(face.style), add(face.path)});
+            keys.emplace(lower(face.family + " " + face.style), f);
+            keys.emplace(lower(utf8(from_utf8(face.path).stem())), f);
+            auto family = keys.emplace(lower(face.family), f);
+            if (!family.second && is_regular(face.style) && !is_regular(faces[family.first->second].style)) {
+                family.first->second = f;
+            }
+        }
+        std::vector<KeyRecord> key_records;
+        for (const auto& key : keys) key_records.push_back(KeyRecord{add(key.first), key.second});
+
+        Header header{kMagic, kVersion, static_cast<uint32_t>(roots.size()),
+                      static_cast<uint32_t>(dir_records.size()), static_cast<uint32_t>(face_records.size()),
+                      static_cast<uint32_t>(key_records.size()), static_cast<uint32_t>(strings.size()), 0};
+        std::vector<char> out;
+        auto put = [&](const void* p, size_t n) {
+            out.insert(out.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+        };
+        put(&header, sizeof(header));
+        put(dir_records.data(), dir_records.size() * sizeof(DirRecord));
+        put(face_records.data(), face_records.size() * sizeof(FaceRecord));
+        put(key_records.data(), key_records.size() * sizeof(KeyRecord));
+        put(strings.data(), strings.size());
+        return out;
+    }
+};
+
+} // namespace
+
+// ---- Mapped (or, if the cache can't be written, heap) index ----
+
+struct FontIndex::Mapping {
+    const char* data = nullptr;
+    size_t size = 0;
+    std::vector<char> owned;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    Mapping() = default;
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping()
+    {
+        if (!data || !owned.empty()) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    static std::unique_ptr<Mapping> map_file(const std::string& path)
+    {
+        auto m = std::make_unique<Mapping>();
+#ifdef _WIN32
+        m->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m->file == INVALID_HANDLE_VALUE) return nullptr;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m->file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+            CloseHandle(m->file);
+            return nullptr;
+        }
+        m->mapping = CreateFileMappingA(m->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = m->mapping ? MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            if (m->mapping) CloseHandle(m->mapping);
+            CloseHandle(m->file);
+            return nullptr;
+        }
+        m->data = static_cast<const char*>(view);
+        m->size = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+            ::close(fd);
+            return nullptr;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return nullptr;
+        m->data = static_cast<const char*>(view);
+        m->size = static_cast<size_t>(st.st_size);
+#endif
+        return m;
+    }
+
+    static std::unique_ptr<Mapping> adopt(std::vector<char> bytes)
+    {
+        auto m = std::make_unique<Mapping>();
+        m->owned = std::move(bytes);
+        m->data = m->owned.data();
+        m->size = m->owned.size();
+        return m;
+    }
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(data); }
+    const DirRecord* dirs() const { return reinterpret_cast<const DirRecord*>(data + sizeof(Header)); }
+    const FaceRecord* faces() const { return reinterpret_cast<const FaceRecord*>(dirs() + header().dir_count); }
+    const KeyRecord* keys() const { return reinterpret_cast<const KeyRecord*>(faces() + header().face_count); }
+    const char* strings() const { return reinterpret_cast<const char*>(keys() + header().key_count); }
+    const char* str(uint32_t offset) const { return strings() + offset; }
+
+    // Structure checks, so a truncated or foreign file is rebuilt, never trusted
+    bool valid() const
+    {
+        if (size < sizeof(Header)) return false;
+        const Header& h = header();
+        if (h.magic != kMagic || h.version != kVersion || h.root_count > h.dir_count) return false;
+        size_t need = sizeof(Header) + size_t(h.dir_count) * sizeof(DirRecord) +
+                      size_t(h.face_count) * sizeof(FaceRecord) + size_t(h.key_count) * sizeof(KeyRecord) +
+                      h.strings_size;
+        if (need != size || h.strings_size == 0 || strings()[h.strings_size - 1] != '\0') return false;
+        for (uint32_t i = 0; i < h.dir_count; ++i) {
+            if (dirs()[i].path >= h.strings_size) return false;
+        }
+        for (uint32_t i = 0; i < h.face_count; ++i) {
+            const FaceRecord& f = faces()[i];
+            if (f.family >= h.strings_size || f.style >= h.strings_size || f.path >= h.strings_size) return false;
+        }
+        for (uint32_t i = 0; i < h.key_count; ++i) {
+            if (keys()[i].key >= h.strings_size || keys()[i].face >= h.face_count) return false;
+        }
+        return true;
+    }
+
+    // Same search roots and no indexed directory touched since the scan
+    bool current(const std::vector<std::string>& roots) const
+    {
+        const Header& h = header();
+        if (h.root_count != roots.size()) return false;
+        for (uint32_t i = 0; i < h.root_count; ++i) {
+            if (roots[i] != str(dirs()[i].path)) return false;
+        }
+        for (uint32_t i = 0; i < h.dir_count; ++i) {
+            if (i < h.root_count ? modification_time(roots[i]) != dirs()[i].mtime
+                                 : modification_time(from_utf8(str(dirs()[i].path))) != dirs()[i].mtime) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char* find(const std::string& key) const
+    {
+        const KeyRecord* begin = keys();
+        const KeyRecord* end = begin + header().key_count;
+        const KeyRecord* it = std::lower_bound(begin, end, key, [&](const KeyRecord& k, const std::string& v) {
+            return std::strcmp(str(k.key), v.c_str()) < 0;
+        });
+        if (it == end || key != str(it->key)) return nullptr;
+        return str(faces()[it->face].path);
+    }
+};
+
+FontIndex& FontIndex::instance()
+{
+    static FontIndex index;
+    return index;
+}
+
+FontIndex::~FontIndex() = default;
+
+std::vector<std::string> FontIndex::font_directories()
+{
+    std::vector<std::string> dirs;
+#ifdef _WIN32
+    std::string local = env("LOCALAPPDATA");
+    if (!local.empty()) dirs.push_back(local + "\\Microsoft\\Windows\\Fonts");
+    std::string windir = env("WINDIR");
+    dirs.push_back((windir.empty() ? std::string("C:\\Windows") : windir) + "\\Fonts");
+#elif defined(__APPLE__)
+    std::string home = env("HOME");
+    if (!home.empty()) dirs.push_back(home + "/Library/Fonts");
+    dirs.push_back("/Library/Fonts");
+    dirs.push_back("/System/Library/Fonts");
+#else
+    std::string home = env("HOME");
+    std::string data = env("XDG_DATA_HOME");
+    if (data.empty() && !home.empty()) data = home + "/.local/share";
+    if (!data.empty()) dirs.push_back(data + "/fonts");
+    if (!home.empty()) dirs.push_back(home + "/.fonts");
+    dirs.push_back("/usr/local/share/fonts");
+    dirs.push_back("/usr/share/fonts");
+#endif
+    return dirs;
+}
+
+std::string FontIndex::cache_path()
+{
+    std::string override_path = env("PALLADIUM_FONT_INDEX");
+    if (!override_path.empty()) return override_path;
+#ifdef _WIN32
+    std::string base = env("LOCALAPPDATA");
+    return base.empty() ? "" : base + "\\Palladium\\font-index.bin";
+#elif defined(__APPLE__)
+    std::string home = env("HOME");
+    return home.empty() ? "" : home + "/Library/Caches/Palladium/font-index.bin";
+#else
+    std::string base = env("XDG_CACHE_HOME");
+    if (base.empty()) {
+        std::string home = env("HOME");
+        if (home.empty()) return "";
+        base = home + "/.cache";
+    }
+    return base + "/palladium/font-index.bin";
+#endif
+}
+
+bool FontIndex::load(const std::string& file)
+{
+    auto mapping = Mapping::map_file(file);
+    if (!mapping || !mapping->valid() || !mapping->current(font_directories())) return false;
+    map_ = std::move(mapping);
+    return true;
+}
+
+void FontIndex::scan_and_save()
+{
+    ProfileScope scope("FontIndex::scan");
+    Builder builder;
+    builder.roots = font_directories();
+    builder.scan();
+    std::vector<char> bytes = builder.serialize();
+
+    // Written aside and renamed, so a concurrent process never maps half a file
+    std::string file = cache_path();
+    if (!file.empty()) {
+        std::error_code ec;
+        fs::create_directories(fs::path(file).parent_path(), ec);
+        std::string temp = file + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        fs::rename(temp, file, ec);
+        if (!ec) {
+            map_ = Mapping::map_file(file);
+            if (map_ && map_->valid()) return;
+        } else {
+            fs::remove(temp, ec);
+        }
+    }
+    map_ = Mapping::adopt(std::move(bytes));
+}
+
+void FontIndex::ensure_loaded()
+{
+    if (loaded_) return;
+    std::string file = cache_path();
+    if (file.empty() || !load(file)) scan_and_save();
+    loaded_ = true;
+}
+
+std::string FontIndex::find(const std::string& name)
+{
+    std::string key = lower(name);
+    try {
+        fs::path as_path = from_utf8(key);
+        if (is_font_file(as_path)) key = utf8(as_path.stem());
+    } catch (const std::exception&) {
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensure_loaded();
+    const char* path = map_->find(key);
+    return path ? path : "";
+}
+
+std::vector<FontFace> FontIndex::list()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensure_loaded();
+    std::vector<FontFace> faces;
+    for (uint32_t i = 0; i < map_->header().face_count; ++i) {
+        const FaceRecord& f = map_->faces()[i];
+        faces.push_back(FontFace{map_->str(f.family), map_->str(f.style), map_->str(f.path)});
+    }
+    return faces;
+}
+
+void FontIndex::rebuild()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_.reset();
+    scan_and_save();
+    loaded_ = true;
+}
+
+} // namespace nativeui
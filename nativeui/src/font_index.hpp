@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nativeui {
+
+struct FontFace {
+    std::string family;
+    std::string style;
+    std::string path;       // UTF-8
+};
+
+/**
+ * FontIndex - Family/style to file lookup over the system font directories
+ *
+ * The first lookup loads the index from the user cache directory
+ * (font-index.bin, memory-mapped) and checks the modification time of every
+ * indexed directory. If a font directory changed, or there is no usable cache,
+ * the directories are scanned recursively. Only the name table of each font
+ * file is read, so TTF stays uninitialized. The index is then written back.
+ *
+ * find() accepts "Family", "Family Style" or a file name without its extension,
+ * case-insensitively. Thread-safe.
+ */
+class FontIndex {
+public:
+    static FontIndex& instance();
+
+    // Path of the best match, or "" if nothing in the index matches
+    std::string find(const std::string& name);
+
+    std::vector<FontFace> list();
+
+    // Rescan the font directories and rewrite the cache file
+    void rebuild();
+
+    // Directories searched, in order (earlier ones win name clashes)
+    static std::vector<std::string> font_directories();
+    // Where the index is cached ("" if no cache directory is known)
+    static std::string cache_path();
+
+private:
+    FontIndex() = default;
+    ~FontIndex();
+    FontIndex(const FontIndex&) = delete;
+    FontIndex& operator=(const FontIndex&) = delete;
+
+    struct Mapping;
+
+    void ensure_loaded();          // mutex_ held
+    bool load(const std::string& file);
+    void scan_and_save();
+
+    std::mutex mutex_;
+    bool loaded_ = false;
+    std::unique_ptr<Mapping> map_;
+};
+
+} // namespace nativeui
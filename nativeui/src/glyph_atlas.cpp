@@ -0,0 +1,74 @@
+#include "glyph_atlas.hpp"
+#include "memory_tracker.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace nativeui {
+
+GlyphAtlas& GlyphAtlas::instance()
+{
+    // Leaked on purpose: fonts held by other statics (FontCache, the text
+    // layout cache) release their glyphs here during static destruction
+    static GlyphAtlas* atlas = new GlyphAtlas();
+    return *atlas;
+}
+
+GlyphSlot GlyphAtlas::insert(const uint8_t* coverage, int pitch, int width, int height)
+{
+    GlyphSlot slot;
+    auto place = [&](uint32_t p) {
+        Page& page = *pages_[p];
+        if (!page.packer.insert(width, height, slot.rect)) return false;
+        slot.page = p;
+        slot.pitch = page.packer.width();
+        uint8_t* dst = page.pixels.get() + static_cast<size_t>(slot.rect.y0) * slot.pitch + slot.rect.x0;
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(dst + static_cast<size_t>(y) * slot.pitch, coverage + static_cast<size_t>(y) * pitch, width);
+        }
+        slot.pixels = dst;
+        used_pixels_ += static_cast<size_t>(width) * height;
+        return true;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (uint32_t p = 0; p < pages_.size(); ++p) {
+            if (place(p)) return slot;
+        }
+    }
+
+    // New page, as large as the glyph if needed. Registered outside the lock:
+    // memory pressure may close fonts, which release their glyphs here.
+    int w = std::max(kPageSize, width), h = std::max(kPageSize, height);
+    size_t bytes = static_cast<size_t>(w) * h;
+    MemoryTracker::instance().on_allocate("Glyph atlas", bytes);
+    auto page = std::make_unique<Page>(Page{std::make_unique<uint8_t[]>(bytes), GuillotinePacker(w, h)});
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pages_.push_back(std::move(page));
+    place(static_cast<uint32_t>(pages_.size() - 1));
+    return slot;
+}
+
+void GlyphAtlas::release(const GlyphSlot& slot)
+{
+    if (!slot.pixels) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pages_[slot.page]->packer.release(slot.rect);
+    used_pixels_ -= static_cast<size_t>(slot.rect.width()) * slot.rect.height();
+}
+
+GlyphAtlasStats GlyphAtlas::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    GlyphAtlasStats stats;
+    stats.pages = pages_.size();
+    stats.used_pixels = used_pixels_;
+    for (const auto& page : pages_) {
+        stats.page_pixels += static_cast<size_t>(page->packer.width()) * page->packer.height();
+        stats.glyphs += page->packer.used();
+    }
+    return stats;
+}
+
+} // namespace nativeui
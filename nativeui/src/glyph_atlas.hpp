@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "rect_packer.hpp"
+
+namespace nativeui {
+
+/**
+ * GlyphSlot - Where a glyph's coverage lives in the GlyphAtlas
+ *
+ * `pixels` points at the top-left coverage byte; rows are `pitch` bytes apart.
+ */
+struct GlyphSlot {
+    const uint8_t* pixels = nullptr;
+    int pitch = 0;
+    uint32_t page = 0;
+    PixelRect rect;
+};
+
+struct GlyphAtlasStats {
+    size_t pages = 0;
+    size_t glyphs = 0;
+    size_t used_pixels = 0;   // Coverage bytes in live glyphs
+    size_t page_pixels = 0;   // Coverage bytes in all pages
+};
+
+/**
+ * GlyphAtlas - Shared A8 (coverage only) pages for rasterized glyphs
+ *
+ * Every Font packs its glyphs here, once per glyph, and returns them when it is
+ * closed. Pages are never moved or freed, so a slot's pixels stay valid until
+ * it is released. The atlas itself is never destroyed: fonts owned by statics
+ * release their glyphs here during static destruction. Thread-safe.
+ */
+class GlyphAtlas {
+public:
+    static GlyphAtlas& instance();
+
+    static constexpr int kPageSize = 512;
+
+    // Copy a width x height coverage bitmap into the atlas
+    GlyphSlot insert(const uint8_t* coverage, int pitch, int width, int height);
+    void release(const GlyphSlot& slot);
+
+    GlyphAtlasStats get_stats() const;
+
+private:
+    GlyphAtlas() = default;  // Never destroyed, see instance()
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    struct Page {
+        std::unique_ptr<uint8_t[]> pixels;
+        GuillotinePacker packer;
+    };
+
+    std::vector<std::unique_ptr<Page>> pages_;
+    size_t used_pixels_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace nativeui
@@ -396,7 +396,7 @@ void GPUSurface::upload_from(const nativeui::Surface& cpu_surface) {
     
     for (int y = 0; y < h; ++y) {
         for (int x = 0; x < w; ++x) {
-            size_t src_idx = (y * cpu_surface.get_width() + x) * 4;
+            size_t src_idx = y * cpu_surface.get_pitch() + x * 4;
             size_t dst_idx = (y * w + x) * 4;
             
             // RGBA -> BGRA with premultiplied alpha
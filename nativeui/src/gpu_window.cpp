@@ -1,6 +1,8 @@
 #ifdef _WIN32
 
 #include "gpu_window.hpp"
+#include "profiler.hpp"
+#include "scratch_arena.hpp"
 
 namespace palladium {
 
@@ -207,6 +209,12 @@ nativeui::Event GPUWindow::translate_event(const SDL_Event& sdl_event) {
             break;
     }
     
+    event.timestamp = sdl_event.common.timestamp;
+    event.frame_id = frame_id_;
+    if (nativeui::is_input_event(event.type)) {
+        latency_.on_input(event.timestamp);
+    }
+    
     return event;
 }
 
@@ -247,7 +255,11 @@ void GPUWindow::clear(const nativeui::Color& color) {
 void GPUWindow::present() {
     end_draw();
     
-    HRESULT hr = swap_chain_->Present(1, 0);  // VSync on
+    HRESULT hr;
+    {
+        nativeui::ProfileScope present_scope("GPUWindow::present");
+        hr = swap_chain_->Present(1, 0);  // VSync on
+    }
     
     if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET) {
         // Handle device loss
@@ -255,7 +267,12 @@ void GPUWindow::present() {
         create_render_target();
     }
     
+    latency_.on_present(frame_id_, SDL_GetTicks());
+    frame_id_++;
+    
     update_timing();
+    nativeui::Profiler::instance().end_frame();
+    nativeui::ScratchArena::next_frame();
 }
 
 void GPUWindow::draw(const GPUSurface& surface, int x, int y, float opacity) {
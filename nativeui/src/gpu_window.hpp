@@ -54,6 +54,12 @@ public:
     void set_target_fps(int fps);
     void set_unfocused_fps(int fps);
     
+    // Frame ID of the next present (number of frames presented so far)
+    uint64_t get_frame_id() const { return frame_id_; }
+    
+    // Input-to-present latency
+    nativeui::LatencyTracker& get_latency() { return latency_; }
+    
     // Window state
     bool is_focused() const;
     bool is_minimized() const;
@@ -94,6 +100,10 @@ private:
     int target_fps_;
     int unfocused_fps_;
     
+    // Latency
+    uint64_t frame_id_ = 0;
+    nativeui::LatencyTracker latency_;
+    
     void create_swap_chain();
     void create_render_target();
     void update_timing();
@@ -0,0 +1,83 @@
+#include "latency.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace nativeui {
+
+LatencyTracker::LatencyTracker(size_t capacity)
+    : samples_(std::max<size_t>(1, capacity), 0.0)
+    , next_(0)
+    , count_(0)
+    , pending_(false)
+    , oldest_pending_ms_(0)
+    , last_frame_id_(0)
+{
+}
+
+void LatencyTracker::on_input(uint32_t timestamp_ms)
+{
+    if (!pending_) {
+        oldest_pending_ms_ = timestamp_ms;
+        pending_ = true;
+    } else if (static_cast<int32_t>(timestamp_ms - oldest_pending_ms_) < 0) {
+        oldest_pending_ms_ = timestamp_ms;
+    }
+}
+
+void LatencyTracker::on_present(uint64_t frame_id, uint32_t present_ms)
+{
+    if (!pending_) return;
+    pending_ = false;
+
+    // Signed difference keeps tick wrap-around harmless
+    int32_t elapsed = static_cast<int32_t>(present_ms - oldest_pending_ms_);
+    samples_[next_] = static_cast<double>(std::max(0, elapsed));
+    next_ = (next_ + 1) % samples_.size();
+    count_ = std::min(count_ + 1, samples_.size());
+    last_frame_id_ = frame_id;
+}
+
+LatencyStats LatencyTracker::get_stats() const
+{
+    LatencyStats stats;
+    if (count_ == 0) return stats;
+
+    std::vector<double> sorted(samples_.begin(), samples_.begin() + count_);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentile
+    auto percentile = [&](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<size_t>(1, rank)) - 1];
+    };
+
+    double sum = 0.0;
+    for (double s : sorted) sum += s;
+
+    stats.count = count_;
+    stats.min_ms = sorted.front();
+    stats.max_ms = sorted.back();
+    stats.mean_ms = sum / sorted.size();
+    stats.p50_ms = percentile(0.50);
+    stats.p95_ms = percentile(0.95);
+    stats.p99_ms = percentile(0.99);
+    stats.last_ms = samples_[(next_ + samples_.size() - 1) % samples_.size()];
+    return stats;
+}
+
+void LatencyTracker::set_capacity(size_t capacity)
+{
+    samples_.assign(std::max<size_t>(1, capacity), 0.0);
+    next_ = 0;
+    count_ = 0;
+}
+
+void LatencyTracker::reset()
+{
+    next_ = 0;
+    count_ = 0;
+    pending_ = false;
+    last_frame_id_ = 0;
+}
+
+} // namespace nativeui
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * Input-to-present latency percentiles (milliseconds)
+ */
+struct LatencyStats {
+    size_t count = 0;
+    double min_ms = 0.0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    double last_ms = 0.0;
+};
+
+/**
+ * LatencyTracker - Measures time from input event to the frame presenting it
+ *
+ * Windows feed it the SDL timestamp of every input event they translate and
+ * the tick count right after each present. One sample is taken per frame that
+ * had pending input: the age of the oldest unpresented event, i.e. the worst
+ * case latency seen by that frame. Samples live in a fixed-size ring.
+ */
+class LatencyTracker {
+public:
+    explicit LatencyTracker(size_t capacity = 1024);
+
+    // Note an input event (SDL_Event timestamp, milliseconds)
+    void on_input(uint32_t timestamp_ms);
+
+    // Note a completed present; records a sample if input was pending
+    void on_present(uint64_t frame_id, uint32_t present_ms);
+
+    LatencyStats get_stats() const;
+
+    // Frame ID of the last present that reflected input (0 if none yet)
+    uint64_t get_last_frame_id() const { return last_frame_id_; }
+
+    size_t get_capacity() const { return samples_.size(); }
+    void set_capacity(size_t capacity);
+    void reset();
+
+private:
+    std::vector<double> samples_;  // Ring buffer
+    size_t next_;
+    size_t count_;
+
+    bool pending_;
+    uint32_t oldest_pending_ms_;
+    uint64_t last_frame_id_;
+};
+
+} // namespace nativeui
@@ -1,5 +1,7 @@
 #include "layer.hpp"
 #include "effects.hpp"
+#include "profiler.hpp"
+#include "memory_tracker.hpp"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
@@ -271,8 +273,34 @@ std::shared_ptr<Surface> LayerStack::composite()
     return composite_surface_;
 }
 
+void LayerStack::apply_late_latch()
+{
+    if (!pointer_source_) return;
+    
+    bool any_latched = false;
+    for (const auto& layer : layers_) {
+        if (layer->is_latched_to_pointer()) {
+            any_latched = true;
+            break;
+        }
+    }
+    if (!any_latched) return;
+    
+    int px = 0, py = 0;
+    pointer_source_(px, py);
+    for (const auto& layer : layers_) {
+        if (layer->is_latched_to_pointer()) {
+            layer->set_position(px - layer->get_latch_offset_x(), py - layer->get_latch_offset_y());
+        }
+    }
+}
+
 void LayerStack::composite_to(Surface& dest)
 {
+    ProfileScope scope("LayerStack::composite");
+    
+    apply_late_latch();
+    
     // Fill with background
     dest.fill(background_);
     
@@ -282,6 +310,7 @@ void LayerStack::composite_to(Surface& dest)
             continue;
         }
         
+        ProfileScope layer_scope("LayerStack::blend_layer");
         const Surface& src = layer->get_surface();
         int lx = layer->get_x();
         int ly = layer->get_y();
@@ -397,6 +426,8 @@ void LayerStack::apply_frosted_glass(Surface& dest, int x, int y, int w, int h,
                                      const Surface& mask, float scale_x, float scale_y, 
                                      float blur_radius)
 {
+    ProfileScope scope("LayerStack::frosted_glass");
+    
     // 1. Calculate padded bounds to avoid edge artifacts
     // Blur radius * 3 is standard for Gaussian kernel coverage
     int padding = static_cast<int>(std::ceil(blur_radius * 3.0f));
@@ -407,7 +438,8 @@ void LayerStack::apply_frosted_glass(Surface& dest, int x, int y, int w, int h,
     int pad_w = w + padding * 2;
     int pad_h = h + padding * 2;
     
-    // Create temporary surface for blurring
+    // Create temporary surface for blurring (storage comes from the buffer pool)
+    AllocationTag tag("LayerStack::frosted_glass");
     Surface padded_surface(pad_w, pad_h);
     
     // Copy pixels from dest to padded_surface
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
 #include <algorithm>
 #include "surface.hpp"
 #include "material.hpp"
@@ -42,6 +43,15 @@ public:
     void set_position(int x, int y) { x_ = x; y_ = y; }
     void move(int dx, int dy) { x_ += dx; y_ += dy; }
     
+    // Late latch: follow the pointer at composite time (position = pointer - offset)
+    void latch_to_pointer(int offset_x, int offset_y) {
+        pointer_latched_ = true; latch_offset_x_ = offset_x; latch_offset_y_ = offset_y;
+    }
+    void release_pointer() { pointer_latched_ = false; }
+    bool is_latched_to_pointer() const { return pointer_latched_; }
+    int get_latch_offset_x() const { return latch_offset_x_; }
+    int get_latch_offset_y() const { return latch_offset_y_; }
+    
     // Transform
     float get_scale_x() const { return scale_x_; }
     float get_scale_y() const { return scale_y_; }
@@ -83,6 +93,9 @@ private:
     BlendMode blend_mode_;
     std::shared_ptr<Material> material_;
     std::string name_;
+    bool pointer_latched_ = false;
+    int latch_offset_x_ = 0;
+    int latch_offset_y_ = 0;
 };
 
 /**
@@ -116,6 +129,13 @@ public:
     std::shared_ptr<Surface> composite();
     void composite_to(Surface& dest);
     
+    // Late latch: pointer sampled right before compositing; latched layers
+    // are moved to it so drags reflect the newest mouse position
+    using PointerSource = std::function<void(int& x, int& y)>;
+    void set_pointer_source(PointerSource source) { pointer_source_ = std::move(source); }
+    void clear_pointer_source() { pointer_source_ = nullptr; }
+    bool has_pointer_source() const { return static_cast<bool>(pointer_source_); }
+    
     // Background color
     void set_background(const Color& color) { background_ = color; }
     const Color& get_background() const { return background_; }
@@ -129,6 +149,10 @@ private:
     std::vector<std::shared_ptr<Layer>> layers_;
     Color background_;
     std::shared_ptr<Surface> composite_surface_;
+    PointerSource pointer_source_;
+    
+    // Move pointer-latched layers to the freshly sampled pointer
+    void apply_late_latch();
     
     // Blend a single pixel using the specified blend mode
     static Color blend_pixels(const Color& bottom, const Color& top, BlendMode mode, float opacity);
@@ -5,6 +5,8 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
+#include <optional>
 
 #include "surface.hpp"
 #include "window.hpp"
@@ -17,6 +19,20 @@
 #include "button.hpp"
 #include "slider.hpp"
 #include "textfield.hpp"
+#include "profiler.hpp"
+#include "memory_tracker.hpp"
+#include "buffer_pool.hpp"
+#include "scratch_arena.hpp"
+#include "event_record.hpp"
+#include "thread_pool.hpp"
+#include "batch.hpp"
+#include "display_list.hpp"
+#include "particles.hpp"
+#include "atlas.hpp"
+#include "glyph_atlas.hpp"
+#include "text_cache.hpp"
+#include "font_index.hpp"
+#include "text_rasterizer.hpp"
 
 // GPU acceleration (Windows only)
 #ifdef _WIN32
@@ -85,6 +101,163 @@ ButtonTextStyle parse_text_style(const py::dict& d) {
     return s;
 }
 
+// Helper to convert a profiler FrameSummary to a dict
+py::dict frame_summary_to_dict(const FrameSummary& f) {
+    py::dict stages;
+    for (const auto& stage : f.stages) {
+        py::dict st;
+        st["calls"] = stage.calls;
+        st["total_ms"] = stage.total_ms;
+        st["avg_ms"] = stage.avg_ms();
+        st["max_ms"] = stage.max_ms;
+        stages[py::str(stage.name)] = st;
+    }
+    py::dict d;
+    d["frame"] = f.frame_id;
+    d["frame_ms"] = f.frame_ms;
+    d["stages"] = stages;
+    return d;
+}
+
+// Helper to convert input latency percentiles to a dict
+py::dict latency_stats_to_dict(const LatencyStats& l) {
+    py::dict d;
+    d["count"] = l.count;
+    d["min_ms"] = l.min_ms;
+    d["mean_ms"] = l.mean_ms;
+    d["p50_ms"] = l.p50_ms;
+    d["p95_ms"] = l.p95_ms;
+    d["p99_ms"] = l.p99_ms;
+    d["max_ms"] = l.max_ms;
+    d["last_ms"] = l.last_ms;
+    return d;
+}
+
+// Helper to convert surface memory stats to a dict
+py::dict memory_stats_to_dict(const MemoryStats& m) {
+    py::dict origins;
+    for (const auto& o : m.origins) {
+        py::dict od;
+        od["count"] = o.live_count;
+        od["bytes"] = o.live_bytes;
+        od["peak_bytes"] = o.peak_bytes;
+        od["allocations"] = o.allocations;
+        origins[py::str(o.origin)] = od;
+    }
+    py::dict d;
+    d["count"] = m.live_count;
+    d["bytes"] = m.live_bytes;
+    d["peak_bytes"] = m.peak_bytes;
+    d["allocations"] = m.allocations;
+    d["evictions"] = m.evictions;
+    d["origins"] = origins;
+    return d;
+}
+
+// Python object that is safe to copy and release without the GIL, for
+// callbacks and buffers that native code holds on to from any thread
+template <typename T>
+std::shared_ptr<T> share_object(T obj) {
+    return std::shared_ptr<T>(new T(std::move(obj)), [](T* o) {
+        py::gil_scoped_acquire gil;
+        delete o;
+    });
+}
+
+// Zero-copy (height, width, 4) array over a surface's pixels. It pins the
+// surface until NumPy drops it, so an atlas view is never moved under it;
+// `keep_alive` holds the surface when nothing else does.
+py::array pinned_pixels(Surface& s, std::shared_ptr<Surface> keep_alive) {
+    struct Pin {
+        Surface* surface;
+        std::shared_ptr<Surface> keep_alive;
+    };
+    uint8_t* data = s.pin();
+    py::capsule base(new Pin{&s, std::move(keep_alive)}, [](void* p) {
+        auto* pin = static_cast<Pin*>(p);
+        pin->surface->unpin();
+        delete pin;
+    });
+    return py::array(py::dtype::of<uint8_t>(),
+                     std::vector<py::ssize_t>{s.get_height(), s.get_width(), 4},
+                     std::vector<py::ssize_t>{static_cast<py::ssize_t>(s.get_pitch()), 4, 1},
+                     data, base);
+}
+
+// Check that `arr` can back a surface: H x W x 4 uint8 (RGBA)
+void check_rgba_array(const py::array& arr) {
+    if (arr.ndim() != 3 || arr.shape(2) != 4) {
+        throw py::value_error("expected an array of shape (height, width, 4)");
+    }
+    if (arr.shape(0) <= 0 || arr.shape(1) <= 0) {
+        throw py::value_error("array must not be empty");
+    }
+}
+
+// Contiguous int32 / float32 arrays accepted by the batch drawing APIs
+using BatchInts = py::array_t<int32_t, py::array::c_style | py::array::forcecast>;
+using BatchFloats = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// Number of rows in an (N, cols) batch array
+size_t batch_rows(const py::array& arr, int cols, const char* name) {
+    if (arr.ndim() != 2 || arr.shape(1) != cols) {
+        throw py::value_error(std::string(name) + " must have shape (N, " + std::to_string(cols) + ")");
+    }
+    return static_cast<size_t>(arr.shape(0));
+}
+
+// Batch colors: a Color, an RGBA sequence, or an (N, 4) uint8 array
+struct BatchColors {
+    py::array_t<uint8_t, py::array::c_style | py::array::forcecast> array;
+    uint8_t single[4] = {0, 0, 0, 255};
+    bool per_item = false;
+
+    BatchColors(const py::object& colors, size_t count) {
+        if (py::isinstance<Color>(colors)) {
+            Color c = colors.cast<Color>();
+            single[0] = c.r; single[1] = c.g; single[2] = c.b; single[3] = c.a;
+            return;
+        }
+        array = py::array_t<uint8_t, py::array::c_style | py::array::forcecast>::ensure(colors);
+        if (!array) throw py::value_error("colors must be a Color or a uint8 array");
+        if (array.ndim() == 1 && array.shape(0) == 4) {
+            std::memcpy(single, array.data(), 4);
+        } else if (array.ndim() == 2 && array.shape(1) == 4 && static_cast<size_t>(array.shape(0)) == count) {
+            per_item = true;
+        } else {
+            throw py::value_error("colors must be a Color, (4,) or (N, 4) with one row per item");
+        }
+    }
+
+    Strided<uint8_t> view() const {
+        return per_item ? Strided<uint8_t>(array.data(), 4) : Strided<uint8_t>(single, 0);
+    }
+};
+
+// Per-item scalars: one number shared by all items, or an (N,) array
+template <typename T>
+struct BatchScalars {
+    py::array_t<T, py::array::c_style | py::array::forcecast> array;
+    T single = T();
+    bool per_item = false;
+
+    BatchScalars(const py::object& values, size_t count, const char* name) {
+        if (py::isinstance<py::int_>(values) || py::isinstance<py::float_>(values)) {
+            single = static_cast<T>(values.cast<double>());
+            return;
+        }
+        array = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(values);
+        if (!array || array.ndim() != 1 || static_cast<size_t>(array.shape(0)) != count) {
+            throw py::value_error(std::string(name) + " must be a number or have shape (N,)");
+        }
+        per_item = true;
+    }
+
+    Strided<T> view() const {
+        return per_item ? Strided<T>(array.data(), 1) : Strided<T>(&single, 0);
+    }
+};
+
 // === Global Device Mode ===
 enum class DeviceMode {
     CPU,
@@ -159,41 +332,236 @@ Example:
         });
     
     // === Surface ===
-    py::class_<Surface, std::shared_ptr<Surface>>(m, "Surface")
+    py::class_<Surface, std::shared_ptr<Surface>>(m, "Surface", py::buffer_protocol())
         .def(py::init<int, int>(), py::arg("width"), py::arg("height"))
+        // Zero-copy (height, width, 4) uint8 view of the pixels, e.g. numpy.asarray(surface)
+        // The consumer holds the Surface while the buffer is exported; the pin is
+        // dropped when it releases the buffer
+        .def_buffer([](Surface& s) -> py::buffer_info {
+            return pinned_pixels(s, nullptr).request(true);
+        })
+        // Same view for numpy.array(surface); the array holds the surface and its pin
+        .def("__array__", [](std::shared_ptr<Surface> self, py::object dtype, py::object copy) -> py::object {
+            py::object arr = pinned_pixels(*self, self);
+            if (!dtype.is_none()) arr = arr.attr("astype")(dtype, py::arg("copy") = false);
+            if (!copy.is_none() && copy.cast<bool>()) arr = arr.attr("copy")();
+            return arr;
+        }, py::arg("dtype") = py::none(), py::arg("copy") = py::none())
+        // Consumers of the interface (PIL, OpenCV) keep only the Surface as the
+        // base, so nothing reports when they are done: the pin taken here lasts
+        // as long as the surface
+        .def_property_readonly("__array_interface__", [](Surface& s) {
+            py::dict d;
+            d["shape"] = py::make_tuple(s.get_height(), s.get_width(), 4);
+            d["typestr"] = "|u1";
+            d["data"] = py::make_tuple(reinterpret_cast<uintptr_t>(s.pin()), false);
+            d["strides"] = py::make_tuple(s.get_pitch(), 4, 1);
+            d["version"] = 3;
+            return d;
+        })
+        .def_static("from_array", [](py::array arr, bool copy) {
+            check_rgba_array(arr);
+            int h = static_cast<int>(arr.shape(0));
+            int w = static_cast<int>(arr.shape(1));
+            if (copy) {
+                auto src = py::array_t<uint8_t, py::array::c_style | py::array::forcecast>::ensure(arr);
+                if (!src) throw py::value_error("array is not convertible to uint8");
+                auto surface = std::make_shared<Surface>(w, h);
+                std::memcpy(surface->get_data(), src.data(), surface->get_size());
+                return surface;
+            }
+            if (!py::isinstance<py::array_t<uint8_t>>(arr)) {
+                throw py::value_error("from_array(copy=False) needs a uint8 array; pass copy=True to convert");
+            }
+            if (!(arr.flags() & py::array::c_style) || !arr.writeable()) {
+                throw py::value_error("from_array(copy=False) needs a writeable C-contiguous array; pass copy=True");
+            }
+            // The surface keeps the array alive; the array's memory is drawn into directly
+            uint8_t* data = static_cast<uint8_t*>(arr.mutable_data());
+            return Surface::wrap(data, w, h, share_object(py::object(arr)));
+        }, py::arg("array"), py::arg("copy") = false,
+           "Surface over an (height, width, 4) uint8 RGBA array; shares its memory unless copy=True")
+        .def_property_readonly("is_external", &Surface::is_external,
+                               "True if the pixels live in memory wrapped by from_array")
         .def_property_readonly("width", &Surface::get_width)
         .def_property_readonly("height", &Surface::get_height)
+        .def_property_readonly("origin", [](const Surface& s) { return std::string(s.get_origin()); })
         .def("set_pixel", py::overload_cast<int, int, uint8_t, uint8_t, uint8_t, uint8_t>(&Surface::set_pixel),
              py::arg("x"), py::arg("y"), py::arg("r"), py::arg("g"), py::arg("b"), py::arg("a") = 255)
         .def("set_pixel", py::overload_cast<int, int, const Color&>(&Surface::set_pixel))
         .def("get_pixel", &Surface::get_pixel)
-        .def("fill", &Surface::fill)
-        .def("fill_rect", &Surface::fill_rect)
+        .def("fill", &Surface::fill, py::call_guard<py::gil_scoped_release>())
+        .def("fill_rect", &Surface::fill_rect, py::call_guard<py::gil_scoped_release>())
         .def("clear", [](Surface& s, const Color& c) {
             s.fill(c);
-        }, py::arg("color") = Color(0, 0, 0, 0))
-        .def("draw_line", &Surface::draw_line)
-        .def("draw_rect", &Surface::draw_rect)
-        .def("draw_circle", &Surface::draw_circle)
-        .def("fill_circle", &Surface::fill_circle)
-        .def("blit", &Surface::blit)
-        .def("blit_scaled", &Surface::blit_scaled)
-        .def("blit_alpha", &Surface::blit_alpha, py::arg("source"), py::arg("dest_x"), py::arg("dest_y"), py::arg("alpha") = 1.0f)
-        .def("copy", &Surface::copy)
-        .def("subsurface", &Surface::subsurface)
+        }, py::arg("color") = Color(0, 0, 0, 0), py::call_guard<py::gil_scoped_release>())
+        .def("draw_line", &Surface::draw_line, py::call_guard<py::gil_scoped_release>())
+        .def("draw_rect", &Surface::draw_rect, py::call_guard<py::gil_scoped_release>())
+        .def("draw_circle", &Surface::draw_circle, py::call_guard<py::gil_scoped_release>())
+        .def("fill_circle", &Surface::fill_circle, py::call_guard<py::gil_scoped_release>())
+        .def("blit", &Surface::blit, py::call_guard<py::gil_scoped_release>())
+        .def("blit_scaled", &Surface::blit_scaled, py::call_guard<py::gil_scoped_release>())
+        .def("blit_alpha", &Surface::blit_alpha, py::arg("source"), py::arg("dest_x"), py::arg("dest_y"), py::arg("alpha") = 1.0f, py::call_guard<py::gil_scoped_release>())
+        .def("copy", &Surface::copy, py::call_guard<py::gil_scoped_release>())
+        .def("subsurface", &Surface::subsurface, py::call_guard<py::gil_scoped_release>())
         // Advanced Shapes
         .def("draw_round_rect", &Surface::draw_round_rect,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"))
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
         .def("fill_round_rect", &Surface::fill_round_rect,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"))
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
         .def("draw_pill", &Surface::draw_pill,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
         .def("fill_pill", &Surface::fill_pill,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
         .def("draw_squircle", &Surface::draw_squircle,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
         .def("fill_squircle", &Surface::fill_squircle,
-             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"));
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"), py::call_guard<py::gil_scoped_release>())
+        // Batch drawing from numpy arrays (binned per tile, GIL released)
+        .def("fill_circles", [](Surface& s, const BatchInts& xy, const py::object& radii, const py::object& colors) {
+            size_t n = batch_rows(xy, 2, "xy");
+            BatchColors c(colors, n);
+            BatchScalars<int32_t> r(radii, n, "radii");
+            py::gil_scoped_release release;
+            BatchDraw::fill_circles(s, xy.data(), r.view(), c.view(), n);
+        }, py::arg("xy"), py::arg("radii"), py::arg("colors"),
+           "Fill N circles: xy (N, 2), radii number or (N,), colors Color or (N, 4) uint8")
+        .def("draw_lines", [](Surface& s, const BatchInts& segments, const py::object& colors) {
+            size_t n = batch_rows(segments, 4, "segments");
+            BatchColors c(colors, n);
+            py::gil_scoped_release release;
+            BatchDraw::draw_lines(s, segments.data(), c.view(), n);
+        }, py::arg("segments"), py::arg("colors"), "Draw N lines: segments (N, 4) as x1, y1, x2, y2")
+        .def("fill_rects", [](Surface& s, const BatchInts& rects, const py::object& colors) {
+            size_t n = batch_rows(rects, 4, "rects");
+            BatchColors c(colors, n);
+            py::gil_scoped_release release;
+            BatchDraw::fill_rects(s, rects.data(), c.view(), n);
+        }, py::arg("rects"), py::arg("colors"), "Fill N rects: rects (N, 4) as x, y, w, h")
+        .def("set_pixels", [](Surface& s, const BatchInts& xy, const py::object& colors) {
+            size_t n = batch_rows(xy, 2, "xy");
+            BatchColors c(colors, n);
+            py::gil_scoped_release release;
+            BatchDraw::set_pixels(s, xy.data(), c.view(), n);
+        }, py::arg("xy"), py::arg("colors"), "Set N pixels: xy (N, 2)");
+
+    // === Atlas ===
+    py::class_<Atlas, std::shared_ptr<Atlas>>(m, "Atlas",
+        "Packs small surfaces into shared pages; regions are ordinary Surfaces")
+        .def(py::init<int, int>(), py::arg("page_width") = 1024, py::arg("page_height") = 1024)
+        .def("allocate", &Atlas::allocate, py::arg("width"), py::arg("height"),
+             "New transparent region; returned to the atlas when the Surface is dropped")
+        .def("add", &Atlas::add, py::arg("source"), "New region holding a copy of source")
+        .def("free", &Atlas::free, py::arg("view"))
+        .def("owns", &Atlas::owns, py::arg("view"))
+        .def("defragment", &Atlas::defragment, py::call_guard<py::gil_scoped_release>())
+        .def("page", &Atlas::get_page, py::arg("index"))
+        .def_property_readonly("page_count", &Atlas::get_page_count)
+        .def_property_readonly("stats", [](const Atlas& a) {
+            AtlasStats s = a.get_stats();
+            py::dict d;
+            d["pages"] = s.pages;
+            d["regions"] = s.regions;
+            d["used_pixels"] = s.used_pixels;
+            d["page_pixels"] = s.page_pixels;
+            d["free_rects"] = s.free_rects;
+            return d;
+        });
+
+    // === Sprite Batch ===
+    py::class_<SpriteBatch, std::shared_ptr<SpriteBatch>>(m, "SpriteBatch",
+        "Draws many instances of one surface or atlas in one call")
+        .def(py::init<std::shared_ptr<Surface>>(), py::arg("source"))
+        .def_property("source", &SpriteBatch::get_source, &SpriteBatch::set_source)
+        .def("draw", [](const SpriteBatch& batch, Surface& target, const BatchFloats& xy,
+                        const py::object& scale, const py::object& rotation, const py::object& tint,
+                        const py::object& alpha, const py::object& rects) {
+            SpriteInstances in;
+            in.count = batch_rows(xy, 2, "xy");
+            in.xy = xy.data();
+            std::optional<BatchScalars<float>> s, r, a;
+            std::optional<BatchColors> t;
+            BatchInts rect_array;
+            if (!scale.is_none()) in.scale = s.emplace(scale, in.count, "scale").view();
+            if (!rotation.is_none()) in.rotation = r.emplace(rotation, in.count, "rotation").view();
+            if (!alpha.is_none()) in.alpha = a.emplace(alpha, in.count, "alpha").view();
+            if (!tint.is_none()) in.tint = t.emplace(tint, in.count).view();
+            if (!rects.is_none()) {
+                rect_array = BatchInts::ensure(rects);
+                bool shared = rect_array && rect_array.ndim() == 1 && rect_array.shape(0) == 4;
+                bool per_item = rect_array && rect_array.ndim() == 2 && rect_array.shape(1) == 4 &&
+                                static_cast<size_t>(rect_array.shape(0)) == in.count;
+                if (!shared && !per_item) throw py::value_error("rects must have shape (4,) or (N, 4)");
+                in.rects = Strided<int32_t>(rect_array.data(), shared ? 0 : 4);
+            }
+            py::gil_scoped_release release;
+            batch.draw(target, in);
+        }, py::arg("target"), py::arg("xy"), py::arg("scale") = py::none(), py::arg("rotation") = py::none(),
+           py::arg("tint") = py::none(), py::arg("alpha") = py::none(), py::arg("rects") = py::none(),
+           "Draw N instances: xy (N, 2) top-left; scale, rotation (radians) and alpha number or (N,); "
+           "tint Color or (N, 4); rects (4,) or (N, 4) source rects in the atlas");
+
+    // === Display List ===
+    py::class_<DisplayList, std::shared_ptr<DisplayList>>(m, "DisplayList",
+        "Records draw calls and replays them tile-parallel, optionally inside a damage rect")
+        .def(py::init<>())
+        .def("clear", &DisplayList::clear)
+        .def("__len__", &DisplayList::size)
+        .def("fill", &DisplayList::fill, py::arg("color"))
+        .def("fill_rect", &DisplayList::fill_rect,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("draw_rect", &DisplayList::draw_rect,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("draw_line", &DisplayList::draw_line,
+             py::arg("x1"), py::arg("y1"), py::arg("x2"), py::arg("y2"), py::arg("color"))
+        .def("draw_circle", &DisplayList::draw_circle,
+             py::arg("cx"), py::arg("cy"), py::arg("radius"), py::arg("color"))
+        .def("fill_circle", &DisplayList::fill_circle,
+             py::arg("cx"), py::arg("cy"), py::arg("radius"), py::arg("color"))
+        .def("draw_round_rect", &DisplayList::draw_round_rect,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"))
+        .def("fill_round_rect", &DisplayList::fill_round_rect,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"), py::arg("color"))
+        .def("draw_pill", &DisplayList::draw_pill,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("fill_pill", &DisplayList::fill_pill,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("draw_squircle", &DisplayList::draw_squircle,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("fill_squircle", &DisplayList::fill_squircle,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("color"))
+        .def("blit", &DisplayList::blit, py::arg("source"), py::arg("dest_x"), py::arg("dest_y"))
+        .def("blit_alpha", &DisplayList::blit_alpha,
+             py::arg("source"), py::arg("dest_x"), py::arg("dest_y"), py::arg("alpha") = 1.0f)
+        .def("blit_scaled", &DisplayList::blit_scaled,
+             py::arg("source"), py::arg("dest_x"), py::arg("dest_y"), py::arg("dest_w"), py::arg("dest_h"))
+        .def("draw_text", [](DisplayList& dl, const std::string& text, int x, int y, const Color& color,
+                             const std::string& font, int size) {
+            dl.draw_text([text, color, font, size]() -> std::shared_ptr<Surface> {
+                return TextLayoutCache::instance().render(font, size, text, color);
+            }, x, y);
+        }, py::arg("text"), py::arg("x"), py::arg("y"), py::arg("color") = Color(255, 255, 255, 255),
+           py::arg("font") = "Arial", py::arg("size") = 16, "Text is rasterized once, on first replay")
+        .def("push_clip", &DisplayList::push_clip, py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"))
+        .def("pop_clip", &DisplayList::pop_clip)
+        .def("blur_region", &DisplayList::blur_region,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("radius"))
+        .def("frosted_glass_region", &DisplayList::frosted_glass_region,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"), py::arg("blur_radius"))
+        .def("replay", py::overload_cast<Surface&>(&DisplayList::replay), py::arg("target"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("replay", py::overload_cast<Surface&, int, int, int, int>(&DisplayList::replay),
+             py::arg("target"), py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"),
+             py::call_guard<py::gil_scoped_release>(), "Replay only inside the damage rect")
+        .def_property_readonly("stats", [](const DisplayList& dl) {
+            const DisplayListStats& s = dl.get_last_stats();
+            py::dict d;
+            d["commands"] = s.commands;
+            d["culled"] = s.culled;
+            d["tiles"] = s.tiles;
+            d["tile_commands"] = s.tile_commands;
+            return d;
+        }, "Counters from the last replay");
     
     // === Event Types ===
     py::enum_<EventType>(m, "EventType")
@@ -220,7 +588,9 @@ Example:
         .def_readwrite("mouse_y", &Event::mouse_y)
         .def_readwrite("mouse_button", &Event::mouse_button)
         .def_readwrite("wheel_x", &Event::wheel_x)
-        .def_readwrite("wheel_y", &Event::wheel_y);
+        .def_readwrite("wheel_y", &Event::wheel_y)
+        .def_readwrite("timestamp", &Event::timestamp)
+        .def_readwrite("frame_id", &Event::frame_id);
     
     // === Window ===
     py::class_<Window>(m, "Window")
@@ -246,19 +616,69 @@ Example:
             w.wait_event(e);
             return e;
         })
+        .def("push_event", &Window::push_event, py::arg("event"),
+             "Queue an event ahead of the OS queue (scripted input, replay)")
         .def("draw", &Window::draw, py::arg("surface"))
-        .def("present", py::overload_cast<>(&Window::present))
-        .def("present", py::overload_cast<const Surface&>(&Window::present))
+        .def("present", py::overload_cast<>(&Window::present), py::call_guard<py::gil_scoped_release>())
+        .def("present", py::overload_cast<const Surface&>(&Window::present), py::call_guard<py::gil_scoped_release>())
         .def("clear", &Window::clear, py::arg("color") = Color(0, 0, 0, 255))
         .def("set_target_fps", &Window::set_target_fps)
         .def("set_unfocused_fps", &Window::set_unfocused_fps)
+        .def_property("fixed_timestep", &Window::get_fixed_timestep, &Window::set_fixed_timestep,
+                      "Seconds reported as delta_time each frame, with no frame limiting (0 = real time)")
         .def_property_readonly("is_focused", &Window::is_focused)
         .def_property_readonly("is_minimized", &Window::is_minimized)
         .def("set_cursor_visible", &Window::set_cursor_visible)
         .def("set_cursor_position", &Window::set_cursor_position)
+        .def("sample_mouse", [](Window& w) {
+            int x = 0, y = 0;
+            w.sample_mouse(x, y);
+            return py::make_tuple(x, y);
+        }, "Current mouse position, bypassing the event queue")
+        .def_property_readonly("frame_id", &Window::get_frame_id)
+        .def("latency_stats", [](Window& w) { return latency_stats_to_dict(w.get_latency().get_stats()); },
+             "Input-to-present latency percentiles over recent frames")
+        .def("reset_latency", [](Window& w) { w.get_latency().reset(); })
+        .def_property("latency_samples",
+                      [](Window& w) { return w.get_latency().get_capacity(); },
+                      [](Window& w, size_t n) { w.get_latency().set_capacity(n); })
+        .def("start_recording", &Window::start_recording, py::arg("recorder"),
+             "Record every delivered event into an EventRecorder")
+        .def("stop_recording", &Window::stop_recording)
+        .def_property_readonly("is_recording", &Window::is_recording)
+        .def("start_replay", &Window::start_replay, py::arg("replay"),
+             "Deliver an EventReplay in place of live input until it runs out")
+        .def("stop_replay", &Window::stop_replay)
+        .def_property_readonly("is_replaying", &Window::is_replaying)
         .def("set_fullscreen", &Window::set_fullscreen)
         .def("close", &Window::close);
     
+    // === Event Recording / Replay ===
+    py::class_<EventRecorder, std::shared_ptr<EventRecorder>>(m, "EventRecorder")
+        .def(py::init<>())
+        .def("save", &EventRecorder::save, py::arg("path"), "Write a compact binary recording (.pdev)")
+        .def("clear", &EventRecorder::clear)
+        .def_property_readonly("event_count", &EventRecorder::get_event_count)
+        .def_property_readonly("frame_count", &EventRecorder::get_frame_count)
+        .def_property_readonly("duration_ms", &EventRecorder::get_duration_ms)
+        .def_property_readonly("mean_dt", &EventRecorder::get_mean_dt);
+    
+    py::enum_<ReplayMode>(m, "ReplayMode")
+        .value("Frames", ReplayMode::Frames)
+        .value("Realtime", ReplayMode::Realtime);
+    
+    py::class_<EventReplay, std::shared_ptr<EventReplay>>(m, "EventReplay")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def(py::init<const EventRecorder&>(), py::arg("recorder"))
+        .def_property("mode", &EventReplay::get_mode, &EventReplay::set_mode)
+        .def_property("speed", &EventReplay::get_speed, &EventReplay::set_speed,
+                      "Realtime playback rate (2.0 = twice as fast)")
+        .def_property_readonly("finished", &EventReplay::is_finished)
+        .def_property_readonly("position", &EventReplay::get_position)
+        .def_property_readonly("event_count", &EventReplay::get_event_count)
+        .def_property_readonly("frame_count", &EventReplay::get_frame_count)
+        .def_property_readonly("recorded_dt", &EventReplay::get_recorded_dt);
+    
     // === Easing Types ===
     py::enum_<EasingType>(m, "EasingType")
         .value("Linear", EasingType::Linear)
@@ -334,41 +754,99 @@ Example:
         .def_static("wobbly", &SpringAnimation::wobbly)
         .def_static("stiff", &SpringAnimation::stiff)
         .def_static("slow", &SpringAnimation::slow);
+
+    // === Particles ===
+    py::enum_<EmitterShape>(m, "EmitterShape")
+        .value("Point", EmitterShape::Point)
+        .value("Circle", EmitterShape::Circle)
+        .value("Ring", EmitterShape::Ring)
+        .value("Rect", EmitterShape::Rect)
+        .value("Line", EmitterShape::Line);
+
+    py::class_<ParticleEmitter>(m, "ParticleEmitter",
+        "Spawn settings; angles in radians, clockwise on screen")
+        .def(py::init<>())
+        .def_readwrite("shape", &ParticleEmitter::shape)
+        .def_readwrite("x", &ParticleEmitter::x)
+        .def_readwrite("y", &ParticleEmitter::y)
+        .def_readwrite("width", &ParticleEmitter::width)
+        .def_readwrite("height", &ParticleEmitter::height)
+        .def_readwrite("radius", &ParticleEmitter::radius)
+        .def_readwrite("rate", &ParticleEmitter::rate)
+        .def_readwrite("enabled", &ParticleEmitter::enabled)
+        .def_readwrite("angle", &ParticleEmitter::angle)
+        .def_readwrite("spread", &ParticleEmitter::spread)
+        .def_readwrite("radial", &ParticleEmitter::radial)
+        .def_readwrite("speed_min", &ParticleEmitter::speed_min)
+        .def_readwrite("speed_max", &ParticleEmitter::speed_max)
+        .def_readwrite("lifetime_min", &ParticleEmitter::lifetime_min)
+        .def_readwrite("lifetime_max", &ParticleEmitter::lifetime_max);
+
+    py::class_<ParticleSystem, std::shared_ptr<ParticleSystem>>(m, "ParticleSystem",
+        "Native particle simulation and batched rendering")
+        .def(py::init<size_t>(), py::arg("max_particles") = 10000)
+        .def("add_emitter", &ParticleSystem::add_emitter, py::arg("emitter"))
+        .def("emitter", &ParticleSystem::get_emitter, py::arg("index"), py::return_value_policy::copy,
+             "Copy of an emitter; write changes back with set_emitter")
+        .def("set_emitter", &ParticleSystem::set_emitter, py::arg("index"), py::arg("emitter"))
+        .def_property_readonly("emitter_count", &ParticleSystem::get_emitter_count)
+        .def("clear_emitters", &ParticleSystem::clear_emitters)
+        .def("burst", &ParticleSystem::burst, py::arg("emitter"), py::arg("count"))
+        .def("update", &ParticleSystem::update, py::arg("dt"), py::call_guard<py::gil_scoped_release>())
+        .def("clear", &ParticleSystem::clear)
+        .def("seed", &ParticleSystem::seed, py::arg("value"))
+        .def_property_readonly("count", &ParticleSystem::get_count)
+        .def_property("max_particles", &ParticleSystem::get_max_particles, &ParticleSystem::set_max_particles)
+        .def_property("gravity", [](const ParticleSystem& p) {
+            return py::make_tuple(p.get_gravity_x(), p.get_gravity_y());
+        }, [](ParticleSystem& p, std::pair<float, float> g) { p.set_gravity(g.first, g.second); })
+        .def_property("drag", &ParticleSystem::get_drag, &ParticleSystem::set_drag)
+        .def("set_color", &ParticleSystem::set_color,
+             py::arg("start"), py::arg("end"), py::arg("easing") = EasingType::Linear)
+        .def("set_size", &ParticleSystem::set_size,
+             py::arg("start"), py::arg("end"), py::arg("easing") = EasingType::Linear)
+        .def("render", py::overload_cast<Surface&, int, int>(&ParticleSystem::render, py::const_),
+             py::arg("target"), py::arg("offset_x") = 0, py::arg("offset_y") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("render", py::overload_cast<Layer&, int, int>(&ParticleSystem::render, py::const_),
+             py::arg("layer"), py::arg("offset_x") = 0, py::arg("offset_y") = 0,
+             py::call_guard<py::gil_scoped_release>());
     
     // === Effects ===
     py::class_<Effects>(m, "Effects")
-        .def_static("box_blur", &Effects::box_blur)
-        .def_static("gaussian_blur", &Effects::gaussian_blur)
-        .def_static("blur_region", &Effects::blur_region)
+        .def_static("box_blur", &Effects::box_blur, py::call_guard<py::gil_scoped_release>())
+        .def_static("gaussian_blur", &Effects::gaussian_blur, py::call_guard<py::gil_scoped_release>())
+        .def_static("blur_region", &Effects::blur_region, py::call_guard<py::gil_scoped_release>())
         .def_static("frosted_glass", &Effects::frosted_glass,
                     py::arg("surface"), py::arg("blur_radius") = 10,
-                    py::arg("noise_amount") = 0.05f, py::arg("saturation") = 0.8f)
+                    py::arg("noise_amount") = 0.05f, py::arg("saturation") = 0.8f, py::call_guard<py::gil_scoped_release>())
         .def_static("frosted_glass_region", &Effects::frosted_glass_region,
                     py::arg("surface"), py::arg("x"), py::arg("y"),
-                    py::arg("w"), py::arg("h"), py::arg("blur_radius") = 10)
+                    py::arg("w"), py::arg("h"), py::arg("blur_radius") = 10, py::call_guard<py::gil_scoped_release>())
         .def_static("displace", &Effects::displace,
-                    py::arg("surface"), py::arg("displacement_map"), py::arg("strength") = 10.0f)
+                    py::arg("surface"), py::arg("displacement_map"), py::arg("strength") = 10.0f, py::call_guard<py::gil_scoped_release>())
         .def_static("wave_distort", &Effects::wave_distort,
-                    py::arg("surface"), py::arg("amplitude"), py::arg("frequency"), py::arg("phase") = 0.0f)
+                    py::arg("surface"), py::arg("amplitude"), py::arg("frequency"), py::arg("phase") = 0.0f, py::call_guard<py::gil_scoped_release>())
         .def_static("ripple", &Effects::ripple,
                     py::arg("surface"), py::arg("center_x"), py::arg("center_y"),
-                    py::arg("amplitude"), py::arg("wavelength"), py::arg("phase") = 0.0f)
-        .def_static("brightness", &Effects::brightness)
-        .def_static("contrast", &Effects::contrast)
-        .def_static("saturation", &Effects::saturation)
-        .def_static("hue_shift", &Effects::hue_shift)
-        .def_static("invert", &Effects::invert)
-        .def_static("grayscale", &Effects::grayscale)
-        .def_static("sepia", &Effects::sepia, py::arg("surface"), py::arg("strength") = 1.0f)
-        .def_static("blend", &Effects::blend)
-        .def_static("linear_gradient", &Effects::linear_gradient)
-        .def_static("radial_gradient", &Effects::radial_gradient)
-        .def_static("noise", &Effects::noise)
+                    py::arg("amplitude"), py::arg("wavelength"), py::arg("phase") = 0.0f, py::call_guard<py::gil_scoped_release>())
+        .def_static("brightness", &Effects::brightness, py::call_guard<py::gil_scoped_release>())
+        .def_static("contrast", &Effects::contrast, py::call_guard<py::gil_scoped_release>())
+        .def_static("saturation", &Effects::saturation, py::call_guard<py::gil_scoped_release>())
+        .def_static("hue_shift", &Effects::hue_shift, py::call_guard<py::gil_scoped_release>())
+        .def_static("invert", &Effects::invert, py::call_guard<py::gil_scoped_release>())
+        .def_static("grayscale", &Effects::grayscale, py::call_guard<py::gil_scoped_release>())
+        .def_static("sepia", &Effects::sepia, py::arg("surface"), py::arg("strength") = 1.0f, py::call_guard<py::gil_scoped_release>())
+        .def_static("blend", &Effects::blend, py::call_guard<py::gil_scoped_release>())
+        .def_static("linear_gradient", &Effects::linear_gradient, py::call_guard<py::gil_scoped_release>())
+        .def_static("radial_gradient", &Effects::radial_gradient, py::call_guard<py::gil_scoped_release>())
+        .def_static("noise", &Effects::noise, py::call_guard<py::gil_scoped_release>())
         .def_static("perlin_noise", &Effects::perlin_noise,
-                    py::arg("surface"), py::arg("scale"), py::arg("octaves") = 4)
+                    py::arg("surface"), py::arg("scale"), py::arg("octaves") = 4, py::call_guard<py::gil_scoped_release>())
+        .def_static("seed", &Effects::seed, py::arg("value"), "Reseed the noise generator")
         .def_static("drop_shadow", &Effects::drop_shadow,
                     py::arg("source"), py::arg("offset_x"), py::arg("offset_y"),
-                    py::arg("blur_radius"), py::arg("shadow_color"));
+                    py::arg("blur_radius"), py::arg("shadow_color"), py::call_guard<py::gil_scoped_release>());
     
     // === BlurredSurface ===
     py::class_<BlurredSurface, std::shared_ptr<BlurredSurface>>(m, "BlurredSurface")
@@ -391,10 +869,10 @@ Example:
              "Update blur animation")
         .def_property_readonly("animating", &BlurredSurface::is_animating)
         .def("render", &BlurredSurface::render,
-             "Return a new blurred surface")
+             "Return a new blurred surface", py::call_guard<py::gil_scoped_release>())
         .def("render_to", &BlurredSurface::render_to,
              py::arg("dest"), py::arg("x"), py::arg("y"),
-             "Render blurred content to destination surface")
+             "Render blurred content to destination surface", py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("width", &BlurredSurface::get_width)
         .def_property_readonly("height", &BlurredSurface::get_height);
     
@@ -436,6 +914,11 @@ Example:
         .def_property_readonly("y", &Layer::get_y)
         .def("set_position", &Layer::set_position)
         .def("move", &Layer::move)
+        .def("latch_to_pointer", &Layer::latch_to_pointer,
+             py::arg("offset_x") = 0, py::arg("offset_y") = 0,
+             "Follow the pointer sampled at composite time (see LayerStack.set_late_latch)")
+        .def("release_pointer", &Layer::release_pointer)
+        .def_property_readonly("latched_to_pointer", &Layer::is_latched_to_pointer)
         .def_property("scale_x", &Layer::get_scale_x, [](Layer& l, float s) { l.set_scale(s, l.get_scale_y()); })
         .def_property("scale_y", &Layer::get_scale_y, [](Layer& l, float s) { l.set_scale(l.get_scale_x(), s); })
         .def("set_scale", py::overload_cast<float, float>(&Layer::set_scale))
@@ -465,8 +948,21 @@ Example:
         .def("move_layer_to_top", &LayerStack::move_layer_to_top)
         .def("move_layer_to_bottom", &LayerStack::move_layer_to_bottom)
         .def("set_layer_index", &LayerStack::set_layer_index)
-        .def("composite", &LayerStack::composite)
-        .def("composite_to", &LayerStack::composite_to)
+        .def("composite", &LayerStack::composite, py::call_guard<py::gil_scoped_release>())
+        .def("composite_to", &LayerStack::composite_to, py::call_guard<py::gil_scoped_release>())
+        .def("set_late_latch", [](LayerStack& s, Window& w) {
+            s.set_pointer_source([&w](int& x, int& y) { w.sample_mouse(x, y); });
+        }, py::arg("window"), py::keep_alive<1, 2>(),
+           "Sample the window's mouse right before compositing to move pointer-latched layers")
+        .def("set_pointer_source", [](LayerStack& s, py::function source) {
+            s.set_pointer_source([source = share_object(source)](int& x, int& y) {
+                py::gil_scoped_acquire gil;
+                auto pos = (*source)().cast<std::pair<int, int>>();
+                x = pos.first;
+                y = pos.second;
+            });
+        }, py::arg("source"), "Late latch from a callable returning (x, y)")
+        .def("clear_late_latch", &LayerStack::clear_pointer_source)
         .def("set_background", &LayerStack::set_background)
         .def("get_background", &LayerStack::get_background)
         .def_property("background", &LayerStack::get_background, &LayerStack::set_background)
@@ -494,6 +990,167 @@ Example:
     // Expose singleton as module attribute 'anti_aliasing'
     m.attr("anti_aliasing") = py::cast(&AntiAliasingSettings::instance(), py::return_value_policy::reference);
 
+    // === Profiler (singleton exposed as module attribute) ===
+    py::class_<Profiler>(m, "Profiler")
+        .def("enable", &Profiler::enable, "Start collecting stage timings")
+        .def("disable", &Profiler::disable, "Stop collecting stage timings")
+        .def_property_readonly("enabled", &Profiler::is_enabled)
+        .def("last_frame", [](const Profiler& p) { return frame_summary_to_dict(p.get_last_frame()); },
+             "Stage timings of the most recently presented frame")
+        .def("stats", [](const Profiler& p, int frames) { return frame_summary_to_dict(p.get_average(frames)); },
+             py::arg("frames") = 60,
+             "Per-frame stage timings averaged over the last N frames")
+        .def("export_chrome_trace", &Profiler::export_chrome_trace, py::arg("path"),
+             "Write recorded frames as Chrome trace JSON (open in chrome://tracing or Perfetto)")
+        .def_property("history_frames", &Profiler::get_history_frames, &Profiler::set_history_frames)
+        .def_property_readonly("frame_count", &Profiler::get_frame_count)
+        .def_property_readonly("dropped_samples", &Profiler::get_dropped_samples)
+        .def("end_frame", &Profiler::end_frame, "Close a frame manually (Window.present does this)")
+        .def("reset", &Profiler::reset);
+    
+    m.attr("profiler") = py::cast(&Profiler::instance(), py::return_value_policy::reference);
+
+    // === Surface memory tracking (singleton exposed as module attribute) ===
+    py::class_<MemoryTracker>(m, "MemoryTracker")
+        .def("stats", [](const MemoryTracker& t) { return memory_stats_to_dict(t.get_stats()); },
+             "Live surface count/bytes, peak and per-origin totals")
+        .def_property_readonly("bytes", &MemoryTracker::get_live_bytes)
+        .def_property("soft_budget", &MemoryTracker::get_soft_budget, &MemoryTracker::set_soft_budget,
+                      "Bytes; crossing it asks caches to trim (0 = unlimited)")
+        .def_property("hard_budget", &MemoryTracker::get_hard_budget, &MemoryTracker::set_hard_budget,
+                      "Bytes; caches are emptied and allocations beyond it raise (0 = unlimited)")
+        .def("reset_peak", &MemoryTracker::reset_peak)
+        .def("evict", [](MemoryTracker& t, bool hard) {
+            t.evict(hard ? MemoryPressure::Hard : MemoryPressure::Soft);
+        }, py::arg("hard") = false, "Run all cache evictors now")
+        .def("add_evictor", [](MemoryTracker& t, py::function fn) {
+            return t.add_evictor([fn = share_object(fn)](MemoryPressure p) {
+                py::gil_scoped_acquire gil;
+                (*fn)(p == MemoryPressure::Hard);
+            });
+        }, py::arg("callback"), "Register callback(hard: bool) run under memory pressure; returns an id")
+        .def("remove_evictor", &MemoryTracker::remove_evictor, py::arg("id"))
+        .def("pool_stats", [](const MemoryTracker&) {
+            BufferPoolStats p = BufferPool::instance().get_stats();
+            py::dict d;
+            d["hits"] = p.hits;
+            d["misses"] = p.misses;
+            d["buffers"] = p.pooled_buffers;
+            d["bytes"] = p.pooled_bytes;
+            d["max_bytes"] = p.max_pooled_bytes;
+            d["scratch_bytes"] = ScratchArena::local().get_capacity();
+            return d;
+        }, "Pixel buffer pool reuse and idle bytes; scratch arena size of this thread")
+        .def_property("pool_limit",
+                      [](const MemoryTracker&) { return BufferPool::instance().get_stats().max_pooled_bytes; },
+                      [](MemoryTracker&, size_t bytes) { BufferPool::instance().set_max_pooled_bytes(bytes); },
+                      "Maximum idle bytes kept for reuse")
+        .def("trim_pool", [](MemoryTracker&) { BufferPool::instance().trim(); },
+             "Free all idle pooled pixel buffers");
+    
+    m.attr("memory") = py::cast(&MemoryTracker::instance(), py::return_value_policy::reference);
+    
+    // === Thread Pool ===
+    m.def("set_threads", [](int n) { ThreadPool::instance().set_threads(n); }, py::arg("n"),
+          py::call_guard<py::gil_scoped_release>(),
+          "Threads used for parallel rendering, including the caller (0 = one per core, 1 = serial)");
+    m.def("get_threads", []() { return ThreadPool::instance().get_threads(); });
+    m.def("set_thread_pinning", [](bool pinned) { return ThreadPool::instance().set_pinning(pinned); },
+          py::arg("pinned"),
+          "Pin pool workers to every core but 0, leaving it to the UI thread; False if unsupported");
+    m.def("thread_pool_stats", []() {
+        ThreadPoolStats s = ThreadPool::instance().get_stats();
+        py::dict d;
+        d["threads"] = s.threads;
+        d["tasks_executed"] = s.tasks_executed;
+        d["tasks_stolen"] = s.tasks_stolen;
+        d["pinned"] = s.pinned;
+        return d;
+    });
+
+    // === Text Caches ===
+    m.def("glyph_atlas_stats", []() {
+        GlyphAtlasStats s = GlyphAtlas::instance().get_stats();
+        py::dict d;
+        d["pages"] = s.pages;
+        d["glyphs"] = s.glyphs;
+        d["used_pixels"] = s.used_pixels;
+        d["page_pixels"] = s.page_pixels;
+        return d;
+    }, "Glyphs rasterized once and shared by all CPU text drawing");
+    m.def("text_cache_stats", []() {
+        TextCacheStats s = TextLayoutCache::instance().get_stats();
+        py::dict d;
+        d["hits"] = s.hits;
+        d["misses"] = s.misses;
+        d["hit_rate"] = s.hits + s.misses ? static_cast<double>(s.hits) / (s.hits + s.misses) : 0.0;
+        d["evictions"] = s.evictions;
+        d["entries"] = s.entries;
+        d["bytes"] = s.bytes;
+        d["budget"] = s.budget;
+        return d;
+    });
+    m.def("set_text_cache_budget", [](size_t bytes) { TextLayoutCache::instance().set_budget(bytes); },
+          py::arg("bytes"), "Bytes of laid-out and rendered strings kept for reuse (default 8 MB)");
+    m.def("clear_text_cache", []() { TextLayoutCache::instance().clear(); });
+    m.def("reset_text_cache_stats", []() { TextLayoutCache::instance().reset_stats(); });
+    m.def("font_cache_stats", []() {
+        FontCacheStats s = FontCache::get_stats();
+        py::dict d;
+        d["hits"] = s.hits;
+        d["misses"] = s.misses;
+        d["evictions"] = s.evictions;
+        d["cached"] = s.cached;
+        d["open_handles"] = s.open_handles;
+        d["capacity"] = s.capacity;
+        return d;
+    });
+    m.def("set_font_cache_capacity", &FontCache::set_capacity, py::arg("fonts"),
+          "Fonts (name and size) kept open for reuse (default 32); fonts in use are never closed");
+    m.def("prepare_text", [](const std::string& font, int size, std::vector<std::string> texts, int wrap_width) {
+        py::gil_scoped_release release;
+        for (auto& layout : TextRasterizer::layout(font, size, std::move(texts), wrap_width)) layout.wait();
+    }, py::arg("font"), py::arg("size"), py::arg("texts"), py::arg("wrap_width") = 0,
+       "Lay out many strings in parallel ahead of drawing them (fills the text cache)");
+    m.def("measure_text", [](const std::string& font, int size, std::vector<std::string> texts) {
+        std::vector<TextMetrics> metrics;
+        {
+            py::gil_scoped_release release;
+            auto f = FontCache::get(font, size);
+            if (!f) throw std::runtime_error("measure_text: cannot load font " + font);
+            metrics = f->measure_all(texts);
+        }
+        py::list out;
+        for (const TextMetrics& m : metrics) {
+            py::dict d;
+            d["width"] = m.width;
+            d["height"] = m.height;
+            d["advances"] = m.advances;
+            d["positions"] = m.positions;
+            out.append(d);
+        }
+        return out;
+    }, py::arg("font"), py::arg("size"), py::arg("texts"),
+       "Per code point advances and pen positions of each string, measured in one call");
+    m.def("system_fonts", []() {
+        py::list fonts;
+        for (const FontFace& face : FontIndex::instance().list()) {
+            py::dict d;
+            d["family"] = face.family;
+            d["style"] = face.style;
+            d["path"] = face.path;
+            fonts.append(d);
+        }
+        return fonts;
+    }, "Fonts in the system font index");
+    m.def("rebuild_font_index", []() {
+        py::gil_scoped_release release;
+        FontIndex::instance().rebuild();
+        // Names resolved (or fonts that failed) against the old index look up again
+        FontCache::forget_resolved();
+    }, "Rescan the system font directories. Otherwise directory changes are only noticed "
+       "at the first font lookup of a process");
+
     // === Key Enum ===
     py::enum_<Key>(m, "Key")
         .value("Unknown", Key::Unknown)
@@ -846,6 +1503,10 @@ Example:
              "Present the rendered frame to the screen")
         .def_property_readonly("delta_time", &palladium::GPUWindow::get_delta_time)
         .def_property_readonly("fps", &palladium::GPUWindow::get_fps)
+        .def_property_readonly("frame_id", &palladium::GPUWindow::get_frame_id)
+        .def("latency_stats", [](palladium::GPUWindow& w) { return latency_stats_to_dict(w.get_latency().get_stats()); },
+             "Input-to-present latency percentiles over recent frames")
+        .def("reset_latency", [](palladium::GPUWindow& w) { w.get_latency().reset(); })
         .def("set_target_fps", &palladium::GPUWindow::set_target_fps)
         .def("set_unfocused_fps", &palladium::GPUWindow::set_unfocused_fps)
         .def_property_readonly("is_focused", &palladium::GPUWindow::is_focused)
@@ -913,7 +1574,11 @@ Example:
              py::arg("color"), py::arg("offset_x"), py::arg("offset_y"), py::arg("blur"))
         .def("set_outline", &palladium::CPUText::set_outline,
              py::arg("color"), py::arg("width"))
-        .def("draw", &palladium::CPUText::draw)
+        .def_property("sdf", &palladium::CPUText::get_sdf, &palladium::CPUText::set_sdf,
+                      "Draw from distance fields: crisp at any size and rotation without re-rasterizing")
+        .def_property("rotation", &palladium::CPUText::get_rotation, &palladium::CPUText::set_rotation)
+        .def("set_glow", &palladium::CPUText::set_glow, py::arg("color"), py::arg("radius"))
+        .def("draw", &palladium::CPUText::draw, py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("render_width", &palladium::CPUText::get_render_width)
         .def_property_readonly("render_height", &palladium::CPUText::get_render_height);
 
@@ -0,0 +1,158 @@
+#include "memory_tracker.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace nativeui {
+
+thread_local const char* MemoryTracker::current_origin_ = nullptr;
+
+// Set while evictors run so surfaces they allocate don't re-enter eviction
+static thread_local bool in_eviction = false;
+
+MemoryTracker::MemoryTracker()
+    : live_bytes_(0)
+    , soft_budget_(0)
+    , hard_budget_(0)
+    , live_count_(0)
+    , peak_bytes_(0)
+    , allocations_(0)
+    , evictions_(0)
+    , next_evictor_id_(1)
+{
+}
+
+const char* MemoryTracker::current_origin()
+{
+    return current_origin_ ? current_origin_ : "Surface";
+}
+
+MemoryTracker::Origin& MemoryTracker::find_origin(const char* name)
+{
+    // Few distinct tags; compare text since identical literals may not share an address
+    for (Origin& o : origins_) {
+        if (o.name == name || std::strcmp(o.name, name) == 0) return o;
+    }
+    Origin o;
+    o.name = name;
+    o.stats.origin = name;
+    origins_.push_back(o);
+    return origins_.back();
+}
+
+void MemoryTracker::on_allocate(const char* origin, size_t bytes)
+{
+    if (bytes == 0) return;
+
+    size_t soft = soft_budget_.load(std::memory_order_relaxed);
+    size_t hard = hard_budget_.load(std::memory_order_relaxed);
+
+    if (!in_eviction && (soft > 0 || hard > 0)) {
+        size_t before = live_bytes_.load(std::memory_order_relaxed);
+        if (hard > 0 && before + bytes > hard) {
+            evict(MemoryPressure::Hard);
+            if (live_bytes_.load(std::memory_order_relaxed) + bytes > hard) {
+                throw std::runtime_error("Surface memory budget exceeded (" + std::string(origin) +
+                                         " requested " + std::to_string(bytes) + " bytes)");
+            }
+        } else if (soft > 0 && before <= soft && before + bytes > soft) {
+            // Only on crossing the line, so an unshrinkable cache isn't asked every allocation
+            evict(MemoryPressure::Soft);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    live_count_++;
+    allocations_++;
+    peak_bytes_ = std::max(peak_bytes_, live);
+
+    OriginStats& s = find_origin(origin).stats;
+    s.live_count++;
+    s.live_bytes += bytes;
+    s.allocations++;
+    s.peak_bytes = std::max(s.peak_bytes, s.live_bytes);
+}
+
+void MemoryTracker::on_release(const char* origin, size_t bytes)
+{
+    if (bytes == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    live_count_--;
+
+    OriginStats& s = find_origin(origin).stats;
+    s.live_count--;
+    s.live_bytes -= bytes;
+}
+
+MemoryStats MemoryTracker::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryStats stats;
+    stats.live_count = live_count_;
+    stats.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+    stats.peak_bytes = peak_bytes_;
+    stats.allocations = allocations_;
+    stats.evictions = evictions_;
+    for (const Origin& o : origins_) {
+        stats.origins.push_back(o.stats);
+    }
+    std::sort(stats.origins.begin(), stats.origins.end(),
+              [](const OriginStats& a, const OriginStats& b) { return a.live_bytes > b.live_bytes; });
+    return stats;
+}
+
+void MemoryTracker::reset_peak()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    peak_bytes_ = live_bytes_.load(std::memory_order_relaxed);
+    for (Origin& o : origins_) {
+        o.stats.peak_bytes = o.stats.live_bytes;
+    }
+}
+
+int MemoryTracker::add_evictor(Evictor evictor)
+{
+    std::lock_guard<std::mutex> lock(evictor_mutex_);
+    int id = next_evictor_id_++;
+    evictors_.push_back({id, std::move(evictor)});
+    return id;
+}
+
+void MemoryTracker::remove_evictor(int id)
+{
+    std::lock_guard<std::mutex> lock(evictor_mutex_);
+    evictors_.erase(std::remove_if(evictors_.begin(), evictors_.end(),
+                                   [id](const EvictorEntry& e) { return e.id == id; }),
+                    evictors_.end());
+}
+
+void MemoryTracker::evict(MemoryPressure pressure)
+{
+    if (in_eviction) return;
+
+    // Run without holding locks: evictors free surfaces, which report back here
+    std::vector<EvictorEntry> evictors;
+    {
+        std::lock_guard<std::mutex> lock(evictor_mutex_);
+        evictors = evictors_;
+    }
+
+    in_eviction = true;
+    try {
+        for (const EvictorEntry& e : evictors) {
+            e.fn(pressure);
+        }
+    } catch (...) {
+        in_eviction = false;
+        throw;
+    }
+    in_eviction = false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictions_++;
+}
+
+} // namespace nativeui
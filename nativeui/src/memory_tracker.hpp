@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * Memory pressure levels passed to evictors
+ */
+enum class MemoryPressure {
+    Soft,   // Over the soft budget: trim what is cheap to rebuild
+    Hard    // Over the hard budget: release everything possible
+};
+
+/**
+ * Allocation totals for one origin tag
+ */
+struct OriginStats {
+    std::string origin;
+    size_t live_count = 0;
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    uint64_t allocations = 0;
+};
+
+/**
+ * MemoryStats - Snapshot of all tracked surface memory
+ */
+struct MemoryStats {
+    size_t live_count = 0;
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    uint64_t allocations = 0;
+    uint64_t evictions = 0;
+    std::vector<OriginStats> origins;  // Sorted by live bytes, descending
+};
+
+/**
+ * MemoryTracker - Registry of live Surface pixel memory (singleton)
+ *
+ * Every Surface reports its pixel buffer here, tagged with the origin active
+ * on the allocating thread (see AllocationTag). Optional soft and hard
+ * budgets run registered evictors (fonts, text layouts, SDF fields, idle
+ * pixel buffers) when exceeded; an allocation that would still exceed the
+ * hard budget throws.
+ */
+class MemoryTracker {
+public:
+    using Evictor = std::function<void(MemoryPressure)>;
+
+    static MemoryTracker& instance() {
+        // Leaked on purpose, like BufferPool: surfaces destroyed during
+        // static destruction still report their release here
+        static MemoryTracker* inst = new MemoryTracker();
+        return *inst;
+    }
+
+    // Called by Surface; may run evictors and throws if the hard budget is exceeded
+    void on_allocate(const char* origin, size_t bytes);
+    void on_release(const char* origin, size_t bytes);
+
+    MemoryStats get_stats() const;
+    size_t get_live_bytes() const { return live_bytes_.load(std::memory_order_relaxed); }
+    void reset_peak();
+
+    // Budgets in bytes (0 = unlimited)
+    void set_soft_budget(size_t bytes) { soft_budget_ = bytes; }
+    void set_hard_budget(size_t bytes) { hard_budget_ = bytes; }
+    size_t get_soft_budget() const { return soft_budget_; }
+    size_t get_hard_budget() const { return hard_budget_; }
+
+    // Cache eviction hooks; returns an id for remove_evictor
+    int add_evictor(Evictor evictor);
+    void remove_evictor(int id);
+
+    // Run all evictors now
+    void evict(MemoryPressure pressure);
+
+    // Origin tag for the calling thread
+    static const char* current_origin();
+
+private:
+    MemoryTracker();
+
+    struct Origin {
+        const char* name;
+        OriginStats stats;
+    };
+
+    struct EvictorEntry {
+        int id;
+        Evictor fn;
+    };
+
+    Origin& find_origin(const char* name);
+
+    std::atomic<size_t> live_bytes_;
+    std::atomic<size_t> soft_budget_;
+    std::atomic<size_t> hard_budget_;
+
+    mutable std::mutex mutex_;
+    std::vector<Origin> origins_;
+    size_t live_count_;
+    size_t peak_bytes_;
+    uint64_t allocations_;
+    uint64_t evictions_;
+
+    std::mutex evictor_mutex_;
+    std::vector<EvictorEntry> evictors_;
+    int next_evictor_id_;
+
+    friend class AllocationTag;
+    static thread_local const char* current_origin_;
+};
+
+/**
+ * AllocationTag - RAII origin tag for surfaces created in its scope
+ *
+ * Usage: AllocationTag tag("Font::render");
+ * The name must be a string literal.
+ */
+class AllocationTag {
+public:
+    explicit AllocationTag(const char* origin)
+        : previous_(MemoryTracker::current_origin_)
+    {
+        MemoryTracker::current_origin_ = origin;
+    }
+
+    ~AllocationTag() { MemoryTracker::current_origin_ = previous_; }
+
+    AllocationTag(const AllocationTag&) = delete;
+    AllocationTag& operator=(const AllocationTag&) = delete;
+
+private:
+    const char* previous_;
+};
+
+} // namespace nativeui
@@ -0,0 +1,249 @@
+#include "particles.hpp"
+#include "batch.hpp"
+#include "profiler.hpp"
+#include "scratch_arena.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace nativeui {
+
+namespace {
+
+const float kTwoPi = 6.2831855f;
+
+// Particles per parallel_for chunk; smaller systems integrate on the caller
+const int kIntegrateGrain = 8192;
+
+inline float lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+// Pixel coordinate of a particle that may have flown arbitrarily far away
+inline int32_t to_pixel(float v, int offset)
+{
+    return static_cast<int32_t>(std::lround(std::clamp(v, -1e6f, 1e6f))) + offset;
+}
+
+} // namespace
+
+ParticleSystem::ParticleSystem(size_t max_particles)
+    : max_particles_(max_particles), rng_(std::random_device{}())
+{
+}
+
+// ============ Emitters ============
+
+size_t ParticleSystem::add_emitter(const ParticleEmitter& emitter)
+{
+    emitters_.push_back(emitter);
+    spawn_carry_.push_back(0.0f);
+    return emitters_.size() - 1;
+}
+
+const ParticleEmitter& ParticleSystem::get_emitter(size_t index) const
+{
+    if (index >= emitters_.size()) throw std::out_of_range("ParticleSystem: no such emitter");
+    return emitters_[index];
+}
+
+void ParticleSystem::set_emitter(size_t index, const ParticleEmitter& emitter)
+{
+    if (index >= emitters_.size()) throw std::out_of_range("ParticleSystem: no such emitter");
+    emitters_[index] = emitter;
+}
+
+void ParticleSystem::clear_emitters()
+{
+    emitters_.clear();
+    spawn_carry_.clear();
+}
+
+void ParticleSystem::burst(size_t emitter, size_t count)
+{
+    spawn(get_emitter(emitter), count);
+}
+
+void ParticleSystem::spawn(const ParticleEmitter& e, size_t count)
+{
+    count = std::min(count, max_particles_ - std::min(max_particles_, x_.size()));
+    if (count == 0) return;
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        float px = e.x, py = e.y;
+        switch (e.shape) {
+            case EmitterShape::Point:
+                break;
+            case EmitterShape::Circle:
+            case EmitterShape::Ring: {
+                float r = e.shape == EmitterShape::Circle ? e.radius * std::sqrt(unit(rng_)) : e.radius;
+                float a = unit(rng_) * kTwoPi;
+                px += r * std::cos(a);
+                py += r * std::sin(a);
+                break;
+            }
+            case EmitterShape::Rect:
+                px += unit(rng_) * e.width;
+                py += unit(rng_) * e.height;
+                break;
+            case EmitterShape::Line: {
+                float t = unit(rng_);
+                px += t * e.width;
+                py += t * e.height;
+                break;
+            }
+        }
+
+        float direction = e.angle;
+        if (e.radial && (px != e.x || py != e.y)) direction = std::atan2(py - e.y, px - e.x);
+        direction += (unit(rng_) - 0.5f) * e.spread;
+        float speed = lerp(e.speed_min, e.speed_max, unit(rng_));
+
+        x_.push_back(px);
+        y_.push_back(py);
+        vx_.push_back(std::cos(direction) * speed);
+        vy_.push_back(std::sin(direction) * speed);
+        age_.push_back(0.0f);
+        life_.push_back(std::max(1e-6f, lerp(e.lifetime_min, e.lifetime_max, unit(rng_))));
+    }
+}
+
+// ============ Simulation ============
+
+void ParticleSystem::update(float dt)
+{
+    ProfileScope scope("ParticleSystem::update");
+    if (dt > 0.0f) {
+        integrate(dt);
+        remove_expired();
+    }
+
+    for (size_t i = 0; i < emitters_.size(); ++i) {
+        const ParticleEmitter& e = emitters_[i];
+        if (!e.enabled || e.rate <= 0.0f || dt <= 0.0f) continue;
+        float due = spawn_carry_[i] + e.rate * dt;
+        size_t whole = static_cast<size_t>(due);
+        spawn_carry_[i] = due - static_cast<float>(whole);
+        spawn(e, whole);
+    }
+}
+
+void ParticleSystem::integrate(float dt)
+{
+    int n = static_cast<int>(x_.size());
+    float damp = std::exp(-drag_ * dt);
+    float gx = gravity_x_ * dt, gy = gravity_y_ * dt;
+    float* x = x_.data();
+    float* y = y_.data();
+    float* vx = vx_.data();
+    float* vy = vy_.data();
+    float* age = age_.data();
+
+    // One attribute per loop so each pass is a straight vectorizable stream
+    auto step = [=](int begin, int end) {
+        for (int i = begin; i < end; ++i) vx[i] = (vx[i] + gx) * damp;
+        for (int i = begin; i < end; ++i) vy[i] = (vy[i] + gy) * damp;
+        for (int i = begin; i < end; ++i) x[i] += vx[i] * dt;
+        for (int i = begin; i < end; ++i) y[i] += vy[i] * dt;
+        for (int i = begin; i < end; ++i) age[i] += dt;
+    };
+    if (n <= kIntegrateGrain) {
+        step(0, n);
+    } else {
+        ThreadPool::instance().parallel_for(0, n, kIntegrateGrain, step);
+    }
+}
+
+void ParticleSystem::remove_expired()
+{
+    // Stable compaction keeps spawn order, and so draw order
+    size_t n = x_.size(), kept = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (age_[i] >= life_[i]) continue;
+        if (kept != i) {
+            x_[kept] = x_[i];
+            y_[kept] = y_[i];
+            vx_[kept] = vx_[i];
+            vy_[kept] = vy_[i];
+            age_[kept] = age_[i];
+            life_[kept] = life_[i];
+        }
+        ++kept;
+    }
+    if (kept == n) return;
+    for (auto* v : {&x_, &y_, &vx_, &vy_, &age_, &life_}) v->resize(kept);
+}
+
+void ParticleSystem::clear()
+{
+    for (auto* v : {&x_, &y_, &vx_, &vy_, &age_, &life_}) v->clear();
+    std::fill(spawn_carry_.begin(), spawn_carry_.end(), 0.0f);
+}
+
+void ParticleSystem::set_max_particles(size_t max_particles)
+{
+    max_particles_ = max_particles;
+    if (x_.size() > max_particles_) {
+        for (auto* v : {&x_, &y_, &vx_, &vy_, &age_, &life_}) v->resize(max_particles_);
+    }
+}
+
+// ============ Appearance ============
+
+void ParticleSystem::set_color(const Color& start, const Color& end, EasingType easing)
+{
+    start_color_ = start;
+    end_color_ = end;
+    color_easing_ = easing;
+}
+
+void ParticleSystem::set_size(float start, float end, EasingType easing)
+{
+    start_size_ = start;
+    end_size_ = end;
+    size_easing_ = easing;
+}
+
+// ============ Rendering ============
+
+void ParticleSystem::render(Surface& target, int offset_x, int offset_y) const
+{
+    ProfileScope scope("ParticleSystem::render");
+    size_t n = x_.size();
+    if (n == 0) return;
+
+    // Color and radius as a function of age / lifetime, tabulated once per call
+    uint8_t colors[kCurveSteps][4];
+    int32_t radii[kCurveSteps];
+    for (int s = 0; s < kCurveSteps; ++s) {
+        float t = static_cast<float>(s) / (kCurveSteps - 1);
+        float c = Easing::apply(color_easing_, t);
+        colors[s][0] = static_cast<uint8_t>(std::clamp(lerp(start_color_.r, end_color_.r, c), 0.0f, 255.0f));
+        colors[s][1] = static_cast<uint8_t>(std::clamp(lerp(start_color_.g, end_color_.g, c), 0.0f, 255.0f));
+        colors[s][2] = static_cast<uint8_t>(std::clamp(lerp(start_color_.b, end_color_.b, c), 0.0f, 255.0f));
+        colors[s][3] = static_cast<uint8_t>(std::clamp(lerp(start_color_.a, end_color_.a, c), 0.0f, 255.0f));
+        radii[s] = static_cast<int32_t>(std::lround(std::max(0.0f, lerp(start_size_, end_size_,
+                                                                         Easing::apply(size_easing_, t)))));
+    }
+
+    ScratchScope scratch;
+    int32_t* xy = scratch.alloc<int32_t>(n * 2);
+    int32_t* r = scratch.alloc<int32_t>(n);
+    uint8_t* rgba = scratch.alloc<uint8_t>(n * 4);
+    for (size_t i = 0; i < n; ++i) {
+        int s = static_cast<int>(std::min(age_[i] / life_[i], 1.0f) * (kCurveSteps - 1));
+        xy[i * 2] = to_pixel(x_[i], offset_x);
+        xy[i * 2 + 1] = to_pixel(y_[i], offset_y);
+        r[i] = radii[s];
+        std::memcpy(rgba + i * 4, colors[s], 4);
+    }
+    BatchDraw::blend_circles(target, xy, Strided<int32_t>(r, 1), Strided<uint8_t>(rgba, 4), n);
+}
+
+void ParticleSystem::render(Layer& layer, int offset_x, int offset_y) const
+{
+    render(layer.get_surface(), offset_x, offset_y);
+}
+
+} // namespace nativeui
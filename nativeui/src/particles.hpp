@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "animation.hpp"
+#include "layer.hpp"
+#include "surface.hpp"
+
+namespace nativeui {
+
+enum class EmitterShape {
+    Point,   // At (x, y)
+    Circle,  // Inside a disc of `radius` around (x, y)
+    Ring,    // On a circle of `radius` around (x, y)
+    Rect,    // Inside (x, y, width, height)
+    Line     // On the segment (x, y) -> (x + width, y + height)
+};
+
+/**
+ * ParticleEmitter - Where, how often and how fast particles are spawned
+ *
+ * Angles are radians, clockwise on screen (0 points right, -pi/2 up). Ranges
+ * are sampled uniformly per particle.
+ */
+struct ParticleEmitter {
+    EmitterShape shape = EmitterShape::Point;
+    float x = 0.0f, y = 0.0f;
+    float width = 0.0f, height = 0.0f;  // Rect size / Line direction
+    float radius = 0.0f;                // Circle / Ring
+
+    float rate = 100.0f;                // Particles per second (0 = bursts only)
+    bool enabled = true;
+
+    float angle = -1.5707964f;          // Launch direction
+    float spread = 6.2831855f;          // Full cone width around `angle`
+    bool radial = false;                // Launch away from (x, y) instead of along `angle`
+    float speed_min = 50.0f, speed_max = 100.0f;
+    float lifetime_min = 1.0f, lifetime_max = 1.0f;
+};
+
+/**
+ * ParticleSystem - Simulates and draws particles stored structure-of-arrays
+ *
+ * update() spawns from the emitters, integrates gravity, drag and velocity in
+ * flat per-attribute loops (split over the ThreadPool for large counts) and
+ * drops expired particles in place, keeping spawn order. Color and size are
+ * interpolated over each particle's lifetime through the Easing curves and
+ * render() draws all particles in one BatchDraw::blend_circles call.
+ */
+class ParticleSystem {
+public:
+    explicit ParticleSystem(size_t max_particles = 10000);
+
+    // Emitters
+    size_t add_emitter(const ParticleEmitter& emitter);
+    // Emitters are values: edit a copy and write it back with set_emitter()
+    const ParticleEmitter& get_emitter(size_t index) const;
+    void set_emitter(size_t index, const ParticleEmitter& emitter);
+    size_t get_emitter_count() const { return emitters_.size(); }
+    void clear_emitters();
+    void burst(size_t emitter, size_t count);  // Spawn `count` at once
+
+    // Simulation
+    void update(float dt);
+    void clear();
+    void seed(uint32_t value) { rng_.seed(value); }
+
+    size_t get_count() const { return x_.size(); }
+    size_t get_max_particles() const { return max_particles_; }
+    void set_max_particles(size_t max_particles);
+
+    void set_gravity(float gx, float gy) { gravity_x_ = gx; gravity_y_ = gy; }
+    float get_gravity_x() const { return gravity_x_; }
+    float get_gravity_y() const { return gravity_y_; }
+    void set_drag(float drag) { drag_ = drag; }  // Velocity decay rate: v *= exp(-drag * dt)
+    float get_drag() const { return drag_; }
+
+    // Appearance over lifetime (start at spawn, end at expiry)
+    void set_color(const Color& start, const Color& end, EasingType easing = EasingType::Linear);
+    void set_size(float start, float end, EasingType easing = EasingType::Linear);  // Radius in pixels
+    Color get_start_color() const { return start_color_; }
+    Color get_end_color() const { return end_color_; }
+    float get_start_size() const { return start_size_; }
+    float get_end_size() const { return end_size_; }
+
+    // Drawing, offset by (offset_x, offset_y)
+    void render(Surface& target, int offset_x = 0, int offset_y = 0) const;
+    void render(Layer& layer, int offset_x = 0, int offset_y = 0) const;
+
+    // Particle state (read-only views, get_count() entries each)
+    const float* get_x() const { return x_.data(); }
+    const float* get_y() const { return y_.data(); }
+    const float* get_age() const { return age_.data(); }
+    const float* get_lifetime() const { return life_.data(); }
+
+private:
+    static const int kCurveSteps = 256;  // Color and size are tabulated over lifetime
+
+    size_t max_particles_;
+    std::vector<float> x_, y_, vx_, vy_, age_, life_;
+    std::vector<ParticleEmitter> emitters_;
+    std::vector<float> spawn_carry_;       // Fractional particles owed per emitter
+    std::mt19937 rng_;
+
+    float gravity_x_ = 0.0f, gravity_y_ = 0.0f;
+    float drag_ = 0.0f;
+    Color start_color_ = Color(255, 255, 255, 255), end_color_ = Color(255, 255, 255, 0);
+    EasingType color_easing_ = EasingType::Linear;
+    float start_size_ = 3.0f, end_size_ = 1.0f;
+    EasingType size_easing_ = EasingType::Linear;
+
+    void spawn(const ParticleEmitter& emitter, size_t count);
+    void integrate(float dt);
+    void remove_expired();
+};
+
+} // namespace nativeui
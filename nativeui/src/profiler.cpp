@@ -0,0 +1,231 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace nativeui {
+
+Profiler::Profiler()
+    : enabled_(false)
+    , epoch_(std::chrono::steady_clock::now())
+    , ring_(new Slot[RING_CAPACITY])
+    , write_index_(0)
+    , read_index_(0)
+    , dropped_(0)
+    , history_frames_(120)
+    , frame_count_(0)
+    , frame_start_ns_(0)
+{
+}
+
+uint32_t Profiler::current_thread_id()
+{
+    static std::atomic<uint32_t> next_id{1};
+    thread_local uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Profiler::record(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    uint64_t index = write_index_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = ring_[index & (RING_CAPACITY - 1)];
+
+    // Mark the slot as being written so a concurrent drain skips it
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.sample.name = name;
+    slot.sample.start_ns = start_ns;
+    slot.sample.end_ns = end_ns;
+    slot.sample.thread_id = current_thread_id();
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::end_frame()
+{
+    uint64_t now = now_ns();
+    std::lock_guard<std::mutex> lock(history_mutex_);
+
+    if (!is_enabled()) {
+        frame_start_ns_ = now;
+        return;
+    }
+
+    // Drain completed samples from the ring
+    Frame frame;
+    frame.start_ns = frame_start_ns_;
+    frame.end_ns = now;
+
+    uint64_t head = write_index_.load(std::memory_order_acquire);
+    if (head - read_index_ > RING_CAPACITY) {
+        // Writers lapped us; the oldest entries are gone
+        dropped_ += head - read_index_ - RING_CAPACITY;
+        read_index_ = head - RING_CAPACITY;
+    }
+
+    while (read_index_ < head) {
+        Slot& slot = ring_[read_index_ & (RING_CAPACITY - 1)];
+        uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+
+        if (seq == 0 || seq < read_index_ + 1) {
+            // Still being written; pick it up next frame
+            break;
+        }
+
+        Sample sample = slot.sample;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (seq != read_index_ + 1 || slot.sequence.load(std::memory_order_relaxed) != seq) {
+            // Overwritten while we were reading
+            ++dropped_;
+        } else {
+            frame.samples.push_back(sample);
+        }
+        ++read_index_;
+    }
+
+    // Summarize per stage (keyed by text: identical literals may not share an address)
+    std::unordered_map<std::string_view, size_t> index_of;
+    for (const Sample& s : frame.samples) {
+        auto it = index_of.find(s.name);
+        if (it == index_of.end()) {
+            it = index_of.emplace(s.name, frame.summary.stages.size()).first;
+            StageSummary stage;
+            stage.name = s.name;
+            frame.summary.stages.push_back(stage);
+        }
+        StageSummary& stage = frame.summary.stages[it->second];
+        double ms = (s.end_ns - s.start_ns) / 1.0e6;
+        stage.calls++;
+        stage.total_ms += ms;
+        stage.max_ms = std::max(stage.max_ms, ms);
+    }
+
+    std::sort(frame.summary.stages.begin(), frame.summary.stages.end(),
+              [](const StageSummary& a, const StageSummary& b) { return a.total_ms > b.total_ms; });
+
+    frame.summary.frame_id = frame_count_++;
+    frame.summary.frame_ms = frame_start_ns_ > 0 ? (now - frame_start_ns_) / 1.0e6 : 0.0;
+    frame_start_ns_ = now;
+
+    history_.push_back(std::move(frame));
+    while (static_cast<int>(history_.size()) > history_frames_) {
+        history_.pop_front();
+    }
+}
+
+FrameSummary Profiler::get_last_frame() const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    if (history_.empty()) return FrameSummary();
+    return history_.back().summary;
+}
+
+FrameSummary Profiler::get_average(int frames) const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    FrameSummary result;
+    if (history_.empty() || frames <= 0) return result;
+
+    int count = std::min(frames, static_cast<int>(history_.size()));
+    std::unordered_map<std::string, size_t> index_of;
+
+    for (auto it = history_.end() - count; it != history_.end(); ++it) {
+        result.frame_ms += it->summary.frame_ms;
+        for (const StageSummary& stage : it->summary.stages) {
+            auto found = index_of.find(stage.name);
+            if (found == index_of.end()) {
+                found = index_of.emplace(stage.name, result.stages.size()).first;
+                StageSummary entry;
+                entry.name = stage.name;
+                result.stages.push_back(entry);
+            }
+            StageSummary& acc = result.stages[found->second];
+            acc.calls += stage.calls;
+            acc.total_ms += stage.total_ms;
+            acc.max_ms = std::max(acc.max_ms, stage.max_ms);
+        }
+    }
+
+    // Report per-frame averages; calls stay as totals so avg_ms() is per call
+    result.frame_id = history_.back().summary.frame_id;
+    result.frame_ms /= count;
+    for (StageSummary& stage : result.stages) {
+        stage.total_ms /= count;
+        stage.calls = static_cast<uint32_t>((stage.calls + count - 1) / count);
+    }
+
+    std::sort(result.stages.begin(), result.stages.end(),
+              [](const StageSummary& a, const StageSummary& b) { return a.total_ms > b.total_ms; });
+    return result;
+}
+
+uint64_t Profiler::get_frame_count() const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return frame_count_;
+}
+
+uint64_t Profiler::get_dropped_samples() const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return dropped_;
+}
+
+void Profiler::set_history_frames(int frames)
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    history_frames_ = std::max(1, frames);
+    while (static_cast<int>(history_.size()) > history_frames_) {
+        history_.pop_front();
+    }
+}
+
+void Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    history_.clear();
+    read_index_ = write_index_.load(std::memory_order_acquire);
+    dropped_ = 0;
+    frame_count_ = 0;
+    frame_start_ns_ = now_ns();
+}
+
+bool Profiler::export_chrome_trace(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(history_mutex_);
+
+    // Chrome trace "complete" events; timestamps are microseconds
+    char buf[256];
+    bool first = true;
+    out << "{\"traceEvents\":[\n";
+
+    auto emit = [&](const char* name, const char* cat, uint64_t start_ns, uint64_t end_ns, uint32_t tid) {
+        std::snprintf(buf, sizeof(buf),
+            "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            first ? "" : ",\n", name, cat, start_ns / 1000.0, (end_ns - start_ns) / 1000.0, tid);
+        out << buf;
+        first = false;
+    };
+
+    for (const Frame& frame : history_) {
+        std::string frame_name = "frame " + std::to_string(frame.summary.frame_id);
+        if (frame.start_ns > 0) {
+            emit(frame_name.c_str(), "frame", frame.start_ns, frame.end_ns, 0);
+        }
+        for (const Sample& s : frame.samples) {
+            emit(s.name, "palladium", s.start_ns, s.end_ns, s.thread_id);
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace nativeui
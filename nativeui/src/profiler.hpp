@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * Per-stage timing for one frame (or averaged over several frames)
+ */
+struct StageSummary {
+    std::string name;
+    uint32_t calls = 0;
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+
+    double avg_ms() const { return calls > 0 ? total_ms / calls : 0.0; }
+};
+
+/**
+ * FrameSummary - All stages recorded between two end_frame() calls
+ */
+struct FrameSummary {
+    uint64_t frame_id = 0;
+    double frame_ms = 0.0;
+    std::vector<StageSummary> stages;  // Sorted by total time, descending
+};
+
+/**
+ * Profiler - Low-overhead scoped timers for the rendering hot paths (singleton)
+ *
+ * Scopes push completed samples into a fixed-size lock-free ring buffer.
+ * Window::present() calls end_frame(), which drains the ring into a per-frame
+ * summary and keeps a bounded event history for Chrome trace export.
+ * When disabled, a scope costs a single relaxed atomic load.
+ */
+class Profiler {
+public:
+    static Profiler& instance() {
+        static Profiler inst;
+        return inst;
+    }
+
+    // Enable / disable collection
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+    bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Record a completed sample (called by ProfileScope, safe from any thread)
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    // Close the current frame: drain the ring and summarize
+    void end_frame();
+
+    // Frame summaries
+    FrameSummary get_last_frame() const;
+    FrameSummary get_average(int frames = 60) const;
+    uint64_t get_frame_count() const;
+    uint64_t get_dropped_samples() const;
+
+    // Write recorded history as Chrome trace JSON (chrome://tracing, Perfetto)
+    bool export_chrome_trace(const std::string& path) const;
+
+    // History size used for trace export and averages
+    void set_history_frames(int frames);
+    int get_history_frames() const { return history_frames_; }
+
+    // Drop all recorded data
+    void reset();
+
+    // Monotonic timestamp in nanoseconds since profiler creation
+    uint64_t now_ns() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch_).count());
+    }
+
+private:
+    Profiler();
+
+    struct Sample {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t end_ns;
+        uint32_t thread_id;
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};  // index + 1 once the slot is fully written
+        Sample sample;
+    };
+
+    struct Frame {
+        FrameSummary summary;
+        uint64_t start_ns;
+        uint64_t end_ns;
+        std::vector<Sample> samples;
+    };
+
+    static constexpr size_t RING_CAPACITY = 1 << 14;  // Must be a power of two
+
+    std::atomic<bool> enabled_;
+    std::chrono::steady_clock::time_point epoch_;
+
+    // Lock-free multi-producer ring
+    std::unique_ptr<Slot[]> ring_;
+    std::atomic<uint64_t> write_index_;
+    uint64_t read_index_;
+    uint64_t dropped_;
+
+    // Frame history (guarded, touched only at end_frame and by readers)
+    mutable std::mutex history_mutex_;
+    std::deque<Frame> history_;
+    int history_frames_;
+    uint64_t frame_count_;
+    uint64_t frame_start_ns_;
+
+    static uint32_t current_thread_id();
+};
+
+/**
+ * ProfileScope - RAII timer; records its lifetime under a static name
+ *
+ * Usage: ProfileScope scope("composite");
+ * The name must outlive the profiler (string literals only).
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name_(name)
+        , start_ns_(0)
+        , active_(Profiler::instance().is_enabled())
+    {
+        if (active_) start_ns_ = Profiler::instance().now_ns();
+    }
+
+    ~ProfileScope() {
+        if (active_) {
+            Profiler& p = Profiler::instance();
+            p.record(name_, start_ns_, p.now_ns());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_ns_;
+    bool active_;
+};
+
+} // namespace nativeui
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "tile_bins.hpp"
+
+namespace nativeui {
+
+/**
+ * GuillotinePacker - Free-rectangle bookkeeping for one atlas page
+ *
+ * insert() takes the free rectangle with the best short-side fit and splits the
+ * leftover along the shorter axis; release() returns a rectangle and merges
+ * free rectangles that share a whole edge. Not thread-safe.
+ */
+class GuillotinePacker {
+public:
+    GuillotinePacker(int width, int height) : width_(width), height_(height) { reset(); }
+
+    bool insert(int width, int height, PixelRect& out) {
+        size_t best = free_.size();
+        int best_fit = std::numeric_limits<int>::max();
+        for (size_t i = 0; i < free_.size(); ++i) {
+            const PixelRect& f = free_[i];
+            if (f.width() < width || f.height() < height) continue;
+            int fit = std::min(f.width() - width, f.height() - height);
+            if (fit < best_fit) {
+                best_fit = fit;
+                best = i;
+            }
+        }
+        if (best == free_.size()) return false;
+
+        PixelRect f = free_[best];
+        free_.erase(free_.begin() + best);
+        PixelRect right, below;
+        if (f.width() - width < f.height() - height) {
+            right = PixelRect{f.x0 + width, f.y0, f.x1, f.y0 + height};
+            below = PixelRect{f.x0, f.y0 + height, f.x1, f.y1};
+        } else {
+            right = PixelRect{f.x0 + width, f.y0, f.x1, f.y1};
+            below = PixelRect{f.x0, f.y0 + height, f.x0 + width, f.y1};
+        }
+        if (!right.empty()) free_.push_back(right);
+        if (!below.empty()) free_.push_back(below);
+        out = PixelRect{f.x0, f.y0, f.x0 + width, f.y0 + height};
+        used_++;
+        return true;
+    }
+
+    void release(const PixelRect& rect) {
+        if (--used_ == 0) {
+            // Nothing left: start over with the whole page
+            reset();
+            return;
+        }
+        free_.push_back(rect);
+        // Merge rectangles sharing a whole edge until none do
+        for (bool merged = true; merged;) {
+            merged = false;
+            for (size_t i = 0; i < free_.size() && !merged; ++i) {
+                for (size_t j = i + 1; j < free_.size() && !merged; ++j) {
+                    PixelRect& a = free_[i];
+                    const PixelRect& b = free_[j];
+                    bool rows = a.y0 == b.y0 && a.y1 == b.y1 && (a.x1 == b.x0 || b.x1 == a.x0);
+                    bool cols = a.x0 == b.x0 && a.x1 == b.x1 && (a.y1 == b.y0 || b.y1 == a.y0);
+                    if (!rows && !cols) continue;
+                    a = PixelRect{std::min(a.x0, b.x0), std::min(a.y0, b.y0),
+                                  std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+                    free_.erase(free_.begin() + j);
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    void reset() {
+        free_.assign(1, PixelRect{0, 0, width_, height_});
+        used_ = 0;
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t used() const { return used_; }             // Live rectangles
+    size_t free_count() const { return free_.size(); }
+
+private:
+    int width_, height_;
+    std::vector<PixelRect> free_;
+    size_t used_ = 0;
+};
+
+} // namespace nativeui
@@ -0,0 +1,79 @@
+#include "scratch_arena.hpp"
+#include <algorithm>
+
+namespace nativeui {
+
+static const size_t DEFAULT_BLOCK_BYTES = 1024 * 1024;
+
+std::atomic<uint64_t> ScratchArena::generation_{0};
+
+ScratchArena::ScratchArena()
+    : current_(0)
+    , offset_(0)
+    , used_before_current_(0)
+    , high_water_(0)
+    , generation_seen_(generation_.load(std::memory_order_relaxed))
+    , open_scopes_(0)
+{
+}
+
+ScratchArena& ScratchArena::local()
+{
+    thread_local ScratchArena arena;
+
+    uint64_t generation = generation_.load(std::memory_order_relaxed);
+    if (arena.generation_seen_ != generation && arena.open_scopes_ == 0) {
+        arena.reset();
+        arena.generation_seen_ = generation;
+    }
+    return arena;
+}
+
+uint8_t* ScratchArena::allocate(size_t bytes, size_t align)
+{
+    if (blocks_.empty()) {
+        blocks_.push_back(Block{std::make_unique<uint8_t[]>(std::max(DEFAULT_BLOCK_BYTES, bytes + align)),
+                                std::max(DEFAULT_BLOCK_BYTES, bytes + align)});
+    }
+
+    for (;;) {
+        Block& block = blocks_[current_];
+        size_t aligned = (offset_ + align - 1) & ~(align - 1);
+        if (aligned + bytes <= block.size) {
+            offset_ = aligned + bytes;
+            high_water_ = std::max(high_water_, used_before_current_ + offset_);
+            return block.data.get() + aligned;
+        }
+
+        // Current block is full: continue in the next, growing geometrically
+        used_before_current_ += block.size;
+        current_++;
+        offset_ = 0;
+        if (current_ == blocks_.size()) {
+            size_t size = std::max(block.size * 2, bytes + align);
+            blocks_.push_back(Block{std::make_unique<uint8_t[]>(size), size});
+        }
+    }
+}
+
+void ScratchArena::reset()
+{
+    if (blocks_.size() > 1) {
+        // One block big enough for the peak, so the next frame never grows
+        size_t size = std::max(get_capacity(), high_water_);
+        blocks_.clear();
+        blocks_.push_back(Block{std::make_unique<uint8_t[]>(size), size});
+    }
+    current_ = 0;
+    offset_ = 0;
+    used_before_current_ = 0;
+}
+
+size_t ScratchArena::get_capacity() const
+{
+    size_t total = 0;
+    for (const Block& block : blocks_) total += block.size;
+    return total;
+}
+
+} // namespace nativeui
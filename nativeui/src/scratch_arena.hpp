@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * ScratchArena - Per-thread bump allocator for transient buffers
+ *
+ * Effects take their temporaries (blur rows, distortion sources) from here
+ * instead of the heap. Allocations are released in stack order by
+ * ScratchScope, and the whole arena is rewound on the first use after each
+ * present (next_frame). Blocks are coalesced on rewind, so once the arena
+ * has grown to a frame's peak it stops allocating.
+ */
+class ScratchArena {
+public:
+    // Arena of the calling thread (rewound here if a frame ended and no scope is open)
+    static ScratchArena& local();
+
+    // Mark a frame boundary; every thread's arena rewinds on its next use
+    static void next_frame() { generation_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Uninitialized storage valid until the enclosing ScratchScope ends
+    uint8_t* allocate(size_t bytes, size_t align = 16);
+
+    template <typename T>
+    T* allocate_array(size_t count) {
+        return reinterpret_cast<T*>(allocate(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16));
+    }
+
+    struct Marker {
+        size_t block;
+        size_t offset;
+        size_t used_before;
+    };
+
+    Marker mark() const { return Marker{current_, offset_, used_before_current_}; }
+    void rewind(const Marker& marker) {
+        current_ = marker.block;
+        offset_ = marker.offset;
+        used_before_current_ = marker.used_before;
+    }
+
+    // Release everything and merge blocks into one
+    void reset();
+
+    size_t get_capacity() const;
+    size_t get_high_water() const { return high_water_; }
+
+private:
+    ScratchArena();
+
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_;
+    size_t offset_;
+    size_t used_before_current_;  // Bytes in blocks before current_ (for high-water)
+    size_t high_water_;
+    uint64_t generation_seen_;
+    int open_scopes_;  // Never rewind under a live ScratchScope
+
+    static std::atomic<uint64_t> generation_;
+
+    friend class ScratchScope;
+};
+
+/**
+ * ScratchScope - Releases scratch allocations made inside it
+ *
+ * Usage: ScratchScope scratch; uint8_t* tmp = scratch.alloc<uint8_t>(n);
+ */
+class ScratchScope {
+public:
+    ScratchScope()
+        : arena_(ScratchArena::local())
+        , marker_(arena_.mark())
+    {
+        arena_.open_scopes_++;
+    }
+
+    ~ScratchScope() {
+        arena_.rewind(marker_);
+        arena_.open_scopes_--;
+    }
+
+    template <typename T>
+    T* alloc(size_t count) { return arena_.allocate_array<T>(count); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+    ScratchArena& arena_;
+    ScratchArena::Marker marker_;
+};
+
+} // namespace nativeui
@@ -0,0 +1,330 @@
+#include "sdf_text.hpp"
+#include "memory_tracker.hpp"
+#include "profiler.hpp"
+#include "scratch_arena.hpp"
+#include "surface_raster.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nativeui {
+
+namespace {
+
+const float kInf = 1e20f;
+const float kDegToRad = 0.017453292f;
+
+// Felzenszwalb's squared distance transform of n samples of f (stride apart), in place
+void edt_1d(float* f, int n, int stride, float* d, int* v, float* z)
+{
+    for (int q = 0; q < n; ++q) d[q] = f[q * stride];
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kInf;
+    z[1] = kInf;
+    for (int q = 1; q < n; ++q) {
+        float s;
+        for (;;) {
+            int r = v[k];
+            s = ((d[q] + q * q) - (d[r] + r * r)) / (2.0f * (q - r));
+            if (s > z[k] || k == 0) break;
+            --k;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kInf;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q) ++k;
+        int r = v[k];
+        f[q * stride] = (q - r) * (q - r) + d[r];
+    }
+}
+
+void edt(std::vector<float>& grid, int width, int height)
+{
+    int n = std::max(width, height);
+    std::vector<float> d(n), z(n + 1);
+    std::vector<int> v(n);
+    for (int x = 0; x < width; ++x) edt_1d(&grid[x], height, width, d.data(), v.data(), z.data());
+    for (int y = 0; y < height; ++y) edt_1d(&grid[static_cast<size_t>(y) * width], width, 1, d.data(), v.data(), z.data());
+}
+
+// Field byte <-> distance inside the edge, in base pixels (negative outside)
+inline uint8_t encode(float inside)
+{
+    return static_cast<uint8_t>(std::clamp(std::lround(128.0f + inside * 127.0f / SdfFont::kSpread), 0L, 255L));
+}
+
+inline float decode(float value)
+{
+    return (value - 128.0f) * SdfFont::kSpread / 127.0f;
+}
+
+// Leaked on purpose: the memory evictor below can run during static destruction
+std::mutex& registry_mutex()
+{
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+}
+
+std::unordered_map<std::string, std::shared_ptr<SdfFont>>& registry()
+{
+    static auto* fonts = new std::unordered_map<std::string, std::shared_ptr<SdfFont>>();
+    return *fonts;
+}
+
+// Distance fields are the cached input of every outline, glow and SDF
+// shadow; memory pressure drops the fonts no text holds
+void register_sdf_evictor()
+{
+    static std::once_flag registered;
+    std::call_once(registered, []() {
+        MemoryTracker::instance().add_evictor([](MemoryPressure) { SdfFont::trim(); });
+    });
+}
+
+} // namespace
+
+std::shared_ptr<SdfFont> SdfFont::get(const std::string& font)
+{
+    register_sdf_evictor();
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    auto it = registry().find(font);
+    if (it != registry().end()) return it->second;
+    auto base = FontCache::get(font, kBaseSize);
+    if (!base) return nullptr;
+    auto sdf = std::make_shared<SdfFont>(std::move(base));
+    registry().emplace(font, sdf);
+    return sdf;
+}
+
+void SdfFont::clear()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().clear();
+}
+
+size_t SdfFont::trim()
+{
+    // Victims are destroyed after the lock is dropped
+    std::vector<std::shared_ptr<SdfFont>> victims;
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (auto it = registry().begin(); it != registry().end();) {
+        if (it->second.use_count() == 1) {
+            victims.push_back(std::move(it->second));
+            it = registry().erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return victims.size();
+}
+
+SdfFont::SdfFont(std::shared_ptr<Font> base) : base_(std::move(base)) {}
+
+SdfFont::~SdfFont()
+{
+    for (const auto& entry : glyphs_) GlyphAtlas::instance().release(entry.second.slot);
+}
+
+const SdfFont::Glyph& SdfFont::glyph(uint32_t cp)
+{
+    auto it = glyphs_.find(cp);
+    if (it != glyphs_.end()) return it->second;
+
+    Font::GlyphInfo info = base_->get_glyph(cp);
+    Glyph g;
+    g.advance = info.advance;
+    if (info.coverage) {
+        int w = info.width + 2 * kSpread, h = info.height + 2 * kSpread;
+        size_t count = static_cast<size_t>(w) * h;
+
+        // Squared distances to the nearest outside / inside sample; partial
+        // coverage seeds the subpixel distance to the edge
+        std::vector<float> outer(count, kInf), inner(count, 0.0f);
+        for (int y = 0; y < info.height; ++y) {
+            const uint8_t* row = info.coverage + static_cast<size_t>(y) * info.pitch;
+            for (int x = 0; x < info.width; ++x) {
+                size_t i = static_cast<size_t>(y + kSpread) * w + (x + kSpread);
+                if (row[x] == 255) {
+                    outer[i] = 0.0f;
+                    inner[i] = kInf;
+                } else if (row[x] > 0) {
+                    float d = 0.5f - row[x] / 255.0f;
+                    outer[i] = d > 0.0f ? d * d : 0.0f;
+                    inner[i] = d < 0.0f ? d * d : 0.0f;
+                }
+            }
+        }
+        edt(outer, w, h);
+        edt(inner, w, h);
+
+        std::vector<uint8_t> field(count);
+        for (size_t i = 0; i < count; ++i) field[i] = encode(std::sqrt(inner[i]) - std::sqrt(outer[i]));
+        g.slot = GlyphAtlas::instance().insert(field.data(), w, w, h);
+        g.left = info.left - kSpread;
+        g.top = info.top - kSpread;
+    }
+    return glyphs_.emplace(cp, g).first->second;
+}
+
+std::vector<SdfFont::Placed> SdfFont::place(const std::string& text, int wrap_width, int& width, int& height)
+{
+    std::vector<std::pair<size_t, size_t>> lines;
+    if (wrap_width > 0) {
+        lines = base_->break_lines(text, wrap_width);
+    } else {
+        lines.emplace_back(0, text.size());
+    }
+
+    std::vector<Placed> placed;
+    int line_skip = base_->get_line_skip();
+    width = 0;
+    height = base_->get_height() + static_cast<int>(std::max<size_t>(lines.size(), 1) - 1) * line_skip;
+    for (size_t l = 0; l < lines.size(); ++l) {
+        size_t first = placed.size();
+        int pen = 0, left = 0, right = 0;
+        uint32_t previous = 0;
+        float y = static_cast<float>(l) * line_skip;
+        for (size_t i = lines[l].first; i < lines[l].second;) {
+            uint32_t cp = Font::decode_utf8(text, i);
+            if (previous) pen += base_->get_kerning(previous, cp);
+            const Glyph& g = glyph(cp);
+            right = std::max(right, pen + g.advance);
+            if (g.slot.pixels) {
+                placed.push_back(Placed{&g, static_cast<float>(pen + g.left), y + g.top});
+                left = std::min(left, pen + g.left + kSpread);
+                right = std::max(right, pen + g.left + g.slot.rect.width() - kSpread);
+            }
+            pen += g.advance;
+            previous = cp;
+        }
+        // Ink left of the first pen position shifts the line right, as in Font::layout
+        for (size_t k = first; k < placed.size(); ++k) placed[k].x -= left;
+        width = std::max(width, right - left);
+    }
+    return placed;
+}
+
+void SdfFont::measure(const std::string& text, float size, float& width, float& height, float wrap_width)
+{
+    float scale = size / kBaseSize;
+    int w = 0, h = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        place(text, wrap_width > 0.0f ? static_cast<int>(wrap_width / scale) : 0, w, h);
+    }
+    width = w * scale;
+    height = h * scale;
+}
+
+void SdfFont::draw(Surface& target, const std::string& text, float x, float y, float size, const Color& color,
+                   float rotation, const SdfTextStyle& style, float wrap_width)
+{
+    if (text.empty() || size <= 0.0f) return;
+    ProfileScope scope("SdfFont::draw");
+
+    float scale = size / kBaseSize;
+    std::vector<Placed> placed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int w = 0, h = 0;
+        placed = place(text, wrap_width > 0.0f ? static_cast<int>(wrap_width / scale) : 0, w, h);
+    }
+    if (placed.empty()) return;
+
+    // Base pixels (u, v) map to x + scale * R(u, v); pixels map back through the inverse
+    float c = std::cos(rotation * kDegToRad), s = std::sin(rotation * kDegToRad);
+    auto to_target = [&](float u, float v, float& tx, float& ty) {
+        tx = x + scale * (c * u - s * v);
+        ty = y + scale * (s * u + c * v);
+    };
+    PixelRect area{0, 0, target.get_width(), target.get_height()};
+    auto quad_bounds = [&](const Placed& p) {
+        float u1 = p.x + p.glyph->slot.rect.width(), v1 = p.y + p.glyph->slot.rect.height();
+        float xs[4], ys[4];
+        to_target(p.x, p.y, xs[0], ys[0]);
+        to_target(u1, p.y, xs[1], ys[1]);
+        to_target(p.x, v1, xs[2], ys[2]);
+        to_target(u1, v1, xs[3], ys[3]);
+        PixelRect r{static_cast<int>(std::floor(*std::min_element(xs, xs + 4))),
+                    static_cast<int>(std::floor(*std::min_element(ys, ys + 4))),
+                    static_cast<int>(std::ceil(*std::max_element(xs, xs + 4))),
+                    static_cast<int>(std::ceil(*std::max_element(ys, ys + 4)))};
+        return r.intersect(area);
+    };
+
+    PixelRect bounds{0, 0, 0, 0};
+    for (const Placed& p : placed) {
+        PixelRect r = quad_bounds(p);
+        if (r.empty()) continue;
+        bounds = bounds.empty() ? r : PixelRect{std::min(bounds.x0, r.x0), std::min(bounds.y0, r.y0),
+                                                std::max(bounds.x1, r.x1), std::max(bounds.y1, r.y1)};
+    }
+    if (bounds.empty()) return;
+
+    // Union of the glyph shapes: the largest inside distance under each pixel
+    int bw = bounds.width(), bh = bounds.height();
+    ScratchScope scratch;
+    float* dist = scratch.alloc<float>(static_cast<size_t>(bw) * bh);
+    std::fill(dist, dist + static_cast<size_t>(bw) * bh, -static_cast<float>(kSpread));
+    float du_dx = c / scale, dv_dx = -s / scale;
+    for (const Placed& p : placed) {
+        PixelRect r = quad_bounds(p);
+        if (r.empty()) continue;
+        const GlyphSlot& slot = p.glyph->slot;
+        float fw = static_cast<float>(slot.rect.width() - 1), fh = static_cast<float>(slot.rect.height() - 1);
+        for (int ty = r.y0; ty < r.y1; ++ty) {
+            float dx = r.x0 + 0.5f - x, dy = ty + 0.5f - y;
+            // Field sample coordinates (sample centers at integers)
+            float fx = (c * dx + s * dy) / scale - p.x - 0.5f;
+            float fy = (-s * dx + c * dy) / scale - p.y - 0.5f;
+            float* out = dist + static_cast<size_t>(ty - bounds.y0) * bw + (r.x0 - bounds.x0);
+            for (int tx = r.x0; tx < r.x1; ++tx, ++out, fx += du_dx, fy += dv_dx) {
+                if (fx < 0.0f || fy < 0.0f || fx > fw || fy > fh) continue;
+                int ix = std::min(static_cast<int>(fx), slot.rect.width() - 2);
+                int iy = std::min(static_cast<int>(fy), slot.rect.height() - 2);
+                ix = std::max(ix, 0);
+                iy = std::max(iy, 0);
+                float ax = fx - ix, ay = fy - iy;
+                const uint8_t* f = slot.pixels + static_cast<size_t>(iy) * slot.pitch + ix;
+                float top = f[0] + (f[1] - f[0]) * ax;
+                float bottom = f[slot.pitch] + (f[slot.pitch + 1] - f[slot.pitch]) * ax;
+                *out = std::max(*out, decode(top + (bottom - top) * ay));
+            }
+        }
+    }
+
+    // One distance per pixel becomes glow, outline and fill coverage (target pixels)
+    float reach = kSpread * scale - 0.5f;
+    float outline = style.outline_color.a ? std::clamp(style.outline_width, 0.0f, reach) : 0.0f;
+    float glow = style.glow_color.a ? std::clamp(style.glow_radius, 0.0f, reach - outline) : 0.0f;
+    for (int ty = bounds.y0; ty < bounds.y1; ++ty) {
+        const float* row = dist + static_cast<size_t>(ty - bounds.y0) * bw;
+        uint8_t* d = target.get_data() + ty * target.get_pitch() + static_cast<size_t>(bounds.x0) * 4;
+        for (int i = 0; i < bw; ++i, d += 4) {
+            float inside = row[i] * scale;
+            if (glow > 0.0f) {
+                float g = std::clamp(1.0f + (inside + outline) / glow, 0.0f, 1.0f);
+                if (g > 0.0f) {
+                    raster::blend_over(d, style.glow_color.r, style.glow_color.g, style.glow_color.b,
+                                       static_cast<uint8_t>(style.glow_color.a * g * g));
+                }
+            }
+            if (outline > 0.0f) {
+                float o = std::clamp(inside + outline + 0.5f, 0.0f, 1.0f);
+                if (o > 0.0f) {
+                    raster::blend_over(d, style.outline_color.r, style.outline_color.g, style.outline_color.b,
+                                       static_cast<uint8_t>(style.outline_color.a * o));
+                }
+            }
+            float f = std::clamp(inside + 0.5f, 0.0f, 1.0f);
+            if (f > 0.0f) raster::blend_over(d, color.r, color.g, color.b, static_cast<uint8_t>(color.a * f));
+        }
+    }
+}
+
+} // namespace nativeui
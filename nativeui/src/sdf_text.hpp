@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "font.hpp"
+#include "glyph_atlas.hpp"
+#include "surface.hpp"
+
+namespace nativeui {
+
+struct SdfTextStyle {
+    Color outline_color = Color(0, 0, 0, 0);
+    float outline_width = 0.0f;   // Pixels at the drawn size
+    Color glow_color = Color(0, 0, 0, 0);
+    float glow_radius = 0.0f;     // Pixels at the drawn size
+};
+
+/**
+ * SdfFont - Signed distance field glyphs of one font, drawable at any size and angle
+ *
+ * Each glyph's coverage at kBaseSize pixels is turned once into an 8-bit
+ * distance field (exact Euclidean distance transform, seeded from the
+ * anti-aliased coverage so edges keep subpixel position) stored in the shared
+ * GlyphAtlas. draw() maps every target pixel back into the fields, takes the
+ * largest distance of the glyphs under it and converts that one value to
+ * fill, outline and glow coverage. Changing the size or rotation never
+ * rasterizes again.
+ *
+ * Fields encode kSpread base pixels around each edge, so outlines and glows
+ * reach at most kSpread * size / kBaseSize pixels. Thread-safe.
+ */
+class SdfFont {
+public:
+    static constexpr int kBaseSize = 48;
+    static constexpr int kSpread = 6;
+
+    // Shared per font name; nullptr if the font can't be loaded
+    static std::shared_ptr<SdfFont> get(const std::string& font);
+    static void clear();
+    // Drop fonts nobody else holds (their fields leave the atlas); returns how many
+    static size_t trim();
+
+    explicit SdfFont(std::shared_ptr<Font> base);
+    ~SdfFont();
+    SdfFont(const SdfFont&) = delete;
+    SdfFont& operator=(const SdfFont&) = delete;
+
+    // Unrotated size of text drawn at `size` pixels (wrap_width <= 0: one line)
+    void measure(const std::string& text, float size, float& width, float& height, float wrap_width = 0.0f);
+
+    // Draw with the line box's top-left at (x, y), rotated `rotation` degrees
+    // clockwise about that point
+    void draw(Surface& target, const std::string& text, float x, float y, float size, const Color& color,
+              float rotation = 0.0f, const SdfTextStyle& style = SdfTextStyle(), float wrap_width = 0.0f);
+
+private:
+    struct Glyph {
+        GlyphSlot slot;         // Field pixels; none for blank glyphs
+        int left = 0, top = 0;  // Field offset from the pen position / line top
+        int advance = 0;
+    };
+    struct Placed {
+        const Glyph* glyph;
+        float x, y;             // Field top-left in base pixels
+    };
+
+    std::shared_ptr<Font> base_;
+    std::unordered_map<uint32_t, Glyph> glyphs_;
+    std::mutex mutex_;
+
+    const Glyph& glyph(uint32_t cp);  // mutex_ held
+    // Glyphs of text in base pixels; sets the text box
+    std::vector<Placed> place(const std::string& text, int wrap_width, int& width, int& height);  // mutex_ held
+};
+
+} // namespace nativeui
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <iomanip>
 #include "font.hpp"
+#include "text_cache.hpp"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
@@ -616,8 +617,8 @@ void Slider::draw(nativeui::Surface& surface) {
         // Minor Label Fade (Start at 2.0 -> 4.0)
         float minor_label_alpha = std::clamp((current_zoom_ - 2.0f) / 2.0f, 0.0f, 1.0f);
 
-        auto font_major = nativeui::FontCache::get("Roboto Bold", 14);
-        auto font_minor = nativeui::FontCache::get("Roboto Bold", 12);
+        // Tick labels repeat every frame: laid out once through the shared cache
+        auto& text_cache = nativeui::TextLayoutCache::instance();
 
         for (int i = v_start_idx; i <= v_end_idx; ++i) {
             float v = i / step_density;
@@ -669,17 +670,15 @@ void Slider::draw(nativeui::Surface& surface) {
                     ss_lbl << std::fixed << std::setprecision(0) << val_at_tick << "x";
                     
                     nativeui::Color lbl_col = tick_col;
-                    auto font = font_major;
+                    int lbl_size = 14;
                     if (is_minor && !is_major) {
                          lbl_col.a = (uint8_t)(lbl_col.a * minor_label_alpha);
-                         font = font_minor;
+                         lbl_size = 12;
                     }
                     
-                    if (font && lbl_col.a > 10) {
-                        auto lbl_surf = font->render(ss_lbl.str(), lbl_col);
-                        if (lbl_surf) {
-                             surface.blit_alpha(*lbl_surf, (int)px - lbl_surf->get_width()/2, (int)(tape_center_y + final_h/2.0f + 5));
-                        }
+                    if (lbl_col.a > 10) {
+                        auto lbl = text_cache.layout("Roboto Bold", lbl_size, ss_lbl.str());
+                        if (lbl) lbl->draw(surface, (int)px - lbl->width/2, (int)(tape_center_y + final_h/2.0f + 5), lbl_col);
                     }
                 }
              }
@@ -755,36 +754,16 @@ void Slider::draw(nativeui::Surface& surface) {
             std::string txt = ss.str();
             
             int font_size = 14;
-            auto font = nativeui::FontCache::get("Roboto Bold", font_size);
-            if (font) {
-                auto surf_u = font->render(txt, fill_color_); // Unfilled (Primary)
-                auto surf_f = font->render(txt, bg_color_);   // Filled (Secondary)
+            // One layout, drawn in two colors split at the fill edge
+            auto run = nativeui::TextLayoutCache::instance().layout("Roboto Bold", font_size, txt);
+            if (run && !run->glyphs.empty()) {
+                float tx = draw_x + draw_width / 2.0f - (run->width * 0.5f);
+                float ty = y_ + height_ / 2.0f - (run->height * 0.5f);
                 
-                if (surf_u && surf_f) {
-                    float tx = draw_x + draw_width / 2.0f - (surf_u->get_width() * 0.5f);
-                    float ty = y_ + height_ / 2.0f - (surf_u->get_height() * 0.5f);
-                    
-                    float fill_end_x = draw_x + fill_width;
-                    float text_x = tx;
-                    float text_w = (float)surf_u->get_width();
-                    float text_h = (float)surf_u->get_height();
-                    
-                    if (fill_end_x >= text_x + text_w) {
-                         surface.blit_alpha(*surf_f, (int)tx, (int)ty);
-                    } else if (fill_end_x <= text_x) {
-                         surface.blit_alpha(*surf_u, (int)tx, (int)ty);
-                    } else {
-                        int split = (int)(fill_end_x - text_x);
-                        if (split > 0) {
-                            auto left_sub = surf_f->subsurface(0, 0, split, (int)text_h);
-                            if (left_sub) surface.blit_alpha(*left_sub, (int)tx, (int)ty);
-                        }
-                        if (split < text_w) {
-                            auto right_sub = surf_u->subsurface(split, 0, (int)text_w - split, (int)text_h);
-                            if (right_sub) surface.blit_alpha(*right_sub, (int)tx + split, (int)ty);
-                        }
-                    }
-                }
+                int split = (int)tx + std::clamp((int)(draw_x + fill_width - tx), 0, run->width);
+                int sw = surface.get_width(), sh = surface.get_height();
+                run->draw(surface, (int)tx, (int)ty, bg_color_, nativeui::PixelRect{0, 0, split, sh});   // Filled (Secondary)
+                run->draw(surface, (int)tx, (int)ty, fill_color_, nativeui::PixelRect{split, 0, sw, sh}); // Unfilled (Primary)
             }
         }
     }
@@ -797,14 +776,11 @@ void Slider::draw(nativeui::Surface& surface) {
             std::string txt = ss.str();
             
             int font_size = 14;
-            auto font = nativeui::FontCache::get("Roboto Bold", font_size);
-            if (font) {
-                auto text_surf = font->render(txt, text_color_);
-                if (text_surf) {
-                    float tx = x_ - (text_surf->get_width() * 0.5f); 
-                    float ty = y_ - (text_surf->get_height() * 0.5f);
-                    surface.blit_alpha(*text_surf, (int)tx, (int)ty);
-                }
+            auto run = nativeui::TextLayoutCache::instance().layout("Roboto Bold", font_size, txt);
+            if (run) {
+                float tx = x_ - (run->width * 0.5f); 
+                float ty = y_ - (run->height * 0.5f);
+                run->draw(surface, (int)tx, (int)ty, text_color_);
             }
         }
     }
@@ -1,40 +1,186 @@
 #include "surface.hpp"
+#include "memory_tracker.hpp"
+#include "buffer_pool.hpp"
+#include "surface_raster.hpp"
 #include <cmath>
+#include <cstring>
 
 namespace nativeui {
 
 Surface::Surface(int width, int height)
-    : width_(width), height_(height), pixels_(width * height * 4, 0)
+    : width_(width), height_(height), data_(nullptr), pitch_(static_cast<size_t>(width) * 4)
+    , origin_(MemoryTracker::current_origin())
 {
     if (width <= 0 || height <= 0) {
         throw std::invalid_argument("Surface dimensions must be positive");
     }
+    
+    // Register before allocating so a hard budget can refuse the request
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    MemoryTracker::instance().on_allocate(origin_, bytes);
+    pixels_ = BufferPool::instance().acquire(bytes);
+    pixels_.assign(bytes, 0);
+    data_ = pixels_.data();
 }
 
 Surface::Surface(const Surface& other)
-    : width_(other.width_), height_(other.height_), pixels_(other.pixels_)
+    : width_(other.width_), height_(other.height_), data_(nullptr), pitch_(static_cast<size_t>(other.width_) * 4)
+    , origin_(MemoryTracker::current_origin())
 {
+    size_t bytes = other.get_size();
+    MemoryTracker::instance().on_allocate(origin_, bytes);
+    pixels_ = BufferPool::instance().acquire(bytes);
+    pixels_.resize(bytes);
+    data_ = pixels_.data();
+    other.read_pixels(data_);
 }
 
 Surface& Surface::operator=(const Surface& other)
 {
     if (this != &other) {
+        size_t bytes = other.get_size();
+        if (pixels_.size() != bytes) {
+            MemoryTracker::instance().on_allocate(origin_, bytes);
+            MemoryTracker::instance().on_release(origin_, pixels_.size());
+        }
+        if (pixels_.capacity() < bytes) {
+            BufferPool::instance().release(std::move(pixels_));
+            pixels_ = BufferPool::instance().acquire(bytes);
+        }
         width_ = other.width_;
         height_ = other.height_;
-        pixels_ = other.pixels_;
+        pitch_ = static_cast<size_t>(width_) * 4;
+        pixels_.resize(bytes);
+        data_ = pixels_.data();
+        other.read_pixels(data_);
+        external_.reset();
     }
     return *this;
 }
 
+Surface::Surface(Surface&& other) noexcept
+    : width_(other.width_), height_(other.height_)
+    , pixels_(std::move(other.pixels_)), data_(other.data_), pitch_(other.pitch_)
+    , external_(std::move(other.external_)), origin_(other.origin_)
+{
+    // The tracked bytes move with the buffer; the source is left empty (0x0)
+    other.width_ = 0;
+    other.height_ = 0;
+    other.pitch_ = 0;
+    other.pixels_.clear();
+    other.data_ = nullptr;
+}
+
+Surface& Surface::operator=(Surface&& other) noexcept
+{
+    if (this != &other) {
+        MemoryTracker::instance().on_release(origin_, pixels_.size());
+        BufferPool::instance().release(std::move(pixels_));
+        
+        width_ = other.width_;
+        height_ = other.height_;
+        pixels_ = std::move(other.pixels_);
+        data_ = other.data_;
+        pitch_ = other.pitch_;
+        external_ = std::move(other.external_);
+        origin_ = other.origin_;
+        
+        other.width_ = 0;
+        other.height_ = 0;
+        other.pitch_ = 0;
+        other.pixels_.clear();
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+Surface::~Surface()
+{
+    MemoryTracker::instance().on_release(origin_, pixels_.size());
+    BufferPool::instance().release(std::move(pixels_));
+}
+
+Surface::Surface(uint8_t* data, int width, int height, std::shared_ptr<void> owner, size_t pitch)
+    : width_(width), height_(height), data_(data), pitch_(pitch), external_(std::move(owner))
+    , origin_(MemoryTracker::current_origin())
+{
+    // External memory is owned by the caller and not tracked or pooled
+}
+
+std::shared_ptr<Surface> Surface::wrap(uint8_t* data, int width, int height, std::shared_ptr<void> owner,
+                                       size_t pitch)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Surface dimensions must be positive");
+    }
+    if (!data) {
+        throw std::invalid_argument("Surface::wrap needs a data pointer");
+    }
+    if (pitch == 0) {
+        pitch = static_cast<size_t>(width) * 4;
+    } else if (pitch < static_cast<size_t>(width) * 4 || pitch % 4 != 0) {
+        throw std::invalid_argument("Surface::wrap pitch must be a multiple of 4 and at least width * 4");
+    }
+    if (!owner) {
+        owner = std::shared_ptr<void>(data, [](void*) {});  // Caller guarantees the lifetime
+    }
+    return std::shared_ptr<Surface>(new Surface(data, width, height, std::move(owner), pitch));
+}
+
+std::mutex& Surface::pin_mutex()
+{
+    static std::mutex* mutex = new std::mutex();  // Leaked: exports can outlive statics
+    return *mutex;
+}
+
+uint8_t* Surface::pin()
+{
+    std::lock_guard<std::mutex> lock(pin_mutex());
+    ++pins_;
+    return data_;
+}
+
+void Surface::unpin()
+{
+    std::lock_guard<std::mutex> lock(pin_mutex());
+    --pins_;
+}
+
+bool Surface::is_pinned() const
+{
+    std::lock_guard<std::mutex> lock(pin_mutex());
+    return pins_ > 0;
+}
+
+void Surface::read_pixels(uint8_t* dst) const
+{
+    size_t row = static_cast<size_t>(width_) * 4;
+    if (is_contiguous()) {
+        std::memcpy(dst, data_, get_size());
+        return;
+    }
+    for (int y = 0; y < height_; ++y) std::memcpy(dst + y * row, data_ + y * pitch_, row);
+}
+
+void Surface::write_pixels(const uint8_t* src)
+{
+    size_t row = static_cast<size_t>(width_) * 4;
+    if (is_contiguous()) {
+        std::memcpy(data_, src, get_size());
+        return;
+    }
+    for (int y = 0; y < height_; ++y) std::memcpy(data_ + y * pitch_, src + y * row, row);
+}
+
 void Surface::set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
 {
     if (!in_bounds(x, y)) return;
     
     size_t offset = pixel_offset(x, y);
-    pixels_[offset] = r;
-    pixels_[offset + 1] = g;
-    pixels_[offset + 2] = b;
-    pixels_[offset + 3] = a;
+    data_[offset] = r;
+    data_[offset + 1] = g;
+    data_[offset + 2] = b;
+    data_[offset + 3] = a;
 }
 
 void Surface::set_pixel(int x, int y, const Color& color)
@@ -77,10 +223,10 @@ Color Surface::get_pixel(int x, int y) const
     
     size_t offset = pixel_offset(x, y);
     return Color(
-        pixels_[offset],
-        pixels_[offset + 1],
-        pixels_[offset + 2],
-        pixels_[offset + 3]
+        data_[offset],
+        data_[offset + 1],
+        data_[offset + 2],
+        data_[offset + 3]
     );
 }
 
@@ -109,7 +255,9 @@ void Surface::fill_rect(int x, int y, int w, int h, const Color& color)
 
 void Surface::clear()
 {
-    std::fill(pixels_.begin(), pixels_.end(), 0);
+    for (int y = 0; y < height_; ++y) {
+        std::fill(data_ + y * pitch_, data_ + y * pitch_ + static_cast<size_t>(width_) * 4, 0);
+    }
 }
 
 // ============ Drawing with auto-AA dispatch ============
@@ -145,28 +293,7 @@ void Surface::fill_circle(int cx, int cy, int radius, const Color& color)
 
 void Surface::draw_line_no_aa(int x1, int y1, int x2, int y2, const Color& color)
 {
-    // Bresenham's line algorithm
-    int dx = std::abs(x2 - x1);
-    int dy = std::abs(y2 - y1);
-    int sx = x1 < x2 ? 1 : -1;
-    int sy = y1 < y2 ? 1 : -1;
-    int err = dx - dy;
-    
-    while (true) {
-        set_pixel(x1, y1, color);
-        
-        if (x1 == x2 && y1 == y2) break;
-        
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x1 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y1 += sy;
-        }
-    }
+    raster::line(x1, y1, x2, y2, 0, 0, width_, height_, [&](int x, int y) { set_pixel(x, y, color); });
 }
 
 void Surface::draw_circle_no_aa(int cx, int cy, int radius, const Color& color)
@@ -199,93 +326,29 @@ void Surface::draw_circle_no_aa(int cx, int cy, int radius, const Color& color)
 
 void Surface::fill_circle_no_aa(int cx, int cy, int radius, const Color& color)
 {
-    for (int y = -radius; y <= radius; ++y) {
-        for (int x = -radius; x <= radius; ++x) {
-            if (x * x + y * y <= radius * radius) {
-                set_pixel(cx + x, cy + y, color);
-            }
-        }
-    }
+    raster::filled_circle(cx, cy, radius, 0, 0, width_, height_,
+                          [&](int x, int y) { set_pixel(x, y, color); });
 }
 
 // ============ Anti-aliased implementations ============
 
 void Surface::draw_line_aa(int x1, int y1, int x2, int y2, const Color& color)
 {
-    // Xiaolin Wu's line algorithm
-    auto fpart = [](float x) { return x - std::floor(x); };
-    auto rfpart = [&fpart](float x) { return 1.0f - fpart(x); };
-    
-    bool steep = std::abs(y2 - y1) > std::abs(x2 - x1);
-    
-    if (steep) {
-        std::swap(x1, y1);
-        std::swap(x2, y2);
-    }
-    if (x1 > x2) {
-        std::swap(x1, x2);
-        std::swap(y1, y2);
-    }
-    
-    float dx = static_cast<float>(x2 - x1);
-    float dy = static_cast<float>(y2 - y1);
-    float gradient = (dx == 0.0f) ? 1.0f : dy / dx;
-    
-    // Handle first endpoint
-    float xend = std::round(static_cast<float>(x1));
-    float yend = y1 + gradient * (xend - x1);
-    float xgap = rfpart(x1 + 0.5f);
-    int xpxl1 = static_cast<int>(xend);
-    int ypxl1 = static_cast<int>(std::floor(yend));
-    
-    if (steep) {
-        plot_aa_pixel(ypxl1, xpxl1, color, rfpart(yend) * xgap);
-        plot_aa_pixel(ypxl1 + 1, xpxl1, color, fpart(yend) * xgap);
-    } else {
-        plot_aa_pixel(xpxl1, ypxl1, color, rfpart(yend) * xgap);
-        plot_aa_pixel(xpxl1, ypxl1 + 1, color, fpart(yend) * xgap);
-    }
-    
-    float intery = yend + gradient;
-    
-    // Handle second endpoint
-    xend = std::round(static_cast<float>(x2));
-    yend = y2 + gradient * (xend - x2);
-    xgap = fpart(x2 + 0.5f);
-    int xpxl2 = static_cast<int>(xend);
-    int ypxl2 = static_cast<int>(std::floor(yend));
-    
-    if (steep) {
-        plot_aa_pixel(ypxl2, xpxl2, color, rfpart(yend) * xgap);
-        plot_aa_pixel(ypxl2 + 1, xpxl2, color, fpart(yend) * xgap);
-    } else {
-        plot_aa_pixel(xpxl2, ypxl2, color, rfpart(yend) * xgap);
-        plot_aa_pixel(xpxl2, ypxl2 + 1, color, fpart(yend) * xgap);
-    }
-    
-    // Main loop
-    for (int x = xpxl1 + 1; x < xpxl2; ++x) {
-        int ipart = static_cast<int>(std::floor(intery));
-        float f = fpart(intery);
-        
-        if (steep) {
-            plot_aa_pixel(ipart, x, color, 1.0f - f);
-            plot_aa_pixel(ipart + 1, x, color, f);
-        } else {
-            plot_aa_pixel(x, ipart, color, 1.0f - f);
-            plot_aa_pixel(x, ipart + 1, color, f);
-        }
-        intery += gradient;
-    }
+    raster::line_aa(x1, y1, x2, y2, 0, 0, width_, height_, [&](int x, int y, float brightness) {
+        plot_aa_pixel(x, y, color, brightness);
+    });
 }
 
 void Surface::draw_circle_aa(int cx, int cy, int radius, const Color& color)
 {
     // Anti-aliased circle using distance-based alpha
     float r = static_cast<float>(radius);
+    // Only the part on this surface (display list tiles draw big rings piecewise)
+    int ya = std::max(-radius - 1, -cy), yb = std::min(radius + 1, height_ - 1 - cy);
+    int xa = std::max(-radius - 1, -cx), xb = std::min(radius + 1, width_ - 1 - cx);
     
-    for (int y = -radius - 1; y <= radius + 1; ++y) {
-        for (int x = -radius - 1; x <= radius + 1; ++x) {
+    for (int y = ya; y <= yb; ++y) {
+        for (int x = xa; x <= xb; ++x) {
             float dist = std::sqrt(static_cast<float>(x * x + y * y));
             float diff = std::abs(dist - r);
             
@@ -301,23 +364,8 @@ void Surface::draw_circle_aa(int cx, int cy, int radius, const Color& color)
 void Surface::fill_circle_aa(int cx, int cy, int radius, const Color& color)
 {
     // Anti-aliased filled circle with smooth edge
-    float r = static_cast<float>(radius);
-    
-    for (int y = -radius - 1; y <= radius + 1; ++y) {
-        for (int x = -radius - 1; x <= radius + 1; ++x) {
-            float dist = std::sqrt(static_cast<float>(x * x + y * y));
-            
-            if (dist <= r - 1.0f) {
-                // Inside - full opacity
-                blend_pixel(cx + x, cy + y, color);
-            } else if (dist <= r + 1.0f) {
-                // Edge - anti-aliased
-                float alpha = (r + 1.0f - dist) / 2.0f;
-                alpha = std::clamp(alpha, 0.0f, 1.0f);
-                plot_aa_pixel(cx + x, cy + y, color, alpha);
-            }
-        }
-    }
+    raster::filled_circle_aa(cx, cy, radius, 0, 0, width_, height_,
+                             [&](int x, int y, float alpha) { plot_aa_pixel(x, y, color, alpha); });
 }
 
 void Surface::draw_rect(int x, int y, int w, int h, const Color& color)
@@ -330,12 +378,12 @@ void Surface::draw_rect(int x, int y, int w, int h, const Color& color)
         draw_line_aa(x + w - 1, y, x + w - 1, y + h - 1, color); // Right
     } else {
         // Top and bottom
-        for (int px = x; px < x + w; ++px) {
+        for (int px = std::max(x, 0); px < std::min(x + w, width_); ++px) {
             set_pixel(px, y, color);
             set_pixel(px, y + h - 1, color);
         }
         // Left and right
-        for (int py = y; py < y + h; ++py) {
+        for (int py = std::max(y, 0); py < std::min(y + h, height_); ++py) {
             set_pixel(x, py, color);
             set_pixel(x + w - 1, py, color);
         }
@@ -346,8 +394,12 @@ void Surface::draw_rect(int x, int y, int w, int h, const Color& color)
 
 void Surface::blit(const Surface& source, int dest_x, int dest_y)
 {
-    for (int sy = 0; sy < source.height_; ++sy) {
-        for (int sx = 0; sx < source.width_; ++sx) {
+    // Only the source rows/columns that land on this surface
+    int sx0 = std::max(0, -dest_x), sx1 = std::min(source.width_, width_ - dest_x);
+    int sy0 = std::max(0, -dest_y), sy1 = std::min(source.height_, height_ - dest_y);
+    
+    for (int sy = sy0; sy < sy1; ++sy) {
+        for (int sx = sx0; sx < sx1; ++sx) {
             int dx = dest_x + sx;
             int dy = dest_y + sy;
             
@@ -368,9 +420,11 @@ void Surface::blit_scaled(const Surface& source, int dest_x, int dest_y, int des
 {
     float scale_x = static_cast<float>(source.width_) / dest_w;
     float scale_y = static_cast<float>(source.height_) / dest_h;
+    int dx0 = std::max(0, -dest_x), dx1 = std::min(dest_w, width_ - dest_x);
+    int dy0 = std::max(0, -dest_y), dy1 = std::min(dest_h, height_ - dest_y);
     
-    for (int dy = 0; dy < dest_h; ++dy) {
-        for (int dx = 0; dx < dest_w; ++dx) {
+    for (int dy = dy0; dy < dy1; ++dy) {
+        for (int dx = dx0; dx < dx1; ++dx) {
             int px = dest_x + dx;
             int py = dest_y + dy;
             
@@ -393,9 +447,11 @@ void Surface::blit_scaled(const Surface& source, int dest_x, int dest_y, int des
 void Surface::blit_alpha(const Surface& source, int dest_x, int dest_y, float alpha)
 {
     alpha = std::clamp(alpha, 0.0f, 1.0f);
+    int sx0 = std::max(0, -dest_x), sx1 = std::min(source.width_, width_ - dest_x);
+    int sy0 = std::max(0, -dest_y), sy1 = std::min(source.height_, height_ - dest_y);
     
-    for (int sy = 0; sy < source.height_; ++sy) {
-        for (int sx = 0; sx < source.width_; ++sx) {
+    for (int sy = sy0; sy < sy1; ++sy) {
+        for (int sx = sx0; sx < sx1; ++sx) {
             int dx = dest_x + sx;
             int dy = dest_y + sy;
             
@@ -410,11 +466,13 @@ void Surface::blit_alpha(const Surface& source, int dest_x, int dest_y, float al
 
 std::shared_ptr<Surface> Surface::copy() const
 {
+    AllocationTag tag("Surface::copy");
     return std::make_shared<Surface>(*this);
 }
 
 std::shared_ptr<Surface> Surface::subsurface(int x, int y, int w, int h) const
 {
+    AllocationTag tag("Surface::subsurface");
     auto result = std::make_shared<Surface>(w, h);
     
     for (int py = 0; py < h; ++py) {
@@ -662,8 +720,8 @@ void Surface::draw_squircle(int x, int y, int w, int h, const Color& color)
     float cx = x + a;
     float cy = y + b;
     
-    int min_x = x-1; int max_x = x+w+1;
-    int min_y = y-1; int max_y = y+h+1;
+    int min_x = std::max(0, x - 1); int max_x = std::min(width_, x + w + 1);
+    int min_y = std::max(0, y - 1); int max_y = std::min(height_, y + h + 1);
     
     for (int py = min_y; py < max_y; ++py) {
         for (int px = min_x; px < max_x; ++px) {
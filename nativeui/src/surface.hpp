@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <algorithm>
 #include <cstring>
 #include <stdexcept>
@@ -21,7 +23,7 @@ enum class AAType {
 };
 
 /**
- * Global anti-aliasing settings (singleton)
+ * Global anti-aliasing settings (singleton, thread-safe)
  */
 class AntiAliasingSettings {
 public:
@@ -34,7 +36,7 @@ public:
     void off() { enabled_ = false; }
     bool is_enabled() const { return enabled_; }
     
-    void set_type(AAType t) { type_ = t; if (t == AAType::Off) enabled_ = false; else enabled_ = true; }
+    void set_type(AAType t) { type_ = t; enabled_ = t != AAType::Off; }
     void set_type(int t) { set_type(static_cast<AAType>(std::clamp(t, 0, 3))); }
     void set_type(const std::string& t) {
         if (t == "off") set_type(AAType::Off);
@@ -55,8 +57,9 @@ public:
 
 private:
     AntiAliasingSettings() : enabled_(true), type_(AAType::Basic) {}
-    bool enabled_;
-    AAType type_;
+    // Atomic: read by every draw call, which may run on any thread
+    std::atomic<bool> enabled_;
+    std::atomic<AAType> type_;
 };
 
 /**
@@ -93,13 +96,26 @@ struct Color {
 
 /**
  * Surface - A 2D pixel buffer supporting RGBA pixels
+ *
+ * Threading: drawing to distinct surfaces from different threads is safe
+ * (the Python bindings release the GIL for heavy calls). A single surface
+ * must not be written concurrently, or read while being written.
  */
 class Surface {
 public:
     Surface(int width, int height);
-    Surface(const Surface& other);
+    Surface(const Surface& other);  // Always an owned copy
     Surface& operator=(const Surface& other);
-    ~Surface() = default;
+    Surface(Surface&& other) noexcept;
+    Surface& operator=(Surface&& other) noexcept;
+    ~Surface();
+    
+    // Wrap external RGBA memory without copying; `pitch` is the byte distance
+    // between rows (0 = width * 4). `owner` keeps the memory alive for as long
+    // as the surface exists.
+    static std::shared_ptr<Surface> wrap(uint8_t* data, int width, int height,
+                                         std::shared_ptr<void> owner, size_t pitch = 0);
+    bool is_external() const { return external_ != nullptr; }
     
     // Dimensions
     int get_width() const { return width_; }
@@ -109,6 +125,7 @@ public:
     void set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
     void set_pixel(int x, int y, const Color& color);
     void blend_pixel(int x, int y, const Color& color);  // Alpha-blend pixel
+    void plot_aa_pixel(int x, int y, const Color& color, float brightness);  // Blend with coverage (0..1)
     Color get_pixel(int x, int y) const;
     
     // Fill operations
@@ -145,32 +162,57 @@ public:
     void blit_scaled(const Surface& source, int dest_x, int dest_y, int dest_w, int dest_h);
     void blit_alpha(const Surface& source, int dest_x, int dest_y, float alpha = 1.0f);
     
-    // Raw data access (for SDL texture updates)
-    const uint8_t* get_data() const { return pixels_.data(); }
-    uint8_t* get_data() { return pixels_.data(); }
-    size_t get_pitch() const { return width_ * 4; }
+    // Raw data access (for SDL texture updates). Rows are get_pitch() bytes
+    // apart, which is more than width * 4 for views into a larger buffer.
+    const uint8_t* get_data() const { return data_; }
+    uint8_t* get_data() { return data_; }
+    size_t get_pitch() const { return pitch_; }
+    size_t get_size() const { return static_cast<size_t>(width_) * height_ * 4; }  // Pixel bytes
+    bool is_contiguous() const { return pitch_ == static_cast<size_t>(width_) * 4; }
+    
+    // Copy all pixels to / from tightly packed RGBA (width * 4 bytes per row)
+    void read_pixels(uint8_t* dst) const;
+    void write_pixels(const uint8_t* src);
+    
+    // Zero-copy exports (NumPy arrays, memoryviews) pin the pixels: a pinned
+    // atlas view is never moved by Atlas::defragment(). pin() returns the
+    // pointer the export may use until its matching unpin().
+    uint8_t* pin();
+    void unpin();
+    bool is_pinned() const;
     
     // Create a copy
     std::shared_ptr<Surface> copy() const;
     
     // Subsurface (view into a region)
     std::shared_ptr<Surface> subsurface(int x, int y, int w, int h) const;
+    
+    // Allocation tag recorded by MemoryTracker
+    const char* get_origin() const { return origin_; }
 
 private:
     int width_;
     int height_;
-    std::vector<uint8_t> pixels_;  // RGBA format, 4 bytes per pixel
+    std::vector<uint8_t> pixels_;  // RGBA format, 4 bytes per pixel (empty when external)
+    uint8_t* data_;                // pixels_.data() or the wrapped memory
+    size_t pitch_;                 // Bytes per row
+    std::shared_ptr<void> external_;
+    const char* origin_;
+    int pins_ = 0;                 // Live exports; guarded by pin_mutex()
+    
+    static std::mutex& pin_mutex();  // Orders pin() against Atlas::defragment
+    
+    Surface(uint8_t* data, int width, int height, std::shared_ptr<void> owner, size_t pitch);  // See wrap()
+    
+    friend class Atlas;  // Moves its views' memory when defragmenting
     
     inline size_t pixel_offset(int x, int y) const {
-        return (y * width_ + x) * 4;
+        return y * pitch_ + static_cast<size_t>(x) * 4;
     }
     
     inline bool in_bounds(int x, int y) const {
         return x >= 0 && x < width_ && y >= 0 && y < height_;
     }
-    
-    // AA helpers
-    void plot_aa_pixel(int x, int y, const Color& color, float brightness);
 };
 
 } // namespace nativeui
@@ -0,0 +1,188 @@
+#include "text_cache.hpp"
+#include "memory_tracker.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace nativeui {
+
+namespace {
+
+const size_t kDefaultBudget = 8 * 1024 * 1024;
+
+uint32_t pack(const Color& c)
+{
+    return (static_cast<uint32_t>(c.r) << 24) | (static_cast<uint32_t>(c.g) << 16) |
+           (static_cast<uint32_t>(c.b) << 8) | c.a;
+}
+
+size_t run_bytes(const GlyphRun& run)
+{
+    return sizeof(GlyphRun) + run.glyphs.capacity() * sizeof(GlyphRun::Glyph);
+}
+
+} // namespace
+
+bool TextLayoutCache::Key::operator==(const Key& o) const
+{
+    return size == o.size && wrap_width == o.wrap_width && color == o.color && rendered == o.rendered &&
+           text == o.text && font == o.font;
+}
+
+size_t TextLayoutCache::KeyHash::operator()(const Key& k) const
+{
+    size_t h = std::hash<std::string>()(k.text);
+    auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+    mix(std::hash<std::string>()(k.font));
+    mix(static_cast<size_t>(k.size));
+    mix(static_cast<size_t>(k.wrap_width));
+    mix(k.rendered ? k.color : 0x5a5a5a5au);
+    return h;
+}
+
+TextLayoutCache& TextLayoutCache::instance()
+{
+    // Leaked on purpose: entries own Fonts and Surfaces whose destructors
+    // need the font library lock and the BufferPool
+    static TextLayoutCache* cache = new TextLayoutCache();
+    return *cache;
+}
+
+TextLayoutCache::TextLayoutCache()
+    : budget_(kDefaultBudget)
+{
+    // Soft pressure halves the cache, hard pressure empties it
+    MemoryTracker::instance().add_evictor([this](MemoryPressure pressure) {
+        if (pressure == MemoryPressure::Hard) {
+            clear();
+        } else {
+            trim(get_budget() / 2);
+        }
+    });
+}
+
+TextLayoutCache::Entry* TextLayoutCache::find(const Key& key)
+{
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return &lru_.front();
+}
+
+void TextLayoutCache::insert(Entry entry)
+{
+    // Another thread may have filled the same key meanwhile
+    if (index_.count(entry.key)) return;
+    bytes_ += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_.emplace(lru_.front().key, lru_.begin());
+    evict_to(budget_);
+}
+
+void TextLayoutCache::evict_to(size_t target_bytes)
+{
+    while (bytes_ > target_bytes && !lru_.empty()) {
+        bytes_ -= lru_.back().bytes;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+std::shared_ptr<const GlyphRun> TextLayoutCache::layout(const std::string& font, int size, const std::string& text,
+                                                        int wrap_width)
+{
+    Key key{text, font, size, std::max(0, wrap_width), 0, false};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (Entry* hit = find(key)) return hit->run;
+    }
+
+    ProfileScope scope("TextLayoutCache::layout");
+    auto f = FontCache::get(font, size);
+    if (!f) return nullptr;
+    // The run's coverage lives in the Font's glyphs, so the run holds the Font
+    struct Owned {
+        std::shared_ptr<Font> font;
+        GlyphRun run;
+    };
+    auto owned = std::make_shared<Owned>();
+    owned->run = key.wrap_width > 0 ? f->layout_wrapped(text, key.wrap_width) : f->layout(text);
+    owned->font = std::move(f);
+    std::shared_ptr<const GlyphRun> run(owned, &owned->run);
+    size_t bytes = run_bytes(*run) + text.size() + font.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert(Entry{std::move(key), run, nullptr, bytes});
+    return run;
+}
+
+std::shared_ptr<Surface> TextLayoutCache::render(const std::string& font, int size, const std::string& text,
+                                                 const Color& color, int wrap_width)
+{
+    Key key{text, font, size, std::max(0, wrap_width), pack(color), true};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (Entry* hit = find(key)) return hit->surface;
+    }
+
+    ProfileScope scope("TextLayoutCache::render");
+    auto f = FontCache::get(font, size);
+    if (!f) return nullptr;
+    auto surface = key.wrap_width > 0 ? f->render_wrapped(text, color, key.wrap_width) : f->render(text, color);
+    size_t bytes = (surface ? surface->get_size() : 0) + text.size() + font.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert(Entry{std::move(key), nullptr, surface, bytes});
+    return surface;
+}
+
+void TextLayoutCache::set_budget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    evict_to(budget_);
+}
+
+size_t TextLayoutCache::get_budget() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+void TextLayoutCache::trim(size_t target_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    evict_to(target_bytes);
+}
+
+void TextLayoutCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    evict_to(0);
+}
+
+TextCacheStats TextLayoutCache::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    TextCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = lru_.size();
+    stats.bytes = bytes_;
+    stats.budget = budget_;
+    return stats;
+}
+
+void TextLayoutCache::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    hits_ = misses_ = evictions_ = 0;
+}
+
+} // namespace nativeui
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "font.hpp"
+#include "surface.hpp"
+
+namespace nativeui {
+
+struct TextCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;        // Estimated memory held by cached entries
+    size_t budget = 0;
+};
+
+/**
+ * TextLayoutCache - Shared LRU cache of laid-out and rendered strings
+ *
+ * Entries are keyed on (text, font, size, wrap width) plus the color for
+ * rendered surfaces; layouts are coverage only and serve every color. A
+ * repeated label costs one hash lookup. Least recently used entries are
+ * dropped once the estimated bytes exceed the budget (8 MB by default), and
+ * under memory pressure. A returned layout owns its Font (an aliasing
+ * shared_ptr), so it stays drawable after eviction and after the FontCache
+ * lets the font go. The cache is never destroyed (see instance()) and
+ * Font::quit() empties it.
+ *
+ * Returned surfaces are shared between callers and must not be modified.
+ * Thread-safe; fonts are loaded and text is laid out outside the lock.
+ */
+class TextLayoutCache {
+public:
+    static TextLayoutCache& instance();
+
+    // Coverage layout (wrap_width <= 0: one line); nullptr if the font can't be loaded
+    std::shared_ptr<const GlyphRun> layout(const std::string& font, int size, const std::string& text,
+                                           int wrap_width = 0);
+
+    // Text rendered in `color`, as Font::render / Font::render_wrapped return it
+    std::shared_ptr<Surface> render(const std::string& font, int size, const std::string& text,
+                                    const Color& color, int wrap_width = 0);
+
+    void set_budget(size_t bytes);
+    size_t get_budget() const;
+    void trim(size_t target_bytes);  // Evict until at most target_bytes remain
+    void clear();
+
+    TextCacheStats get_stats() const;
+    void reset_stats();
+
+private:
+    TextLayoutCache();  // Never destroyed, see instance()
+    TextLayoutCache(const TextLayoutCache&) = delete;
+    TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+    struct Key {
+        std::string text;
+        std::string font;
+        int size;
+        int wrap_width;
+        uint32_t color;    // RGBA of rendered surfaces
+        bool rendered;     // false: coverage layout (color unused)
+        bool operator==(const Key& o) const;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<const GlyphRun> run;      // Owns its Font
+        std::shared_ptr<Surface> surface;
+        size_t bytes;
+    };
+
+    // Most recently used first
+    std::list<Entry> lru_;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    size_t bytes_ = 0;
+    size_t budget_;
+    size_t hits_ = 0, misses_ = 0, evictions_ = 0;
+    mutable std::mutex mutex_;
+
+    // Move a hit to the front; nullptr on a miss (mutex held)
+    Entry* find(const Key& key);
+    void insert(Entry entry);
+    void evict_to(size_t target_bytes);
+};
+
+} // namespace nativeui
@@ -0,0 +1,65 @@
+#include "text_rasterizer.hpp"
+#include "profiler.hpp"
+#include "text_cache.hpp"
+
+namespace nativeui {
+
+namespace {
+
+// Strings per parallel_for chunk once the glyphs exist (layout is then cheap)
+const int kStringsPerTask = 16;
+
+template <typename T, typename Produce>
+std::vector<std::future<T>> run_batch(const std::string& font, int size, std::vector<std::string> texts,
+                                      TaskPriority priority, Produce produce)
+{
+    auto promises = std::make_shared<std::vector<std::promise<T>>>(texts.size());
+    std::vector<std::future<T>> futures;
+    futures.reserve(texts.size());
+    for (auto& promise : *promises) futures.push_back(promise.get_future());
+    if (texts.empty()) return futures;
+
+    auto batch = std::make_shared<std::vector<std::string>>(std::move(texts));
+    ThreadPool::instance().enqueue([font, size, batch, promises, priority, produce]() {
+        ProfileScope scope("TextRasterizer::batch");
+        try {
+            if (auto f = FontCache::get(font, size)) f->prepare(*batch);
+        } catch (...) {
+            // The per-string work below reports the failure
+        }
+        ThreadPool::instance().parallel_for(0, static_cast<int>(batch->size()), kStringsPerTask,
+                                            [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                try {
+                    (*promises)[i].set_value(produce((*batch)[i]));
+                } catch (...) {
+                    (*promises)[i].set_exception(std::current_exception());
+                }
+            }
+        }, priority);
+    }, priority);
+    return futures;
+}
+
+} // namespace
+
+std::vector<std::future<std::shared_ptr<const GlyphRun>>> TextRasterizer::layout(
+    const std::string& font, int size, std::vector<std::string> texts, int wrap_width, TaskPriority priority)
+{
+    return run_batch<std::shared_ptr<const GlyphRun>>(font, size, std::move(texts), priority,
+        [font, size, wrap_width](const std::string& text) {
+            return TextLayoutCache::instance().layout(font, size, text, wrap_width);
+        });
+}
+
+std::vector<std::future<std::shared_ptr<Surface>>> TextRasterizer::render(
+    const std::string& font, int size, std::vector<std::string> texts, const Color& color, int wrap_width,
+    TaskPriority priority)
+{
+    return run_batch<std::shared_ptr<Surface>>(font, size, std::move(texts), priority,
+        [font, size, color, wrap_width](const std::string& text) {
+            return TextLayoutCache::instance().render(font, size, text, color, wrap_width);
+        });
+}
+
+} // namespace nativeui
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "font.hpp"
+#include "surface.hpp"
+#include "thread_pool.hpp"
+
+namespace nativeui {
+
+/**
+ * TextRasterizer - Lays out and renders batches of strings on the thread pool
+ *
+ * A batch first rasterizes every glyph its strings are missing in parallel
+ * (Font::prepare, one TTF_Font per pool thread on the same file and size).
+ * The strings are then laid out or rendered in parallel through the
+ * TextLayoutCache, so widgets drawing the same labels later get cache hits.
+ * Each string has its own future, in input order, resolving to what the cache
+ * would return (nullptr if the font can't be loaded).
+ *
+ * Don't wait on the futures from inside a pool task.
+ */
+class TextRasterizer {
+public:
+    static std::vector<std::future<std::shared_ptr<const GlyphRun>>> layout(
+        const std::string& font, int size, std::vector<std::string> texts, int wrap_width = 0,
+        TaskPriority priority = TaskPriority::Normal);
+
+    static std::vector<std::future<std::shared_ptr<Surface>>> render(
+        const std::string& font, int size, std::vector<std::string> texts, const Color& color,
+        int wrap_width = 0, TaskPriority priority = TaskPriority::Normal);
+};
+
+} // namespace nativeui
@@ -1,4 +1,5 @@
 #include "textfield.hpp"
+#include "text_cache.hpp"
 #include <algorithm>
 #include <cmath>
 #include <sstream>
@@ -50,6 +51,8 @@ void TextField::set_placeholder(const PlaceholderStyle& style) {
 
 void TextField::set_text_style(const TypedTextStyle& style) {
     text_style_ = style;
+    x_offsets_valid_ = false;
+    text_run_valid_ = false;
     redraw();
 }
 
@@ -65,6 +68,8 @@ void TextField::set_style(const std::string& state, const TextFieldStyle& style)
 void TextField::set_text(const std::string& text) {
     if (check_limits(text)) {
         text_ = text;
+        x_offsets_valid_ = false;
+        text_run_valid_ = false;
         cursor_pos_ = static_cast<int>(text_.length());
         sel_start_ = cursor_pos_;
         sel_end_ = cursor_pos_;
@@ -291,6 +296,7 @@ void TextField::insert_text(const std::string& str) {
     
     if (check_limits(new_text)) {
         text_ = new_text;
+        text_edited(cursor_pos_, 0, static_cast<int>(str.length()));
         cursor_pos_ += static_cast<int>(str.length());
         sel_start_ = cursor_pos_;
         sel_end_ = cursor_pos_;
@@ -311,6 +317,7 @@ void TextField::delete_selection() {
     int count = end - start;
     
     text_.erase(start, count);
+    text_edited(start, count, 0);
     cursor_pos_ = start;
     sel_start_ = start;
     sel_end_ = start;
@@ -373,6 +380,7 @@ void TextField::backspace_word() {
     
     int count = cursor_pos_ - new_pos;
     text_.erase(new_pos, count);
+    text_edited(new_pos, count, 0);
     cursor_pos_ = new_pos;
     sel_start_ = cursor_pos_;
     sel_end_ = cursor_pos_;
@@ -394,6 +402,7 @@ void TextField::backspace_char() {
         }
         
         text_.erase(cursor_pos_ - delete_len, delete_len);
+        text_edited(cursor_pos_ - delete_len, delete_len, 0);
         cursor_pos_ -= delete_len;
         sel_start_ = cursor_pos_;
         sel_end_ = cursor_pos_;
@@ -411,6 +420,7 @@ void TextField::delete_char() {
             delete_len++;
         }
         text_.erase(cursor_pos_, delete_len);
+        text_edited(cursor_pos_, delete_len, 0);
         cursor_visible_ = true;
         cursor_blink_timer_ = 0.0f;
     }
@@ -437,14 +447,78 @@ int TextField::count_words(const std::string& str) {
     return count;
 }
 
-void TextField::update_scroll() {
+void TextField::text_edited(int pos, int removed, int inserted) {
+    text_run_valid_ = false;
+    
+    // A stale table is rebuilt whole on the next lookup instead
+    if (!x_offsets_valid_ || x_offsets_.size() != text_.size() + removed - inserted + 1) {
+        x_offsets_valid_ = false;
+        return;
+    }
     auto font = FontCache::get(text_style_.font, text_style_.font_size);
-    if (!font) return;
+    if (!font) {
+        x_offsets_valid_ = false;
+        return;
+    }
+    
+    // Window from the code point before the edit to the one after it, whose
+    // pen then carries the kerning across the edit
+    size_t start = pos;
+    if (start > 0) {
+        --start;
+        while (start > 0 && (text_[start] & 0xC0) == 0x80) start--;
+    }
+    size_t next = pos + inserted;
+    size_t end = next;
+    if (end < text_.size()) {
+        ++end;
+        while (end < text_.size() && (text_[end] & 0xC0) == 0x80) end++;
+    }
+    TextMetrics m = font->measure(text_.substr(start, end - start));
+    
+    int base = x_offsets_[start] - m.positions[0];
+    std::vector<int> window(next - start);
+    for (size_t k = 0; k < m.byte_offsets.size() && m.byte_offsets[k] < window.size(); ++k) {
+        for (size_t b = m.byte_offsets[k]; b < std::min(m.byte_offsets[k + 1], window.size()); ++b) {
+            window[b] = base + m.positions[k];
+        }
+    }
     
-    // Calculate text width up to cursor
-    std::string text_to_cursor = text_.substr(0, cursor_pos_);
-    int cursor_x, h;
-    font->get_size(text_to_cursor, cursor_x, h);
+    // Everything from the code point after the edit moves by the same amount
+    int anchor = m.positions[m.byte_offsets.size() - (end > next ? 2 : 1)];
+    int delta = base + anchor - x_offsets_[pos + removed];
+    x_offsets_.erase(x_offsets_.begin() + start, x_offsets_.begin() + pos + removed);
+    x_offsets_.insert(x_offsets_.begin() + start, window.begin(), window.end());
+    for (size_t i = next; i < x_offsets_.size(); ++i) x_offsets_[i] += delta;
+    
+    // Ink overhanging the pen only reaches back a glyph or two, so only
+    // edits near the front can change the shift
+    int reach = 2 * font->get_height();
+    if (x_offsets_[start] < reach) {
+        size_t prefix = start;
+        while (prefix < text_.size() && x_offsets_[prefix] < x_offsets_[start] + reach) prefix++;
+        x_shift_ = font->measure(text_.substr(0, prefix)).positions[0];
+    }
+}
+
+int TextField::text_x(int byte_pos) {
+    if (!x_offsets_valid_ || x_offsets_.size() != text_.size() + 1) {
+        auto font = FontCache::get(text_style_.font, text_style_.font_size);
+        if (!font) return 0;
+        TextMetrics m = font->measure(text_);
+        x_shift_ = m.positions[0];
+        x_offsets_.assign(text_.size() + 1, 0);
+        for (size_t k = 0; k + 1 < m.byte_offsets.size(); ++k) {
+            for (size_t b = m.byte_offsets[k]; b < m.byte_offsets[k + 1]; ++b) x_offsets_[b] = m.positions[k] - x_shift_;
+        }
+        x_offsets_.back() = m.positions.back() - x_shift_;
+        x_offsets_valid_ = true;
+    }
+    return x_shift_ + x_offsets_[std::clamp(byte_pos, 0, static_cast<int>(text_.size()))];
+}
+
+void TextField::update_scroll() {
+    int cursor_x = text_x(cursor_pos_);
     
     int visible_width = base_width_ - 16;
     
@@ -486,34 +560,34 @@ std::vector<std::string> TextField::wrap_text(const std::string& text, int max_w
         return lines;
     }
     
-    std::string current_line;
-    std::string current_word;
-    
-    for (size_t i = 0; i <= text.length(); ++i) {
-        char c = (i < text.length()) ? text[i] : ' ';
+    // One measuring pass; a line's width is then a difference of pen positions.
+    // The trailing space stands in for the end of the text, as a break point.
+    std::string padded = text + " ";
+    TextMetrics m = font->measure(padded);
+    size_t count = m.advances.size();
+    size_t line_start = 0, word_start = 0;  // Code point indices
+    auto bytes = [&](size_t begin, size_t end) {
+        return padded.substr(m.byte_offsets[begin], m.byte_offsets[end] - m.byte_offsets[begin]);
+    };
+    
+    for (size_t k = 0; k < count; ++k) {
+        char c = padded[m.byte_offsets[k]];
         
         if (c == '\n') {
-            current_line += current_word;
-            lines.push_back(current_line);
-            current_line.clear();
-            current_word.clear();
+            lines.push_back(bytes(line_start, k));
+            line_start = word_start = k + 1;
         } else if (c == ' ') {
-            int w, h;
-            font->get_size(current_line + current_word + " ", w, h);
-            if (w > max_width && !current_line.empty()) {
-                lines.push_back(current_line);
-                current_line = current_word + " ";
-            } else {
-                current_line += current_word + " ";
+            int w = m.positions[k + 1] - m.positions[line_start];
+            if (w > max_width && word_start > line_start) {
+                lines.push_back(bytes(line_start, word_start));
+                line_start = word_start;
             }
-            current_word.clear();
-        } else {
-            current_word += c;
+            word_start = k + 1;
         }
     }
     
-    if (!current_line.empty() || !current_word.empty()) {
-        lines.push_back(current_line + current_word);
+    if (line_start < count) {
+        lines.push_back(bytes(line_start, count));
     }
     
     if (lines.empty()) lines.push_back("");
@@ -634,14 +708,8 @@ void TextField::draw_selection(Surface& s) {
     int start = std::min(sel_start_, sel_end_);
     int end = std::max(sel_start_, sel_end_);
     
-    std::string before = text_.substr(0, start);
-    std::string selected = text_.substr(start, end - start);
-    
-    int x1, h1;
-    font->get_size(before, x1, h1);
-    
-    int sel_w, h2;
-    font->get_size(selected, sel_w, h2);
+    int x1 = text_x(start);
+    int sel_w = text_x(end) - x1;
     
     int padding = 8;
     int h = s.get_height();
@@ -663,52 +731,34 @@ void TextField::draw_text_content(Surface& s) {
     
     bool show_placeholder = text_.empty() && !placeholder_.text.empty();
     
-    std::shared_ptr<Font> font;
-    std::string render_text;
+    std::shared_ptr<const GlyphRun> placeholder_run;
+    const GlyphRun* run = nullptr;
     Color text_color;
     
+    // Redraws (cursor blink, hover) reuse the layout until the text changes
     if (show_placeholder) {
-        font = FontCache::get(placeholder_.font, placeholder_.font_size);
-        render_text = placeholder_.text;
+        placeholder_run = TextLayoutCache::instance().layout(placeholder_.font, placeholder_.font_size, placeholder_.text);
+        run = placeholder_run.get();
         text_color = placeholder_.color;
-    } else {
-        font = FontCache::get(text_style_.font, text_style_.font_size);
-        render_text = text_;
+    } else if (!text_.empty()) {
+        if (!text_run_valid_) {
+            text_run_font_ = FontCache::get(text_style_.font, text_style_.font_size);
+            if (!text_run_font_) return;
+            text_run_ = text_run_font_->layout(text_);
+            text_run_valid_ = true;
+        }
+        run = &text_run_;
         text_color = text_style_.color;
     }
     
-    if (!font || render_text.empty()) return;
-    
-    auto text_surf = font->render(render_text, text_color);
-    if (!text_surf) return;
-    
-    int txt_w = text_surf->get_width();
-    int txt_h = text_surf->get_height();
+    if (!run) return;
     
     // Calculate position (vertically centered, left-aligned with scroll)
     int x = padding - scroll_offset_x_;
-    int y = (h - txt_h) / 2;
-    
-    // Clip and blit
-    int clip_start = std::max(0, -x);
-    int clip_width = std::min(txt_w - clip_start, w - padding * 2);
-    
-    if (clip_width > 0) {
-        // Blit
-         for (int ty = 0; ty < txt_h; ++ty) {
-            for (int tx = clip_start; tx < clip_start + clip_width; ++tx) {
-                int dest_x = x + tx;
-                int dest_y = y + ty;
-                
-                if (dest_x >= padding && dest_x < w - padding && dest_y >= 0 && dest_y < h) {
-                    Color c = text_surf->get_pixel(tx, ty);
-                    if (c.a > 0) {
-                        s.blend_pixel(dest_x, dest_y, c);
-                    }
-                }
-            }
-        }
-    }
+    int y = (h - run->height) / 2;
+    
+    // Clipped to the padded content box
+    run->draw(s, x, y, text_color, PixelRect{padding, 0, w - padding, h});
 }
 
 void TextField::draw_cursor(Surface& s) {
@@ -721,9 +771,7 @@ void TextField::draw_cursor(Surface& s) {
     int h = s.get_height();
     
     // Calculate cursor X position
-    std::string text_to_cursor = text_.substr(0, cursor_pos_);
-    int cursor_x, txt_h;
-    font->get_size(text_to_cursor, cursor_x, txt_h);
+    int cursor_x = text_x(cursor_pos_);
     
     int x = padding + cursor_x - scroll_offset_x_;
     int line_height = font->get_height();
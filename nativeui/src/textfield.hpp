@@ -6,6 +6,7 @@
 #include "font.hpp"
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -115,6 +116,21 @@ private:
     int scroll_offset_x_ = 0;
     int scroll_offset_y_ = 0;
     
+    // Pen x of every byte offset of text_ (continuation bytes repeat their
+    // code point's), kept in step with edits so the cursor, selection and
+    // scroll never re-measure the text. Drawn text is shifted right by
+    // x_shift_ when its first glyphs have ink left of the pen.
+    std::vector<int> x_offsets_;
+    int x_shift_ = 0;
+    bool x_offsets_valid_ = false;
+    
+    // Layout of text_ for redraws (cursor blink, hover), dropped on every
+    // edit. Kept here rather than in TextLayoutCache so text still being
+    // typed doesn't evict shared labels; text_run_font_ keeps its glyphs alive.
+    std::shared_ptr<Font> text_run_font_;
+    GlyphRun text_run_;
+    bool text_run_valid_ = false;
+    
     // Animation
     TextFieldStyle current_style_;
     TextFieldStyle target_style_;
@@ -147,6 +163,10 @@ private:
     int count_words(const std::string& str);
     
     void update_scroll();
+    // Splice x_offsets_ after text_ changed at pos; only the edited code points
+    // and their neighbours (for kerning) are measured again
+    void text_edited(int pos, int removed, int inserted);
+    int text_x(int byte_pos);
     void update_dimensions();
     std::vector<std::string> wrap_text(const std::string& text, int max_width);
     
@@ -154,6 +174,8 @@ private:
     void draw_selection(Surface& s);
     void draw_text_content(Surface& s);
     void draw_cursor(Surface& s);
+
+    friend struct TextFieldProbe;  // bench/textfield_check.cpp
 };
 
 } // namespace nativeui
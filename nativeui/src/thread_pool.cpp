@@ -0,0 +1,368 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nativeui {
+
+thread_local int ThreadPool::worker_index_ = -1;
+thread_local ThreadPool::Crew* ThreadPool::worker_crew_ = nullptr;
+
+namespace {
+
+// Restrict a thread to one core; false where unsupported
+bool pin_thread(std::thread::native_handle_type handle, unsigned core)
+{
+#ifdef _WIN32
+    if (core >= sizeof(DWORD_PTR) * 8) return false;
+    return SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(1) << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+#else
+    (void)handle;
+    (void)core;
+    return false;
+#endif
+}
+
+// Let a thread run on every core the calling thread may use again
+bool unpin_thread(std::thread::native_handle_type handle)
+{
+#ifdef _WIN32
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) return false;
+    return SetThreadAffinityMask(handle, process_mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return false;
+    return pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+#else
+    (void)handle;
+    return false;
+#endif
+}
+
+/**
+ * Shared state of one parallel_for call
+ */
+struct ForJob {
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    int chunks = 0;
+    int begin = 0;
+    int end = 0;
+    int grain = 1;
+    const std::function<void(int, int)>* body = nullptr;
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    // Claim and run chunks until none are left
+    void run() {
+        int c;
+        while ((c = next.fetch_add(1, std::memory_order_relaxed)) < chunks) {
+            int b = begin + c * grain;
+            int e = std::min(end, b + grain);
+            try {
+                (*body)(b, e);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+            done.fetch_add(1, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace
+
+ThreadPool& ThreadPool::instance()
+{
+    // Leaked on purpose: joining workers during static destruction can hang
+    // at interpreter shutdown or DLL unload
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+}
+
+ThreadPool::ThreadPool()
+    : next_queue_(0)
+    , pinned_(false)
+    , executed_(0)
+    , stolen_(0)
+{
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    crew_ = start(static_cast<int>(hw) - 1);
+}
+
+std::shared_ptr<ThreadPool::Crew> ThreadPool::current() const
+{
+    std::lock_guard<std::mutex> lock(crew_mutex_);
+    return crew_;
+}
+
+void ThreadPool::set_threads(int threads)
+{
+    if (is_worker_thread()) {
+        throw std::runtime_error("ThreadPool::set_threads cannot be called from a pool task");
+    }
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    std::lock_guard<std::mutex> resize(resize_mutex_);
+    if (threads == get_threads()) return;
+
+    // Publish the new crew first so new work never waits on the drain
+    std::shared_ptr<Crew> next = start(threads - 1);
+    std::shared_ptr<Crew> old;
+    {
+        std::lock_guard<std::mutex> lock(crew_mutex_);
+        old = std::move(crew_);
+        crew_ = std::move(next);
+    }
+    // Callers still holding `old` see it stopping and move to the new crew
+    stop(*old);
+}
+
+std::shared_ptr<ThreadPool::Crew> ThreadPool::start(int workers)
+{
+    auto crew = std::make_shared<Crew>();
+    for (int i = 0; i < workers; ++i) {
+        crew->workers.push_back(std::make_unique<Worker>());
+    }
+    Crew* raw = crew.get();
+    for (int i = 0; i < workers; ++i) {
+        crew->workers[i]->thread = std::thread([this, raw, i]() { worker_main(raw, i); });
+    }
+    if (pinned_.load(std::memory_order_relaxed)) apply_affinity(*crew);
+    return crew;
+}
+
+void ThreadPool::stop(Crew& crew)
+{
+    {
+        std::lock_guard<std::mutex> lock(crew.wake_mutex);
+        crew.stopping = true;
+    }
+    crew.wake_cv.notify_all();
+    // Workers drain every queued task before exiting
+    for (auto& w : crew.workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+bool ThreadPool::set_pinning(bool pinned)
+{
+    std::lock_guard<std::mutex> resize(resize_mutex_);
+    std::shared_ptr<Crew> crew = current();
+    pinned_.store(pinned, std::memory_order_relaxed);
+    if (!pinned) {
+        // Let the OS schedule the workers freely again
+        bool ok = true;
+        for (auto& w : crew->workers) ok = unpin_thread(w->thread.native_handle()) && ok;
+        return ok;
+    }
+    return apply_affinity(*crew);
+}
+
+bool ThreadPool::apply_affinity(Crew& crew)
+{
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw < 2) return false;
+    // Only workers are pinned; core 0 is left to the UI thread, whose own
+    // affinity is never changed
+    bool ok = true;
+    for (size_t i = 0; i < crew.workers.size(); ++i) {
+        ok = pin_thread(crew.workers[i]->thread.native_handle(), 1 + static_cast<unsigned>(i % (hw - 1))) && ok;
+    }
+    return ok;
+}
+
+void ThreadPool::enqueue(std::function<void()> task, TaskPriority priority)
+{
+    // Workers keep their own spawns local while their crew is live
+    if (worker_crew_ && push(*worker_crew_, task, priority)) return;
+
+    for (;;) {
+        std::shared_ptr<Crew> crew = current();
+        if (crew->workers.empty()) {
+            task();
+            return;
+        }
+        // Fails only if set_threads() retired this crew meanwhile
+        if (push(*crew, task, priority)) return;
+    }
+}
+
+bool ThreadPool::push(Crew& crew, std::function<void()>& task, TaskPriority priority)
+{
+    // Other threads spread round-robin
+    size_t index = &crew == worker_crew_
+        ? static_cast<size_t>(worker_index_)
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % crew.workers.size();
+    {
+        // Checked and counted under the wake lock, so a stopping crew's
+        // workers never exit with work still queued
+        std::lock_guard<std::mutex> wake(crew.wake_mutex);
+        if (crew.stopping) return false;
+        Worker& w = *crew.workers[index];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        crew.pending.fetch_add(1, std::memory_order_release);
+        w.queues[static_cast<int>(priority)].push_back(std::move(task));
+    }
+    crew.wake_cv.notify_one();
+    return true;
+}
+
+bool ThreadPool::try_run(Crew& crew, int self)
+{
+    size_t count = crew.workers.size();
+    if (count == 0) return false;
+
+    std::function<void()> task;
+    bool stolen = false;
+    for (int p = 0; p < kPriorityCount && !task; ++p) {
+        // Own queue first, newest task (still warm in cache)
+        if (self >= 0) {
+            Worker& w = *crew.workers[self];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.queues[p].empty()) {
+                task = std::move(w.queues[p].back());
+                w.queues[p].pop_back();
+            }
+        }
+        // Then steal the oldest task from a victim
+        size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+        for (size_t k = 0; k < count && !task; ++k) {
+            size_t victim = (start + k) % count;
+            if (static_cast<int>(victim) == self) continue;
+            Worker& w = *crew.workers[victim];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.queues[p].empty()) {
+                task = std::move(w.queues[p].front());
+                w.queues[p].pop_front();
+                stolen = self >= 0;
+            }
+        }
+    }
+    if (!task) return false;
+
+    crew.pending.fetch_sub(1, std::memory_order_acq_rel);
+    if (stolen) stolen_.fetch_add(1, std::memory_order_relaxed);
+    task();
+    executed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::run_pending_task()
+{
+    // A draining worker still has to finish its own crew's queue
+    if (worker_crew_) return try_run(*worker_crew_, worker_index_);
+    std::shared_ptr<Crew> crew = current();
+    return try_run(*crew, -1);
+}
+
+void ThreadPool::worker_main(Crew* crew, int index)
+{
+    worker_index_ = index;
+    worker_crew_ = crew;
+    for (;;) {
+        if (try_run(*crew, index)) continue;
+
+        std::unique_lock<std::mutex> lock(crew->wake_mutex);
+        crew->wake_cv.wait(lock, [crew]() {
+            return crew->stopping || crew->pending.load(std::memory_order_acquire) > 0;
+        });
+        if (crew->stopping && crew->pending.load(std::memory_order_acquire) == 0) break;
+    }
+    worker_index_ = -1;
+    worker_crew_ = nullptr;
+}
+
+void ThreadPool::parallel_for(int begin, int end, int grain, const std::function<void(int, int)>& body,
+                              TaskPriority priority)
+{
+    if (end <= begin) return;
+    grain = std::max(1, grain);
+    int chunks = (end - begin + grain - 1) / grain;
+
+    // Held for the whole call so the wait loop below can help without
+    // re-fetching; helpers may still land on a newer crew, which runs them
+    std::shared_ptr<Crew> snapshot;
+    Crew* crew = worker_crew_;
+    if (!crew) {
+        snapshot = current();
+        crew = snapshot.get();
+    }
+    if (chunks == 1 || crew->workers.empty()) {
+        body(begin, end);
+        return;
+    }
+
+    auto job = std::make_shared<ForJob>();
+    job->chunks = chunks;
+    job->begin = begin;
+    job->end = end;
+    job->grain = grain;
+    job->body = &body;
+
+    // Helpers that start after the work is gone find no chunk and return
+    // without touching `body`
+    int helpers = std::min(chunks - 1, static_cast<int>(crew->workers.size()));
+    for (int i = 0; i < helpers; ++i) {
+        enqueue([job]() { job->run(); }, priority);
+    }
+
+    job->run();
+    while (job->done.load(std::memory_order_acquire) < chunks) {
+        if (!try_run(*crew, worker_crew_ ? worker_index_ : -1)) std::this_thread::yield();
+    }
+
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+void ThreadPool::parallel_rows(int width, int height, const std::function<void(int, int)>& body,
+                               int min_pixels, TaskPriority priority)
+{
+    int rows = std::max(1, min_pixels / std::max(1, width));
+    parallel_for(0, height, rows, body, priority);
+}
+
+void ThreadPool::parallel_tiles(int width, int height, int tile,
+                                const std::function<void(int, int, int, int)>& body,
+                                TaskPriority priority)
+{
+    tile = std::max(1, tile);
+    int cols = (width + tile - 1) / tile;
+    int rows = (height + tile - 1) / tile;
+    parallel_for(0, cols * rows, 1, [&](int t0, int t1) {
+        for (int t = t0; t < t1; ++t) {
+            int x0 = (t % cols) * tile;
+            int y0 = (t / cols) * tile;
+            body(x0, y0, std::min(width, x0 + tile), std::min(height, y0 + tile));
+        }
+    }, priority);
+}
+
+ThreadPoolStats ThreadPool::get_stats() const
+{
+    ThreadPoolStats stats;
+    stats.threads = get_threads();
+    stats.tasks_executed = executed_.load(std::memory_order_relaxed);
+    stats.tasks_stolen = stolen_.load(std::memory_order_relaxed);
+    stats.pinned = pinned_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace nativeui
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nativeui {
+
+/**
+ * Task priorities; workers always drain higher levels first
+ */
+enum class TaskPriority {
+    High,    // Work the current frame is waiting on
+    Normal,
+    Low      // Background work (prefetch, cache warming)
+};
+
+struct ThreadPoolStats {
+    int threads = 1;             // Workers + the calling thread
+    uint64_t tasks_executed = 0;
+    uint64_t tasks_stolen = 0;
+    bool pinned = false;
+};
+
+/**
+ * ThreadPool - Shared work-stealing executor for effects, compositing and text (singleton)
+ *
+ * Each worker owns a deque per priority: it pops its own work LIFO and steals
+ * from the other workers FIFO when idle. parallel_for() splits a range into
+ * grain-sized chunks that workers and the calling thread claim dynamically,
+ * so the caller never idles and nested calls cannot deadlock. Small ranges
+ * run inline. Tasks get their temporaries from ScratchArena::local(), which
+ * is per thread. All parallel features go through this pool instead of
+ * creating threads.
+ *
+ * The workers form a crew that callers snapshot for each operation.
+ * set_threads() publishes a new crew, then drains and joins the old one, so
+ * resizing is safe while other threads are submitting work.
+ */
+class ThreadPool {
+public:
+    static ThreadPool& instance();
+
+    // Total threads used by parallel_for, including the caller (<= 0: one per core).
+    // 1 runs everything inline. Must not be called from a pool task; blocks
+    // until every task queued on the old workers has run.
+    void set_threads(int threads);
+    int get_threads() const { return static_cast<int>(current()->workers.size()) + 1; }
+
+    // Pin the workers to cores 1..n-1, so pool work never competes with a UI
+    // thread on core 0; the calling thread's affinity is left alone. Unpinning
+    // gives the workers the caller's affinity. Returns false where affinity
+    // is unsupported.
+    bool set_pinning(bool pinned);
+    bool is_pinned() const { return pinned_.load(std::memory_order_relaxed); }
+
+    // Run body(chunk_begin, chunk_end) over [begin, end) in chunks of `grain`
+    void parallel_for(int begin, int end, int grain, const std::function<void(int, int)>& body,
+                      TaskPriority priority = TaskPriority::High);
+
+    // Row bands of at least `min_pixels` pixels each: body(y0, y1)
+    void parallel_rows(int width, int height, const std::function<void(int, int)>& body,
+                       int min_pixels = 16384, TaskPriority priority = TaskPriority::High);
+
+    // Square tiles: body(x0, y0, x1, y1)
+    void parallel_tiles(int width, int height, int tile,
+                        const std::function<void(int, int, int, int)>& body,
+                        TaskPriority priority = TaskPriority::High);
+
+    // Fire-and-forget task (runs inline when there are no workers)
+    void enqueue(std::function<void()> task, TaskPriority priority = TaskPriority::Normal);
+
+    template <typename F>
+    auto submit(F&& fn, TaskPriority priority = TaskPriority::Normal) -> std::future<decltype(fn())> {
+        using R = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> future = task->get_future();
+        enqueue([task]() { (*task)(); }, priority);
+        return future;
+    }
+
+    // Run one pending task on the calling thread, if any (for waiting callers)
+    bool run_pending_task();
+
+    // True on a pool worker thread
+    static bool is_worker_thread() { return worker_index_ >= 0; }
+
+    ThreadPoolStats get_stats() const;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    ThreadPool();  // Never destroyed, see instance()
+
+    static const int kPriorityCount = 3;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> queues[kPriorityCount];
+        std::thread thread;
+    };
+
+    // One generation of workers; replaced as a whole by set_threads()
+    struct Crew {
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic<int> pending{0};
+        bool stopping = false;   // Guarded by wake_mutex; no outside pushes once set
+    };
+
+    std::shared_ptr<Crew> crew_;
+    mutable std::mutex crew_mutex_;    // Guards the crew_ pointer only
+    std::mutex resize_mutex_;          // Serializes set_threads / set_pinning
+    std::atomic<unsigned> next_queue_;
+    std::atomic<bool> pinned_;
+
+    std::atomic<uint64_t> executed_;
+    std::atomic<uint64_t> stolen_;
+
+    static thread_local int worker_index_;
+    static thread_local Crew* worker_crew_;
+
+    std::shared_ptr<Crew> current() const;
+    std::shared_ptr<Crew> start(int workers);
+    void stop(Crew& crew);
+    void worker_main(Crew* crew, int index);
+    bool try_run(Crew& crew, int self);
+    bool push(Crew& crew, std::function<void()>& task, TaskPriority priority);
+    bool apply_affinity(Crew& crew);
+};
+
+} // namespace nativeui
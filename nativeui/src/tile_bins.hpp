@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "scratch_arena.hpp"
+
+namespace nativeui {
+
+/**
+ * PixelRect - Half-open pixel rectangle [x0, x1) x [y0, y1)
+ */
+struct PixelRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    // Clamped to int range, so callers can pass far off-surface geometry
+    static PixelRect from_bounds(int64_t x0, int64_t y0, int64_t x1, int64_t y1) {
+        auto c = [](int64_t v) {
+            return static_cast<int>(std::clamp<int64_t>(v, std::numeric_limits<int>::min(),
+                                                        std::numeric_limits<int>::max()));
+        };
+        return PixelRect{c(x0), c(y0), c(x1), c(y1)};
+    }
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    bool contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+    bool contains(const PixelRect& r) const { return r.x0 >= x0 && r.x1 <= x1 && r.y0 >= y0 && r.y1 <= y1; }
+
+    PixelRect intersect(const PixelRect& r) const {
+        return PixelRect{std::max(x0, r.x0), std::max(y0, r.y0), std::min(x1, r.x1), std::min(y1, r.y1)};
+    }
+};
+
+/**
+ * TileBins - Item indices grouped by screen tile, submission order kept per tile
+ *
+ * Built by a counting sort into scratch memory: every item is listed in each
+ * tile its bounds touch, so tiles can be rasterized independently and in
+ * parallel while every pixel still sees its items in order.
+ */
+struct TileBins {
+    PixelRect area;     // Region covered by the tile grid
+    int tile = 64;
+    int cols = 0;
+    int rows = 0;
+    uint32_t* offsets = nullptr;  // Tile t owns items[offsets[t] .. offsets[t + 1])
+    uint32_t* items = nullptr;
+
+    int count() const { return cols * rows; }
+
+    PixelRect tile_rect(int t) const {
+        int x0 = area.x0 + (t % cols) * tile;
+        int y0 = area.y0 + (t / cols) * tile;
+        return PixelRect{x0, y0, std::min(area.x1, x0 + tile), std::min(area.y1, y0 + tile)};
+    }
+
+    // Bin `count` items over `area`; bounds outside it (or empty) are culled
+    static TileBins build(ScratchScope& scratch, const PixelRect& area, int tile,
+                          const PixelRect* bounds, size_t count) {
+        TileBins bins;
+        bins.area = area;
+        bins.tile = tile;
+        bins.cols = (area.width() + tile - 1) / tile;
+        bins.rows = (area.height() + tile - 1) / tile;
+        size_t tiles = static_cast<size_t>(bins.cols) * bins.rows;
+        if (count > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("TileBins: too many items");
+        }
+
+        bins.offsets = scratch.alloc<uint32_t>(tiles + 1);
+        std::fill(bins.offsets, bins.offsets + tiles + 1, 0u);
+
+        // Visit every tile touched by item i
+        auto for_each_tile = [&](size_t i, auto&& fn) {
+            PixelRect b = bounds[i].intersect(area);
+            if (b.empty()) return;
+            for (int ty = (b.y0 - area.y0) / tile; ty <= (b.y1 - 1 - area.y0) / tile; ++ty) {
+                for (int tx = (b.x0 - area.x0) / tile; tx <= (b.x1 - 1 - area.x0) / tile; ++tx) {
+                    fn(static_cast<size_t>(ty) * bins.cols + tx);
+                }
+            }
+        };
+
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            for_each_tile(i, [&](size_t t) { ++bins.offsets[t + 1]; ++total; });
+        }
+        if (total > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("TileBins: too many tile entries");
+        }
+        for (size_t t = 0; t < tiles; ++t) bins.offsets[t + 1] += bins.offsets[t];
+
+        bins.items = scratch.alloc<uint32_t>(std::max<size_t>(total, 1));
+        uint32_t* cursor = scratch.alloc<uint32_t>(std::max<size_t>(tiles, 1));
+        std::copy(bins.offsets, bins.offsets + tiles, cursor);
+        for (size_t i = 0; i < count; ++i) {
+            for_each_tile(i, [&](size_t t) { bins.items[cursor[t]++] = static_cast<uint32_t>(i); });
+        }
+        return bins;
+    }
+};
+
+} // namespace nativeui
@@ -1,5 +1,8 @@
 #include "window.hpp"
+#include "event_record.hpp"
 #include "font.hpp"
+#include "profiler.hpp"
+#include "scratch_arena.hpp"
 #include <stdexcept>
 
 namespace nativeui {
@@ -10,16 +13,10 @@ static int sdl_init_count = 0;
 void init_sdl()
 {
     if (sdl_init_count == 0) {
+        // Fonts initialize on first use (Font::init), off the path to the first frame
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) < 0) {
             throw std::runtime_error(std::string("SDL initialization failed: ") + SDL_GetError());
         }
-        // Initialize Fonts
-        try {
-            Font::init();
-        } catch (const std::exception& e) {
-            SDL_Quit();
-            throw;
-        }
     }
     sdl_init_count++;
 }
@@ -44,12 +41,14 @@ Window::Window(const std::string& title, int width, int height, bool vsync)
     , window_(nullptr)
     , renderer_(nullptr)
     , texture_(nullptr)
+    , event_thread_(std::this_thread::get_id())
     , last_frame_time_(0)
     , delta_time_(0.0f)
     , fps_(0.0f)
 
     , target_fps_(0)
     , unfocused_fps_(0)
+    , frame_id_(0)
 {
     init_sdl();
     
@@ -110,9 +109,24 @@ void Window::set_title(const std::string& title)
 
 bool Window::poll_event(Event& event)
 {
+    if (!injected_events_.empty()) {
+        event = injected_events_.front();
+        injected_events_.pop_front();
+        accept_event(event);
+        return true;
+    }
+    
+    if (replay_ && replay_->next(frame_id_, SDL_GetTicks(), event)) {
+        accept_event(event);
+        return true;
+    }
+    
     SDL_Event sdl_event;
-    if (SDL_PollEvent(&sdl_event)) {
+    while (SDL_PollEvent(&sdl_event)) {
         event = translate_event(sdl_event);
+        // Live input would perturb the replay
+        if (replay_ && is_input_event(event.type)) continue;
+        accept_event(event);
         return true;
     }
     return false;
@@ -120,9 +134,16 @@ bool Window::poll_event(Event& event)
 
 void Window::wait_event(Event& event)
 {
+    if (poll_event(event)) return;
+    
     SDL_Event sdl_event;
     if (SDL_WaitEvent(&sdl_event)) {
         event = translate_event(sdl_event);
+        if (replay_ && is_input_event(event.type)) {
+            event = Event();
+            return;
+        }
+        accept_event(event);
     }
 }
 
@@ -188,35 +209,98 @@ Event Window::translate_event(const SDL_Event& sdl_event)
             break;
     }
     
+    event.timestamp = sdl_event.common.timestamp;
+    
     return event;
 }
 
+void Window::push_event(const Event& event)
+{
+    injected_events_.push_back(event);
+}
+
+void Window::accept_event(Event& event)
+{
+    if (event.timestamp == 0) {
+        event.timestamp = SDL_GetTicks();
+    }
+    event.frame_id = frame_id_;
+    
+    if (event.type == EventType::Quit) {
+        is_open_ = false;
+    }
+    if (is_input_event(event.type)) {
+        latency_.on_input(event.timestamp);
+    }
+    if (recorder_) {
+        recorder_->record(event, frame_id_, event.timestamp);
+    }
+}
+
+void Window::start_recording(std::shared_ptr<EventRecorder> recorder)
+{
+    recorder_ = std::move(recorder);
+    if (recorder_) {
+        recorder_->begin(frame_id_, SDL_GetTicks());
+    }
+}
+
+void Window::start_replay(std::shared_ptr<EventReplay> replay)
+{
+    stop_replay();
+    replay_ = std::move(replay);
+    if (!replay_) return;
+    
+    replay_->begin(frame_id_, SDL_GetTicks());
+    // Replay reuses the recorded dt so animation matches the capture
+    if (replay_->get_recorded_dt() > 0.0f) {
+        saved_timestep_ = fixed_timestep_;
+        fixed_timestep_ = replay_->get_recorded_dt();
+        replay_owns_timestep_ = true;
+    }
+}
+
+void Window::stop_replay()
+{
+    if (replay_owns_timestep_) {
+        fixed_timestep_ = saved_timestep_;
+        replay_owns_timestep_ = false;
+    }
+    replay_.reset();
+}
+
 void Window::present(const Surface& surface)
 {
     // Update texture with surface data
     void* pixels;
     int pitch;
     
-    if (SDL_LockTexture(texture_, nullptr, &pixels, &pitch) == 0) {
-        const uint8_t* src = surface.get_data();
-        uint8_t* dst = static_cast<uint8_t*>(pixels);
-        
-        int min_width = std::min(width_, surface.get_width());
-        int min_height = std::min(height_, surface.get_height());
-        size_t src_pitch = surface.get_pitch();
-        
-        for (int y = 0; y < min_height; ++y) {
-            std::memcpy(dst + y * pitch, src + y * src_pitch, min_width * 4);
+    {
+        ProfileScope upload_scope("Window::upload");
+        if (SDL_LockTexture(texture_, nullptr, &pixels, &pitch) == 0) {
+            const uint8_t* src = surface.get_data();
+            uint8_t* dst = static_cast<uint8_t*>(pixels);
+            
+            int min_width = std::min(width_, surface.get_width());
+            int min_height = std::min(height_, surface.get_height());
+            size_t src_pitch = surface.get_pitch();
+            
+            for (int y = 0; y < min_height; ++y) {
+                std::memcpy(dst + y * pitch, src + y * src_pitch, min_width * 4);
+            }
+            
+            SDL_UnlockTexture(texture_);
         }
-        
-        SDL_UnlockTexture(texture_);
     }
     
-    SDL_RenderClear(renderer_);
-    SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
-    SDL_RenderPresent(renderer_);
+    {
+        ProfileScope present_scope("Window::present");
+        SDL_RenderClear(renderer_);
+        SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
+        SDL_RenderPresent(renderer_);
+    }
     
-    update_timing();
+    finish_frame();
 }
 
 void Window::draw(std::shared_ptr<Surface> surface) {
@@ -228,8 +312,11 @@ void Window::present() {
         present(*pending_surface_);
         pending_surface_ = nullptr;
     } else {
-        SDL_RenderPresent(renderer_);
-        update_timing();
+        {
+            ProfileScope present_scope("Window::present");
+            SDL_RenderPresent(renderer_);
+        }
+        finish_frame();
     }
 }
 
@@ -241,11 +328,45 @@ void Window::clear(const Color& color)
 
 
 
+void Window::finish_frame()
+{
+    // Stamp before the frame limiter sleeps: that delay is not display latency
+    latency_.on_present(frame_id_, SDL_GetTicks());
+    frame_id_++;
+    
+    update_timing();
+    if (recorder_) {
+        recorder_->on_frame(delta_time_);
+    }
+    if (replay_ && replay_->is_finished()) {
+        stop_replay();
+    }
+    Profiler::instance().end_frame();
+    ScratchArena::next_frame();
+}
+
 void Window::update_timing()
 {
     uint64_t current_time = SDL_GetPerformanceCounter();
     uint64_t frequency = SDL_GetPerformanceFrequency();
     
+    if (fixed_timestep_ > 0.0f) {
+        // Deterministic runs (benchmarks, replay): report the fixed step. Only
+        // a realtime replay sleeps, so each step takes its share of wall time.
+        if (replay_owns_timestep_ && replay_->get_mode() == ReplayMode::Realtime) {
+            double step = fixed_timestep_ / replay_->get_speed();
+            double spent = static_cast<double>(current_time - last_frame_time_) / frequency;
+            if (spent < step) {
+                SDL_Delay(static_cast<Uint32>((step - spent) * 1000.0));
+                current_time = SDL_GetPerformanceCounter();
+            }
+        }
+        delta_time_ = fixed_timestep_;
+        fps_ = 1.0f / fixed_timestep_;
+        last_frame_time_ = current_time;
+        return;
+    }
+    
     // Check window state for FPS throttling
     int effective_target_fps = target_fps_;
     
@@ -308,6 +429,12 @@ void Window::set_cursor_position(int x, int y)
     SDL_WarpMouseInWindow(window_, x, y);
 }
 
+void Window::sample_mouse(int& x, int& y)
+{
+    if (std::this_thread::get_id() == event_thread_) SDL_PumpEvents();
+    SDL_GetMouseState(&x, &y);
+}
+
 void Window::set_fullscreen(bool fullscreen)
 {
     if (fullscreen != is_fullscreen_) {
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <string>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <SDL2/SDL.h>
 #include "surface.hpp"
+#include "latency.hpp"
 
 namespace nativeui {
 
+class EventRecorder;
+class EventReplay;
+
 /**
  * Event types
  */
@@ -45,6 +51,11 @@ struct Event {
     int mouse_button = 0;
     int wheel_x = 0;
     int wheel_y = 0;
+    
+    // SDL_Event timestamp (ms since SDL init) and the ID of the first
+    // frame presented after the event was received
+    uint32_t timestamp = 0;
+    uint64_t frame_id = 0;
 };
 
 /**
@@ -70,6 +81,19 @@ public:
     bool poll_event(Event& event);
     void wait_event(Event& event);
     
+    // Queue an event ahead of SDL's (scripted input, replay)
+    void push_event(const Event& event);
+    
+    // Record every delivered event (see event_record.hpp)
+    void start_recording(std::shared_ptr<EventRecorder> recorder);
+    void stop_recording() { recorder_.reset(); }
+    bool is_recording() const { return recorder_ != nullptr; }
+    
+    // Deliver a recording in place of live input until it runs out
+    void start_replay(std::shared_ptr<EventReplay> replay);
+    void stop_replay();
+    bool is_replaying() const { return replay_ != nullptr; }
+    
     // Rendering
     void draw(std::shared_ptr<Surface> surface);
     void present(); // New parameterless present
@@ -82,12 +106,27 @@ public:
     void set_target_fps(int fps);
     void set_unfocused_fps(int fps);
     
+    // Fixed timestep: delta_time reports `dt` and frames are not throttled (0 = off)
+    void set_fixed_timestep(float dt) { fixed_timestep_ = dt > 0.0f ? dt : 0.0f; }
+    float get_fixed_timestep() const { return fixed_timestep_; }
+    
+    // Frame ID of the next present (number of frames presented so far)
+    uint64_t get_frame_id() const { return frame_id_; }
+    
+    // Input-to-present latency
+    LatencyTracker& get_latency() { return latency_; }
+    
     // Window state
     bool is_focused() const;
     bool is_minimized() const;
     void set_cursor_visible(bool visible);
     void set_cursor_position(int x, int y);
     
+    // Current mouse position (late latch). Pending OS events are pumped first
+    // only on the thread that created the window, as SDL requires; from any
+    // other thread (a composite without the GIL) it is the last pumped state.
+    void sample_mouse(int& x, int& y);
+    
     // Fullscreen
     void set_fullscreen(bool fullscreen);
     bool is_fullscreen() const { return is_fullscreen_; }
@@ -107,6 +146,7 @@ private:
     SDL_Renderer* renderer_;
     SDL_Texture* texture_;
     std::shared_ptr<Surface> pending_surface_;
+    std::thread::id event_thread_;  // Created the window; the only one that may pump events
     
     // Timing
     uint64_t last_frame_time_;
@@ -114,11 +154,31 @@ private:
     float fps_;
     int target_fps_;
     int unfocused_fps_;
+    float fixed_timestep_ = 0.0f;
+    
+    // Latency
+    uint64_t frame_id_;
+    LatencyTracker latency_;
+    
+    std::deque<Event> injected_events_;
+    
+    // Recording / replay
+    std::shared_ptr<EventRecorder> recorder_;
+    std::shared_ptr<EventReplay> replay_;
+    bool replay_owns_timestep_ = false;
+    float saved_timestep_ = 0.0f;
     
     void update_timing();
+    void finish_frame();
+    void accept_event(Event& event);
     Event translate_event(const SDL_Event& sdl_event);
 };
 
+// Whether an event type counts as user input for latency tracking
+inline bool is_input_event(EventType type) {
+    return type != EventType::None && type != EventType::Quit;
+}
+
 // SDL initialization/cleanup (called automatically)
 void init_sdl();
 void quit_sdl();